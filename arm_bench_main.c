@@ -0,0 +1,507 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "p256-cortex-m4.h"
+
+// Measures the internal primitives that dominate the running time, and the API functions, together with the peak
+// stack usage of each of them. The result is printed as CSV with the columns
+// function,type,cycles,stack_bytes
+// where type is "primitive" or "api". Every function is called NUM_INPUTS times, on different inputs, and the
+// average number of cycles per call is reported. The batch functions process NUM_INPUTS items in one call.
+// The cycles and stack usage of calling an empty function in the same way are subtracted, so the overhead of the
+// benchmark itself is not included. A stack_bytes value of -1 means that more than STACK_PAINT_BYTES were used.
+//
+// On a Cortex-M3/M4/M7/M33/M55 device, the cycles are counted using the DWT cycle counter. Retarget printf
+// (e.g. to a UART, RTT or semihosting) or inspect the bench_results array in a debugger when main returns.
+//
+// When compiled for ARM Linux (e.g. arm-linux-gnueabihf-gcc), there is no cycle counter, so the cycles column is
+// omitted. The number of executed instructions is instead measured by running the program under qemu-arm with the
+// instruction counting plugin, which is automated by bench.js. In that mode, "arm-bench <function> <calls>" only
+// calls the given function the given number of times, where the function "none" measures the overhead.
+//
+// The library must be compiled with include_p256_bench_internals enabled, e.g.
+// arm-linux-gnueabihf-gcc -O2 -static -Dinclude_p256_bench_internals=1 -o arm-bench arm_bench_main.c p256-cortex-m4.c p256-cortex-m4-asm-gcc.S
+
+#if !include_p256_bench_internals
+#error "arm_bench_main.c requires include_p256_bench_internals"
+#endif
+
+#if !include_p256_keygen || !include_p256_sign
+#error "arm_bench_main.c requires include_p256_keygen and include_p256_sign to create the input"
+#endif
+
+// Internal functions, see p256-cortex-m4.c
+void P256_mul_mod_p(uint32_t res[8], const uint32_t a[8], const uint32_t b[8]);
+void P256_sqr_mod_p(uint32_t res[8], const uint32_t a[8]);
+void P256_mod_p_inv(uint32_t res[8], const uint32_t a[8]);
+void P256_mod_p_inv_safegcd(uint32_t out[8], const uint32_t in[8]);
+void P256_mod_p_inv_safegcd_vartime(uint32_t out[8], const uint32_t in[8]);
+void P256_double_j(uint32_t jacobian_point_out[3][8], const uint32_t jacobian_point_in[3][8]);
+void P256_add_sub_j(uint32_t jacobian_point1[3][8], const uint32_t (*point2)[8], bool is_sub, bool p2_is_affine);
+void P256_mul_mod_n(uint32_t res[8], const uint32_t a[8], const uint32_t b[8]);
+void P256_mod_n_inv_vartime(uint32_t res[8], const uint32_t a[8]);
+void P256_mod_n_inv(uint32_t out[8], const uint32_t in[8]);
+
+#define NUM_INPUTS 8
+
+#if defined(__linux__)
+#define has_cycle_counter 0
+#ifndef STACK_PAINT_BYTES
+#define STACK_PAINT_BYTES 65536
+#endif
+#else
+#define has_cycle_counter 1
+#ifndef STACK_PAINT_BYTES
+#define STACK_PAINT_BYTES 8192
+#endif
+#define DEMCR (*(volatile uint32_t*)0xe000edfc)
+#define DWT_CTRL (*(volatile uint32_t*)0xe0001000)
+#define DWT_CYCCNT (*(volatile uint32_t*)0xe0001004)
+#define DWT_LAR (*(volatile uint32_t*)0xe0001fb0)
+#endif
+
+#define STACK_PAINT_WORDS (STACK_PAINT_BYTES / 4)
+#define STACK_PAINT_PATTERN 0x5ac3a53cU
+
+static uint32_t privkeys[NUM_INPUTS][8];
+static uint32_t pubkeys_x[NUM_INPUTS][8], pubkeys_y[NUM_INPUTS][8];
+static uint8_t pubkeys_compressed[NUM_INPUTS][33];
+static uint8_t hashes[NUM_INPUTS][32];
+static uint32_t nonces[NUM_INPUTS][8];
+static uint32_t signatures[NUM_INPUTS][16];
+static struct SignPrecomp sign_precomps[NUM_INPUTS];
+#if include_p256_verify_batch
+static struct VerifyBatchItem items[NUM_INPUTS];
+static uint32_t batch_random[NUM_INPUTS][4];
+#endif
+#if include_p256_verify_precomp
+static struct PublicKeyPrecomp pk_precomps[NUM_INPUTS];
+#endif
+#if include_p256_ecdh_precomp
+// Precomputed table of a static peer public key (the first one)
+static struct FixedPointPrecomp ecdh_precomp;
+#endif
+#if include_p256_verify_stream
+// A firmware image of 64 or 512 kB is simulated by streaming the same 4 kB chunk repeatedly, which is hashed in place
+static const uint8_t image_chunk[4096] __attribute__((aligned(4))) = {1};
+static const uint8_t image_hashes[2][32] = {
+    {0x72, 0x7a, 0x45, 0xa5, 0x27, 0xe5, 0x3e, 0x0d, 0x58, 0xc5, 0xa9, 0xc3, 0xb0, 0xeb, 0x15, 0xae, 0x2e, 0x0f, 0xb6, 0xfc, 0x44, 0xe8, 0xcf, 0xc3, 0x12, 0x9d, 0xfb, 0xc0, 0x96, 0x02, 0x25, 0x18},
+    {0x44, 0x6a, 0xcd, 0x6a, 0xc8, 0xe6, 0x72, 0x5b, 0xe5, 0xd0, 0x3b, 0x0e, 0xdc, 0x64, 0x10, 0x72, 0x03, 0x38, 0x8b, 0x0f, 0xd3, 0x67, 0x42, 0x29, 0xda, 0x08, 0xc9, 0xbc, 0x53, 0x60, 0x77, 0xdf}
+};
+static uint32_t image_signatures[2][16];
+#endif
+static bool results[NUM_INPUTS];
+static uint32_t field_elements[NUM_INPUTS][8];
+static uint32_t scalars[NUM_INPUTS][8];
+static uint32_t jacobian_points[NUM_INPUTS][3][8];
+static uint32_t out[3][8], out_x[NUM_INPUTS][8], out_y[NUM_INPUTS][8];
+static uint8_t out_bytes[65];
+static bool ok = true;
+
+// Not a secure random generator, only used to create deterministic benchmark input
+static uint32_t xorshift_state = 0x12345678;
+static void fill_pseudo_random(uint32_t* output, int num_words) {
+    for (int i = 0; i < num_words; i++) {
+        xorshift_state ^= xorshift_state << 13;
+        xorshift_state ^= xorshift_state >> 17;
+        xorshift_state ^= xorshift_state << 5;
+        output[i] = xorshift_state;
+    }
+}
+
+static void create_input(void) {
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        do {
+            fill_pseudo_random(privkeys[i], 8);
+        } while (!p256_keygen(pubkeys_x[i], pubkeys_y[i], privkeys[i]));
+        fill_pseudo_random((uint32_t*)hashes[i], 8);
+        do {
+            fill_pseudo_random(nonces[i], 8);
+        } while (!p256_sign(signatures[i], signatures[i] + 8, hashes[i], 32, privkeys[i], nonces[i]));
+        ok &= p256_sign_step1(&sign_precomps[i], nonces[i]);
+        p256_point_to_octet_string_compressed(pubkeys_compressed[i], pubkeys_x[i], pubkeys_y[i]);
+#if include_p256_verify_batch
+        uint32_t rx[8], ry[8];
+        ok &= p256_scalarmult_base(rx, ry, nonces[i]);
+        items[i] = (struct VerifyBatchItem){pubkeys_x[i], pubkeys_y[i], hashes[i], 32, signatures[i], signatures[i] + 8, ry[0] & 1};
+#endif
+#if include_p256_verify_precomp
+        ok &= p256_verify_precompute_public_key(&pk_precomps[i], pubkeys_x[i], pubkeys_y[i]);
+#endif
+#if include_p256_ecdh_precomp
+        if (i == 0) {
+            ok &= p256_fixed_point_precompute(&ecdh_precomp, pubkeys_x[0], pubkeys_y[0]);
+        }
+#endif
+
+        // Values below 2^255 are valid field elements and scalars, the primitives run in constant time (except
+        // P256_mod_n_inv_vartime), so the values themselves don't need to be meaningful
+        fill_pseudo_random(field_elements[i], 8);
+        field_elements[i][7] &= 0x7fffffff;
+        fill_pseudo_random(scalars[i], 8);
+        scalars[i][7] &= 0x7fffffff;
+        fill_pseudo_random(jacobian_points[i][0], 24);
+        for (int j = 0; j < 3; j++) {
+            jacobian_points[i][j][7] &= 0x7fffffff;
+        }
+    }
+#if include_p256_verify_batch
+    fill_pseudo_random(batch_random[0], NUM_INPUTS * 4);
+#endif
+#if include_p256_verify_stream
+    for (int i = 0; i < 2; i++) {
+        ok &= p256_sign(image_signatures[i], image_signatures[i] + 8, image_hashes[i], 32, privkeys[0], nonces[0]);
+    }
+#endif
+}
+
+static void bench_none(int i) {
+    (void)i;
+}
+
+static void bench_mul_mod_p(int i) {
+    P256_mul_mod_p(out[0], field_elements[i], field_elements[(i + 1) % NUM_INPUTS]);
+}
+
+static void bench_sqr_mod_p(int i) {
+    P256_sqr_mod_p(out[0], field_elements[i]);
+}
+
+static void bench_mod_p_inv(int i) {
+    P256_mod_p_inv(out[0], field_elements[i]);
+}
+
+#if use_safegcd_mod_p_inv
+static void bench_mod_p_inv_safegcd(int i) {
+    P256_mod_p_inv_safegcd(out[0], field_elements[i]);
+}
+
+static void bench_mod_p_inv_safegcd_vartime(int i) {
+    P256_mod_p_inv_safegcd_vartime(out[0], field_elements[i]);
+}
+#endif
+
+static void bench_double_j(int i) {
+    P256_double_j(out, (const uint32_t (*)[8])jacobian_points[i]);
+}
+
+static void bench_add_sub_j(int i) {
+    memcpy(out, jacobian_points[i], sizeof(out));
+    P256_add_sub_j(out, (const uint32_t (*)[8])jacobian_points[(i + 1) % NUM_INPUTS], false, false);
+}
+
+static void bench_add_sub_j_affine(int i) {
+    memcpy(out, jacobian_points[i], sizeof(out));
+    P256_add_sub_j(out, (const uint32_t (*)[8])jacobian_points[(i + 1) % NUM_INPUTS], false, true);
+}
+
+#if include_p256_verify || include_p256_sign
+static void bench_mul_mod_n(int i) {
+    P256_mul_mod_n(out[0], scalars[i], scalars[(i + 1) % NUM_INPUTS]);
+}
+
+static void bench_mod_n_inv_vartime(int i) {
+    P256_mod_n_inv_vartime(out[0], scalars[i]);
+}
+#endif
+
+static void bench_mod_n_inv(int i) {
+    P256_mod_n_inv(out[0], scalars[i]);
+}
+
+static void bench_keygen(int i) {
+    ok &= p256_keygen(out_x[i], out_y[i], privkeys[i]);
+}
+
+static void bench_sign(int i) {
+    uint32_t sig[16];
+    ok &= p256_sign(sig, sig + 8, hashes[i], 32, privkeys[i], nonces[i]);
+}
+
+static void bench_sign_step1(int i) {
+    struct SignPrecomp precomp;
+    ok &= p256_sign_step1(&precomp, nonces[i]);
+}
+
+static void bench_sign_step2(int i) {
+    uint32_t sig[16];
+    struct SignPrecomp precomp = sign_precomps[i];
+    ok &= p256_sign_step2(sig, sig + 8, hashes[i], 32, privkeys[i], &precomp);
+}
+
+#if include_p256_verify
+static void bench_verify(int i) {
+    ok &= p256_verify(pubkeys_x[i], pubkeys_y[i], hashes[i], 32, signatures[i], signatures[i] + 8);
+}
+#endif
+
+#if include_p256_verify_precomp
+static void bench_verify_precompute_public_key(int i) {
+    static struct PublicKeyPrecomp precomp;
+    ok &= p256_verify_precompute_public_key(&precomp, pubkeys_x[i], pubkeys_y[i]);
+}
+
+static void bench_verify_precomp(int i) {
+    ok &= p256_verify_precomp(&pk_precomps[i], hashes[i], 32, signatures[i], signatures[i] + 8);
+}
+#endif
+
+#if include_p256_verify_stream
+static void verify_image(uint32_t num_chunks, const uint32_t signature[16]) {
+    struct P256VerifyStream stream;
+    p256_verify_init(&stream);
+    for (uint32_t i = 0; i < num_chunks; i++) {
+        p256_verify_update(&stream, image_chunk, sizeof(image_chunk));
+    }
+    ok &= p256_verify_final(&stream, pubkeys_x[0], pubkeys_y[0], signature, signature + 8);
+}
+
+static void bench_verify_stream_64k(int i) {
+    (void)i;
+    verify_image(16, image_signatures[0]);
+}
+
+static void bench_verify_stream_512k(int i) {
+    (void)i;
+    verify_image(128, image_signatures[1]);
+}
+#endif
+
+#if include_p256_verify_batch
+static void bench_verify_batch(int i) {
+    (void)i;
+    ok &= p256_verify_batch(results, items, NUM_INPUTS, batch_random);
+}
+#endif
+
+#if include_p256_keygen_batch
+static void bench_keygen_batch(int i) {
+    (void)i;
+    ok &= p256_keygen_batch(results, out_x, out_y, privkeys, NUM_INPUTS);
+}
+#endif
+
+#if include_p256_sign_batch
+static void bench_sign_step1_batch(int i) {
+    (void)i;
+    ok &= p256_sign_step1_batch(results, sign_precomps, nonces, NUM_INPUTS, (const uint32_t*)batch_random);
+}
+#endif
+
+#if include_p256_ecdh
+static void bench_ecdh(int i) {
+    uint8_t shared_secret[32];
+    ok &= p256_ecdh_calc_shared_secret(shared_secret, privkeys[i], pubkeys_x[(i + 1) % NUM_INPUTS], pubkeys_y[(i + 1) % NUM_INPUTS]);
+}
+
+static void bench_ecdh_compressed(int i) {
+    uint8_t shared_secret[32];
+    ok &= p256_ecdh_calc_shared_secret_compressed(shared_secret, privkeys[i], pubkeys_compressed[(i + 1) % NUM_INPUTS]);
+}
+#endif
+
+#if include_p256_ecdh_precomp
+static void bench_fixed_point_precompute(int i) {
+    static struct FixedPointPrecomp precomp;
+    ok &= p256_fixed_point_precompute(&precomp, pubkeys_x[i], pubkeys_y[i]);
+}
+
+static void bench_ecdh_with_precomp(int i) {
+    uint8_t shared_secret[32];
+    p256_ecdh_with_precomp(shared_secret, privkeys[i], &ecdh_precomp);
+}
+#endif
+
+#if include_p256_raw_scalarmult_base
+static void bench_scalarmult_base(int i) {
+    ok &= p256_scalarmult_base(out_x[i], out_y[i], privkeys[i]);
+}
+#endif
+
+#if include_p256_raw_scalarmult_generic
+static void bench_scalarmult_generic(int i) {
+    ok &= p256_scalarmult_generic(out_x[i], out_y[i], privkeys[i], pubkeys_x[(i + 1) % NUM_INPUTS], pubkeys_y[(i + 1) % NUM_INPUTS]);
+}
+#endif
+
+#if include_p256_decode_point || include_p256_decompress_point
+static void bench_decompress(int i) {
+    ok &= p256_octet_string_to_point(out_x[i], out_y[i], pubkeys_compressed[i], 33);
+}
+#endif
+
+#if include_p256_to_octet_string_compressed
+static void bench_to_octet_string_compressed(int i) {
+    p256_point_to_octet_string_compressed(out_bytes, pubkeys_x[i], pubkeys_y[i]);
+}
+#endif
+
+struct Benchmark {
+    const char* name;
+    const char* type;
+    void (*fn)(int i);
+};
+
+static const struct Benchmark benchmarks[] = {
+    {"P256_mul_mod_p", "primitive", bench_mul_mod_p},
+    {"P256_sqr_mod_p", "primitive", bench_sqr_mod_p},
+    {"P256_mod_p_inv", "primitive", bench_mod_p_inv},
+#if use_safegcd_mod_p_inv
+    {"P256_mod_p_inv_safegcd", "primitive", bench_mod_p_inv_safegcd},
+    {"P256_mod_p_inv_safegcd_vartime", "primitive", bench_mod_p_inv_safegcd_vartime},
+#endif
+    {"P256_double_j", "primitive", bench_double_j},
+    {"P256_add_sub_j", "primitive", bench_add_sub_j},
+    {"P256_add_sub_j_affine", "primitive", bench_add_sub_j_affine},
+#if include_p256_verify || include_p256_sign
+    {"P256_mul_mod_n", "primitive", bench_mul_mod_n},
+    {"P256_mod_n_inv_vartime", "primitive", bench_mod_n_inv_vartime},
+#endif
+    {"P256_mod_n_inv", "primitive", bench_mod_n_inv},
+    {"p256_keygen", "api", bench_keygen},
+    {"p256_sign", "api", bench_sign},
+    {"p256_sign_step1", "api", bench_sign_step1},
+    {"p256_sign_step2", "api", bench_sign_step2},
+#if include_p256_verify
+    {"p256_verify", "api", bench_verify},
+#endif
+#if include_p256_verify_precomp
+    {"p256_verify_precompute_public_key", "api", bench_verify_precompute_public_key},
+    {"p256_verify_precomp", "api", bench_verify_precomp},
+#endif
+#if include_p256_verify_stream
+    {"p256_verify_stream_64k", "api", bench_verify_stream_64k},
+    {"p256_verify_stream_512k", "api", bench_verify_stream_512k},
+#endif
+#if include_p256_verify_batch
+    {"p256_verify_batch", "api", bench_verify_batch},
+#endif
+#if include_p256_keygen_batch
+    {"p256_keygen_batch", "api", bench_keygen_batch},
+#endif
+#if include_p256_sign_batch
+    {"p256_sign_step1_batch", "api", bench_sign_step1_batch},
+#endif
+#if include_p256_ecdh
+    {"p256_ecdh_calc_shared_secret", "api", bench_ecdh},
+    {"p256_ecdh_calc_shared_secret_compressed", "api", bench_ecdh_compressed},
+#endif
+#if include_p256_ecdh_precomp
+    {"p256_fixed_point_precompute", "api", bench_fixed_point_precompute},
+    {"p256_ecdh_with_precomp", "api", bench_ecdh_with_precomp},
+#endif
+#if include_p256_raw_scalarmult_base
+    {"p256_scalarmult_base", "api", bench_scalarmult_base},
+#endif
+#if include_p256_raw_scalarmult_generic
+    {"p256_scalarmult_generic", "api", bench_scalarmult_generic},
+#endif
+#if include_p256_decode_point || include_p256_decompress_point
+    {"p256_octet_string_to_point", "api", bench_decompress},
+#endif
+#if include_p256_to_octet_string_compressed
+    {"p256_point_to_octet_string_compressed", "api", bench_to_octet_string_compressed},
+#endif
+};
+
+#define NUM_BENCHMARKS (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+struct BenchResult {
+    uint32_t cycles;
+    int32_t stack_bytes;
+};
+
+volatile struct BenchResult bench_results[NUM_BENCHMARKS];
+
+static const struct Benchmark benchmark_none = {"none", "overhead", bench_none};
+static struct BenchResult overhead;
+
+static uintptr_t stack_paint_top;
+
+// Fills the unused stack below the caller's frame (and this function's small frame) with a pattern
+__attribute__((noinline)) static void paint_stack(void) {
+    volatile uint32_t marker = 0;
+    volatile uint32_t* top = (volatile uint32_t*)((uintptr_t)&marker & ~(uintptr_t)3) - 8;
+    for (int i = 1; i <= STACK_PAINT_WORDS; i++) {
+        top[-i] = STACK_PAINT_PATTERN;
+    }
+    stack_paint_top = (uintptr_t)top;
+}
+
+// Returns the number of bytes between caller_sp and the lowest painted word that has been overwritten
+__attribute__((noinline)) static int32_t measure_stack(uintptr_t caller_sp) {
+    volatile uint32_t* bottom = (volatile uint32_t*)stack_paint_top - STACK_PAINT_WORDS;
+    int i = 0;
+    while (i < STACK_PAINT_WORDS && bottom[i] == STACK_PAINT_PATTERN) {
+        i++;
+    }
+    if (i == 0) {
+        return -1;
+    }
+    return (int32_t)(caller_sp - (uintptr_t)(bottom + i));
+}
+
+__attribute__((noinline)) static void run_benchmark(const struct Benchmark* b, int num_calls, volatile struct BenchResult* result) {
+    volatile uint32_t marker = 0; // approximates the stack pointer when b->fn is called
+    paint_stack();
+#if has_cycle_counter
+    uint32_t start = DWT_CYCCNT;
+#endif
+    for (int i = 0; i < num_calls; i++) {
+        b->fn(i % NUM_INPUTS);
+    }
+#if has_cycle_counter
+    uint32_t cycles = num_calls > 0 ? (DWT_CYCCNT - start) / num_calls : 0;
+    result->cycles = cycles > overhead.cycles ? cycles - overhead.cycles : 0;
+#endif
+    int32_t stack_bytes = measure_stack((uintptr_t)&marker);
+    result->stack_bytes = stack_bytes < 0 ? -1 : stack_bytes > overhead.stack_bytes ? stack_bytes - overhead.stack_bytes : 0;
+}
+
+int main(int argc, char* argv[]) {
+#if has_cycle_counter
+    DEMCR |= 1 << 24; // TRCENA
+    DWT_LAR = 0xc5acce55; // only needed on some CPUs, e.g. Cortex-M7
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= 1; // CYCCNTENA
+#endif
+
+    create_input();
+    run_benchmark(&benchmark_none, NUM_INPUTS, &overhead);
+
+    if (argc >= 3) {
+        // Only run one function, used by bench.js to count instructions under qemu-arm
+        const struct Benchmark* b = strcmp(argv[1], benchmark_none.name) == 0 ? &benchmark_none : NULL;
+        for (size_t i = 0; i < NUM_BENCHMARKS; i++) {
+            if (strcmp(benchmarks[i].name, argv[1]) == 0) {
+                b = &benchmarks[i];
+            }
+        }
+        if (b != NULL) {
+            struct BenchResult result;
+            run_benchmark(b, atoi(argv[2]), &result);
+            printf("%s,%s,%d\n", b->name, b->type, (int)result.stack_bytes);
+            return ok ? 0 : 1;
+        }
+        fprintf(stderr, "unknown function %s\n", argv[1]);
+        return 2;
+    }
+
+#if has_cycle_counter
+    printf("function,type,cycles,stack_bytes\n");
+#else
+    printf("function,type,stack_bytes\n");
+#endif
+    for (size_t i = 0; i < NUM_BENCHMARKS; i++) {
+        run_benchmark(&benchmarks[i], NUM_INPUTS, &bench_results[i]);
+#if has_cycle_counter
+        printf("%s,%s,%u,%d\n", benchmarks[i].name, benchmarks[i].type, (unsigned)bench_results[i].cycles, (int)bench_results[i].stack_bytes);
+#else
+        printf("%s,%s,%d\n", benchmarks[i].name, benchmarks[i].type, (int)bench_results[i].stack_bytes);
+#endif
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "p256-cortex-m4.h"
+
+// Measures the number of cycles of the ARMv6-M field arithmetic in p256-armv6m-asm.S and of the main API functions,
+// when the library is built for e.g. Cortex-M0+ from p256-cortex-m4.c, p256-cortex-m4-portable.c and p256-armv6m-asm.S.
+// Run it in a debugger and inspect the "cycles_*" variables when main returns.
+// Cycles are counted using SysTick (which all Cortex-M0/M0+ CPUs have), so the startup code must install
+// SysTick_Handler in the vector table (standard CMSIS startup files do).
+// Under QEMU, run with -icount shift=0, so that the counts are deterministic and proportional to the number of
+// executed instructions rather than to host time.
+
+#define SYST_CSR (*(volatile uint32_t*)0xE000E010)
+#define SYST_RVR (*(volatile uint32_t*)0xE000E014)
+#define SYST_CVR (*(volatile uint32_t*)0xE000E018)
+#define SCB_ICSR (*(volatile uint32_t*)0xE000ED04)
+#define SCB_ICSR_PENDSTSET (1U << 26)
+
+// Implemented in p256-armv6m-asm.S
+void P256_armv6m_mulmod(uint32_t r[8], const uint32_t a[8], const uint32_t b[8]);
+void P256_armv6m_sqrmod(uint32_t r[8], const uint32_t a[8]);
+void P256_armv6m_addmod(uint32_t r[8], const uint32_t a[8], const uint32_t b[8]);
+void P256_armv6m_submod(uint32_t r[8], const uint32_t a[8], const uint32_t b[8]);
+
+#define FIELD_OP_ITERATIONS 100
+
+volatile uint32_t cycles_mulmod, cycles_sqrmod, cycles_addmod, cycles_submod;
+volatile uint32_t cycles_keygen, cycles_sign, cycles_verify, cycles_ecdh;
+
+static volatile uint32_t systick_wraps;
+
+void SysTick_Handler(void) {
+    systick_wraps++;
+}
+
+static void start_cycle_counter(void) {
+    SYST_RVR = 0xFFFFFF;
+    SYST_CVR = 0;
+    SYST_CSR = 7; // processor clock, interrupt on wrap, enable
+}
+
+static uint32_t read_cycles(void) {
+    uint32_t wraps, value;
+    do {
+        wraps = systick_wraps;
+        value = SYST_CVR;
+        // Retry if the counter wrapped around but the interrupt handler has not run yet
+    } while (wraps != systick_wraps || (SCB_ICSR & SCB_ICSR_PENDSTSET));
+    return (wraps << 24) + (0xFFFFFF - value);
+}
+
+int main() {
+    // Field elements in Montgomery form, must be less than p
+    uint32_t a[8] = {0x29c4bddf, 0xd89cdf62, 0x78843090, 0xacf005cd, 0xf7212ed6, 0xe5a220ab, 0x04874834, 0xdc30061d};
+    uint32_t b[8] = {0x18a9143c, 0x79e730d4, 0x5fedb601, 0x75ba95fc, 0x77622510, 0x79fb732b, 0xa53755c6, 0x18905f76};
+    uint32_t r[8];
+
+    uint32_t privkey[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint32_t pubkey_x[8], pubkey_y[8], k[8] = {8, 7, 6, 5, 4, 3, 2, 1}, sig_r[8], sig_s[8];
+    uint8_t hash[32] = {1, 2, 3}, shared_secret[32];
+
+    start_cycle_counter();
+
+    uint32_t start = read_cycles();
+    for (int i = 0; i < FIELD_OP_ITERATIONS; i++) {
+        P256_armv6m_mulmod(r, a, b);
+    }
+    cycles_mulmod = (read_cycles() - start) / FIELD_OP_ITERATIONS;
+
+    start = read_cycles();
+    for (int i = 0; i < FIELD_OP_ITERATIONS; i++) {
+        P256_armv6m_sqrmod(r, a);
+    }
+    cycles_sqrmod = (read_cycles() - start) / FIELD_OP_ITERATIONS;
+
+    start = read_cycles();
+    for (int i = 0; i < FIELD_OP_ITERATIONS; i++) {
+        P256_armv6m_addmod(r, a, b);
+    }
+    cycles_addmod = (read_cycles() - start) / FIELD_OP_ITERATIONS;
+
+    start = read_cycles();
+    for (int i = 0; i < FIELD_OP_ITERATIONS; i++) {
+        P256_armv6m_submod(r, a, b);
+    }
+    cycles_submod = (read_cycles() - start) / FIELD_OP_ITERATIONS;
+
+    bool ok = true;
+
+    start = read_cycles();
+    ok &= p256_keygen(pubkey_x, pubkey_y, privkey);
+    cycles_keygen = read_cycles() - start;
+
+    start = read_cycles();
+    ok &= p256_sign(sig_r, sig_s, hash, sizeof(hash), privkey, k);
+    cycles_sign = read_cycles() - start;
+
+    start = read_cycles();
+    ok &= p256_verify(pubkey_x, pubkey_y, hash, sizeof(hash), sig_r, sig_s);
+    cycles_verify = read_cycles() - start;
+
+    start = read_cycles();
+    ok &= p256_ecdh_calc_shared_secret(shared_secret, privkey, pubkey_x, pubkey_y);
+    cycles_ecdh = read_cycles() - start;
+
+    assert(ok);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2021 Shortcut Labs AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Measures code size, executed instructions and peak stack usage for every permutation of the settings
+// use_mul_for_sqr, has_fpu, use_fast_p256_basemult and has_d_cache, without any hardware.
+// Execute "node bench.js [--csv] [--calls n] [setting=value ...]", with a nodejs version >= 14.14.
+//
+// For each config:
+// - the code size is the size of p256-cortex-m4.c and p256-cortex-m4-asm-gcc.S compiled for Cortex-M4,
+// - arm_bench_main.c is compiled for ARM Linux together with the library and run under qemu-arm, once per benchmarked
+//   function, with qemu's instruction counting plugin (libinsn.so, found in qemu's build directory under
+//   tests/plugin). The number of instructions per call is (count(n calls) - count(n calls of an empty function)) / n,
+//   which, unlike a cycle count, is exactly reproducible. The peak stack usage is reported by arm_bench_main.c.
+//
+// The result is written to stdout as JSON, or as CSV with one row per config and function with --csv.
+// Settings given as arguments (e.g. "include_p256_verify_batch=0") are applied to every config.
+//
+// "node bench.js --check-configs" instead only compiles the library for Cortex-M4 with -Wall -Wextra -Werror for each
+// of the reduced feature sets in checkedConfigs, which are not covered by the default config.
+//
+// The tools can be overridden using the environment variables CC_M4 (default arm-none-eabi-gcc), SIZE_M4
+// (arm-none-eabi-size), CC_LINUX (arm-linux-gnueabihf-gcc), QEMU (qemu-arm) and QEMU_PLUGIN (libinsn.so).
+
+const childProcess = require('child_process');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const tools = {
+	ccM4: process.env.CC_M4 || 'arm-none-eabi-gcc',
+	sizeM4: process.env.SIZE_M4 || 'arm-none-eabi-size',
+	ccLinux: process.env.CC_LINUX || 'arm-linux-gnueabihf-gcc',
+	qemu: process.env.QEMU || 'qemu-arm',
+	qemuPlugin: process.env.QEMU_PLUGIN || 'libinsn.so',
+};
+
+const permutedSettings = ['use_mul_for_sqr', 'has_fpu', 'use_fast_p256_basemult', 'has_d_cache'];
+
+// Combinations of the include_* and use_* settings that only compile a part of the library
+const checkedConfigs = [
+	{},
+	{has_d_cache: 0},
+	{p256_enable_stats: 1},
+	{use_safegcd_mod_p_inv: 0},
+	{use_fast_p256_basemult: 0, has_d_cache: 1},
+	{include_p256_verify: 0, include_p256_sign: 0, include_p256_resumable: 1},
+	{use_coz_ladder_ecdh: 1, include_p256_resumable: 1, include_p256_raw_scalarmult_generic: 0},
+	{include_p256_keygen: 0, include_p256_sign: 0, include_p256_ecdh: 0, include_p256_raw_scalarmult_generic: 0, include_p256_raw_scalarmult_base: 0},
+	{include_p256_sign_pool: 1, include_p256_sign_batch: 0},
+	{include_p256_der: 0, include_p256_decode_point: 0, include_p256_decompress_point: 0},
+];
+
+const args = process.argv.slice(2);
+const csv = args.includes('--csv');
+const callsIndex = args.indexOf('--calls');
+const numCalls = callsIndex >= 0 ? parseInt(args[callsIndex + 1]) : 8;
+const extraSettings = args.filter(a => /^\w+=\w+$/.test(a));
+
+const srcDir = __dirname;
+const workDir = fs.mkdtempSync(path.join(os.tmpdir(), 'p256-bench-'));
+
+function run(cmd, cmdArgs) {
+	const res = childProcess.spawnSync(cmd, cmdArgs, {encoding: 'utf8', maxBuffer: 1 << 24});
+	if (res.error || res.status !== 0) {
+		throw new Error(cmd + ' ' + cmdArgs.join(' ') + ' failed:\n' + (res.error || res.stderr));
+	}
+	return res;
+}
+
+function defines(config) {
+	return Object.keys(config).map(k => '-D' + k + '=' + config[k]).concat(extraSettings.map(s => '-D' + s));
+}
+
+function codeSize(config) {
+	const fpu = config.has_fpu ? ['-mfloat-abi=hard', '-mfpu=fpv4-sp-d16'] : ['-mfloat-abi=soft'];
+	const objects = [];
+	for (const src of ['p256-cortex-m4.c', 'p256-cortex-m4-asm-gcc.S']) {
+		const obj = path.join(workDir, src + '.o');
+		run(tools.ccM4, ['-O2', '-mcpu=cortex-m4', '-mthumb'].concat(fpu, defines(config), ['-I' + srcDir, '-c', path.join(srcDir, src), '-o', obj]));
+		objects.push(obj);
+	}
+	// Berkeley format, the last line contains the totals: text data bss dec hex filename
+	const total = run(tools.sizeM4, ['-t'].concat(objects)).stdout.trim().split('\n').pop().trim().split(/\s+/);
+	return {text: +total[0], data: +total[1], bss: +total[2]};
+}
+
+function countInstructions(exe, name, calls) {
+	const res = run(tools.qemu, ['-plugin', tools.qemuPlugin, '-d', 'plugin', exe, name, String(calls)]);
+	const m = /insns: (\d+)/.exec(res.stderr + res.stdout);
+	if (!m) {
+		throw new Error('no instruction count in the qemu output for ' + name);
+	}
+	const row = res.stdout.trim().split('\n').pop().split(',');
+	return {instructions: +m[1], stackBytes: +row[2]};
+}
+
+function benchmark(config) {
+	const exe = path.join(workDir, 'arm-bench');
+	// armhf always has a VFP unit, has_fpu only decides whether the library uses it
+	run(tools.ccLinux, ['-O2', '-static', '-march=armv7-a', '-mthumb', '-mfpu=vfpv3-d16', '-mfloat-abi=hard'].concat(defines(config), ['-Dinclude_p256_bench_internals=1', '-I' + srcDir, '-o', exe,
+		path.join(srcDir, 'arm_bench_main.c'), path.join(srcDir, 'p256-cortex-m4.c'), path.join(srcDir, 'p256-cortex-m4-asm-gcc.S')]));
+
+	// Without arguments, the benchmark lists the functions that are included in this config
+	const names = run(tools.qemu, [exe]).stdout.trim().split('\n').slice(1).map(line => line.split(','));
+	const baseline = countInstructions(exe, 'none', numCalls).instructions;
+	return names.map(([name, type]) => {
+		const r = countInstructions(exe, name, numCalls);
+		return {function: name, type: type, instructions: Math.round((r.instructions - baseline) / numCalls), stack_bytes: r.stackBytes};
+	});
+}
+
+function checkConfig(config) {
+	for (const src of ['p256-cortex-m4.c', 'p256-cortex-m4-asm-gcc.S']) {
+		run(tools.ccM4, ['-O2', '-mcpu=cortex-m4', '-mthumb', '-mfloat-abi=soft', '-Wall', '-Wextra', '-Werror'].concat(defines(config),
+			['-I' + srcDir, '-c', path.join(srcDir, src), '-o', path.join(workDir, src + '.o')]));
+	}
+}
+
+if (args.includes('--check-configs')) {
+	for (const config of checkedConfigs) {
+		process.stderr.write('Checking ' + JSON.stringify(config) + '\n');
+		checkConfig(config);
+	}
+	fs.rmSync(workDir, {recursive: true, force: true});
+	process.exit(0);
+}
+
+const results = [];
+for (let i = 0; i < 1 << permutedSettings.length; i++) {
+	const config = {};
+	permutedSettings.forEach((setting, bit) => config[setting] = (i >> bit) & 1);
+	process.stderr.write('Benchmarking ' + JSON.stringify(config) + '\n');
+	results.push({config: config, code_size: codeSize(config), functions: benchmark(config)});
+}
+fs.rmSync(workDir, {recursive: true, force: true});
+
+if (csv) {
+	console.log(permutedSettings.concat(['code_size_bytes', 'function', 'type', 'instructions', 'stack_bytes']).join(','));
+	for (const r of results) {
+		const prefix = permutedSettings.map(s => r.config[s]).concat([r.code_size.text + r.code_size.data]);
+		for (const f of r.functions) {
+			console.log(prefix.concat([f.function, f.type, f.instructions, f.stack_bytes]).join(','));
+		}
+	}
+} else {
+	console.log(JSON.stringify({settings: extraSettings, calls_per_function: numCalls, results: results}, null, 2));
+}
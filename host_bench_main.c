@@ -0,0 +1,236 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "p256-cortex-m4.h"
+#if defined(__x86_64__)
+#include "p256-x86-64-multi.h"
+#endif
+#if defined(__linux__)
+#include "p256-worker-pool.h"
+#endif
+
+// Measures the number of operations per second of the API functions on a host (e.g. x86-64 Linux),
+// using the portable C backend instead of the assembler code. Compile with e.g.
+// gcc -O2 -o p256-bench host_bench_main.c p256-cortex-m4.c p256-cortex-m4-portable.c
+// On x86-64, p256-x86-64-multi.c must also be added, and on AArch64, p256-aarch64-asm.S.
+// On Linux, p256-worker-pool.c must also be added (with -pthread), and the throughput of the worker pool is
+// measured with 1 to 4 threads (shown as "pool x1" to "pool x4").
+// If the (fixed) CPU clock frequency in MHz is given as the first argument, the number of cycles per operation
+// is printed as well.
+
+#define NUM_KEYS 64
+#define MIN_SECONDS 0.5
+
+static uint32_t privkeys[NUM_KEYS][8];
+static uint32_t pubkeys_x[NUM_KEYS][8], pubkeys_y[NUM_KEYS][8];
+static uint8_t pubkeys_compressed[NUM_KEYS][33];
+static uint8_t hashes[NUM_KEYS][32];
+static uint32_t nonces[NUM_KEYS][8];
+static uint32_t signatures[NUM_KEYS][16];
+static struct VerifyBatchItem items[NUM_KEYS];
+static uint32_t batch_random[NUM_KEYS][4];
+static struct PublicKeyPrecomp pk_precomps[NUM_KEYS];
+static struct SignPrecomp sign_precomps[NUM_KEYS];
+static bool results[NUM_KEYS];
+static uint32_t out_x[NUM_KEYS][8], out_y[NUM_KEYS][8];
+static bool ok = true;
+static double cpu_mhz;
+
+// Not a secure random generator, only used to create deterministic benchmark input
+static uint32_t xorshift_state = 0x12345678;
+static void fill_pseudo_random(uint32_t* out, int num_words) {
+    for (int i = 0; i < num_words; i++) {
+        xorshift_state ^= xorshift_state << 13;
+        xorshift_state ^= xorshift_state >> 17;
+        xorshift_state ^= xorshift_state << 5;
+        out[i] = xorshift_state;
+    }
+}
+
+static void create_input(void) {
+    for (int i = 0; i < NUM_KEYS; i++) {
+        uint32_t rx[8], ry[8];
+        do {
+            fill_pseudo_random(privkeys[i], 8);
+        } while (!p256_keygen(pubkeys_x[i], pubkeys_y[i], privkeys[i]));
+        p256_point_to_octet_string_compressed(pubkeys_compressed[i], pubkeys_x[i], pubkeys_y[i]);
+        fill_pseudo_random((uint32_t*)hashes[i], 8);
+        do {
+            fill_pseudo_random(nonces[i], 8);
+        } while (!p256_sign(signatures[i], signatures[i] + 8, hashes[i], 32, privkeys[i], nonces[i]));
+        ok &= p256_scalarmult_base(rx, ry, nonces[i]);
+        items[i] = (struct VerifyBatchItem){pubkeys_x[i], pubkeys_y[i], hashes[i], 32, signatures[i], signatures[i] + 8, ry[0] & 1};
+        ok &= p256_verify_precompute_public_key(&pk_precomps[i], pubkeys_x[i], pubkeys_y[i]);
+    }
+    fill_pseudo_random(batch_random[0], NUM_KEYS * 4);
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Each call of op performs NUM_KEYS operations
+static void bench(const char* name, void (*op)(void)) {
+    uint32_t iterations = 0;
+    double start = now(), elapsed;
+    do {
+        op();
+        iterations++;
+        elapsed = now() - start;
+    } while (elapsed < MIN_SECONDS);
+    double ops_per_sec = iterations * NUM_KEYS / elapsed;
+    if (cpu_mhz > 0) {
+        printf("%-40s %10.0f ops/s %10.1f us/op %10.0f cycles/op\n", name, ops_per_sec, 1e6 / ops_per_sec, cpu_mhz * 1e6 / ops_per_sec);
+    } else {
+        printf("%-40s %10.0f ops/s %10.1f us/op\n", name, ops_per_sec, 1e6 / ops_per_sec);
+    }
+}
+
+static void op_keygen(void) {
+    for (int i = 0; i < NUM_KEYS; i++) {
+        ok &= p256_keygen(out_x[i], out_y[i], privkeys[i]);
+    }
+}
+
+static void op_keygen_batch(void) {
+    ok &= p256_keygen_batch(results, out_x, out_y, privkeys, NUM_KEYS);
+}
+
+static void op_sign(void) {
+    for (int i = 0; i < NUM_KEYS; i++) {
+        uint32_t sig[16];
+        ok &= p256_sign(sig, sig + 8, hashes[i], 32, privkeys[i], nonces[i]);
+    }
+}
+
+static void op_sign_step1_batch(void) {
+    ok &= p256_sign_step1_batch(results, sign_precomps, nonces, NUM_KEYS, (const uint32_t*)batch_random);
+}
+
+static void op_verify(void) {
+    for (int i = 0; i < NUM_KEYS; i++) {
+        ok &= p256_verify(pubkeys_x[i], pubkeys_y[i], hashes[i], 32, signatures[i], signatures[i] + 8);
+    }
+}
+
+static void op_verify_precomp(void) {
+    for (int i = 0; i < NUM_KEYS; i++) {
+        ok &= p256_verify_precomp(&pk_precomps[i], hashes[i], 32, signatures[i], signatures[i] + 8);
+    }
+}
+
+static void op_verify_batch(void) {
+    ok &= p256_verify_batch(results, items, NUM_KEYS, batch_random);
+}
+
+#if defined(__x86_64__)
+static void op_verify_multi(void) {
+    ok &= p256_verify_multi(results, items, NUM_KEYS);
+}
+#endif
+
+#if defined(__linux__)
+static struct P256WorkerPool pool;
+static struct P256Job jobs[NUM_KEYS];
+static uint8_t shared_secrets[NUM_KEYS][32];
+
+static void op_pool_verify(void) {
+    for (int i = 0; i < NUM_KEYS; i++) {
+        jobs[i] = (struct P256Job){.type = P256_JOB_VERIFY, .args.verify = {pubkeys_x[i], pubkeys_y[i], hashes[i], 32, signatures[i], signatures[i] + 8}};
+    }
+    ok &= p256_worker_pool_run(&pool, jobs, NUM_KEYS);
+}
+
+static void op_pool_sign(void) {
+    static uint32_t sigs[NUM_KEYS][16];
+    for (int i = 0; i < NUM_KEYS; i++) {
+        jobs[i] = (struct P256Job){.type = P256_JOB_SIGN, .args.sign = {sigs[i], sigs[i] + 8, hashes[i], 32, privkeys[i], nonces[i]}};
+    }
+    ok &= p256_worker_pool_run(&pool, jobs, NUM_KEYS);
+}
+
+static void op_pool_ecdh(void) {
+    for (int i = 0; i < NUM_KEYS; i++) {
+        jobs[i] = (struct P256Job){.type = P256_JOB_ECDH, .args.ecdh = {shared_secrets[i], privkeys[i], pubkeys_x[(i + 1) % NUM_KEYS], pubkeys_y[(i + 1) % NUM_KEYS]}};
+    }
+    ok &= p256_worker_pool_run(&pool, jobs, NUM_KEYS);
+}
+
+static void op_pool_keygen(void) {
+    for (int i = 0; i < NUM_KEYS; i++) {
+        jobs[i] = (struct P256Job){.type = P256_JOB_KEYGEN, .args.keygen = {out_x[i], out_y[i], privkeys[i]}};
+    }
+    ok &= p256_worker_pool_run(&pool, jobs, NUM_KEYS);
+}
+#endif
+
+static void op_ecdh(void) {
+    for (int i = 0; i < NUM_KEYS; i++) {
+        uint8_t shared_secret[32];
+        ok &= p256_ecdh_calc_shared_secret(shared_secret, privkeys[i], pubkeys_x[(i + 1) % NUM_KEYS], pubkeys_y[(i + 1) % NUM_KEYS]);
+    }
+}
+
+static void op_ecdh_compressed(void) {
+    for (int i = 0; i < NUM_KEYS; i++) {
+        uint8_t shared_secret[32];
+        ok &= p256_ecdh_calc_shared_secret_compressed(shared_secret, privkeys[i], pubkeys_compressed[(i + 1) % NUM_KEYS]);
+    }
+}
+
+static void op_decompress(void) {
+    for (int i = 0; i < NUM_KEYS; i++) {
+        ok &= p256_octet_string_to_point(out_x[i], out_y[i], pubkeys_compressed[i], 33);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        cpu_mhz = atof(argv[1]);
+    }
+    p256_init();
+    create_input();
+    
+    bench("p256_keygen", op_keygen);
+    bench("p256_keygen_batch", op_keygen_batch);
+    bench("p256_sign", op_sign);
+    bench("p256_sign_step1_batch", op_sign_step1_batch);
+    bench("p256_verify", op_verify);
+    bench("p256_verify_precomp", op_verify_precomp);
+    bench("p256_verify_batch", op_verify_batch);
+    #if defined(__x86_64__)
+    printf("p256_verify_multi uses %u lanes\n", p256_verify_multi_lanes());
+    bench("p256_verify_multi", op_verify_multi);
+    #endif
+    bench("p256_ecdh_calc_shared_secret", op_ecdh);
+    bench("p256_ecdh_calc_shared_secret_compressed", op_ecdh_compressed);
+    bench("p256_octet_string_to_point (compressed)", op_decompress);
+    #if defined(__linux__)
+    for (uint32_t num_threads = 1; num_threads <= 4; num_threads++) {
+        char name[64];
+        if (!p256_worker_pool_start(&pool, num_threads)) {
+            ok = false;
+            break;
+        }
+        sprintf(name, "p256_verify (pool x%u)", num_threads);
+        bench(name, op_pool_verify);
+        sprintf(name, "p256_sign (pool x%u)", num_threads);
+        bench(name, op_pool_sign);
+        sprintf(name, "p256_ecdh_calc_shared_secret (pool x%u)", num_threads);
+        bench(name, op_pool_ecdh);
+        sprintf(name, "p256_keygen (pool x%u)", num_threads);
+        bench(name, op_pool_keygen);
+        p256_worker_pool_stop(&pool);
+    }
+    #endif
+    
+    if (!ok) {
+        printf("An operation FAILED\n");
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,16 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+// Runs the tests on a host (e.g. x86-64 Linux), using the portable C backend instead of the assembler code.
+// run "node testgen.js > tests.c" first, with a nodejs version >= 10.4, then e.g.
+// gcc -O2 -o p256-tests host_tests_main.c tests.c p256-cortex-m4.c p256-cortex-m4-portable.c
+// On x86-64, p256-x86-64-multi.c must also be added, and on AArch64, p256-aarch64-asm.S.
+// On Linux, p256-worker-pool.c must also be added (with -pthread).
+
+bool run_tests(void);
+
+int main() {
+    bool res = run_tests();
+    printf("%s\n", res ? "All tests passed" : "Tests FAILED");
+    return res ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <nrf52.h>
+#include <nrf52_bitfields.h>
+#include "p256-cortex-m4.h"
+
+// Measures the number of cycles per signature for p256_verify and p256_verify_batch,
+// the number of cycles per key for p256_keygen and p256_keygen_batch,
+// and the number of cycles per nonce for p256_sign_step1 and p256_sign_step1_batch.
+// Run it in a debugger and inspect the "cycles_per_signature", "cycles_per_key" and "cycles_per_nonce" arrays
+// when main returns.
+// Cycles are counted using the DWT cycle counter, so the CPU must have one (e.g. nRF52840).
+
+#define NUM_SIGNATURES 64
+
+static const uint32_t batch_sizes[] = {1, 4, 16, 64};
+
+static uint32_t privkeys[NUM_SIGNATURES][8];
+static uint32_t pubkeys[NUM_SIGNATURES][16];
+static uint32_t pubkeys_x[NUM_SIGNATURES][8], pubkeys_y[NUM_SIGNATURES][8];
+static uint8_t hashes[NUM_SIGNATURES][32];
+static uint32_t signatures[NUM_SIGNATURES][16];
+static struct VerifyBatchItem items[NUM_SIGNATURES];
+static uint32_t batch_random[NUM_SIGNATURES][4];
+static bool results[NUM_SIGNATURES];
+static uint32_t nonces[NUM_SIGNATURES][8];
+static struct SignPrecomp sign_precomps[NUM_SIGNATURES];
+
+// [0] is p256_verify, [1] is p256_verify_batch, for each batch size
+volatile uint32_t cycles_per_signature[sizeof(batch_sizes) / sizeof(batch_sizes[0])][2];
+
+// [0] is p256_keygen, [1] is p256_keygen_batch, for each batch size
+volatile uint32_t cycles_per_key[sizeof(batch_sizes) / sizeof(batch_sizes[0])][2];
+
+// [0] is p256_sign_step1, [1] is p256_sign_step1_batch, for each batch size
+volatile uint32_t cycles_per_nonce[sizeof(batch_sizes) / sizeof(batch_sizes[0])][2];
+
+// Not a secure random generator, only used to create deterministic benchmark input
+static uint32_t xorshift_state = 0x12345678;
+static void fill_pseudo_random(uint32_t* out, int num_words) {
+    for (int i = 0; i < num_words; i++) {
+        xorshift_state ^= xorshift_state << 13;
+        xorshift_state ^= xorshift_state >> 17;
+        xorshift_state ^= xorshift_state << 5;
+        out[i] = xorshift_state;
+    }
+}
+
+static void create_signatures(void) {
+    for (int i = 0; i < NUM_SIGNATURES; i++) {
+        uint32_t k[8], rx[8], ry[8];
+        do {
+            fill_pseudo_random(privkeys[i], 8);
+        } while (!p256_keygen(pubkeys[i], pubkeys[i] + 8, privkeys[i]));
+        fill_pseudo_random((uint32_t*)hashes[i], 8);
+        do {
+            fill_pseudo_random(k, 8);
+        } while (!p256_sign(signatures[i], signatures[i] + 8, hashes[i], 32, privkeys[i], k));
+        memcpy(nonces[i], k, 32);
+
+        // The signer knows R = k*G and can therefore publish the parity of its y coordinate
+        p256_scalarmult_base(rx, ry, k);
+        items[i] = (struct VerifyBatchItem){pubkeys[i], pubkeys[i] + 8, hashes[i], 32, signatures[i], signatures[i] + 8, ry[0] & 1};
+    }
+    fill_pseudo_random(batch_random[0], NUM_SIGNATURES * 4);
+}
+
+int main() {
+    NRF_NVMC->ICACHECNF = NVMC_ICACHECNF_CACHEEN_Enabled << NVMC_ICACHECNF_CACHEEN_Pos;
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    create_signatures();
+
+    bool ok = true;
+    for (int i = 0; i < sizeof(batch_sizes) / sizeof(batch_sizes[0]); i++) {
+        uint32_t n = batch_sizes[i];
+
+        uint32_t start = DWT->CYCCNT;
+        for (uint32_t j = 0; j < n; j++) {
+            ok &= p256_verify(pubkeys[j], pubkeys[j] + 8, hashes[j], 32, signatures[j], signatures[j] + 8);
+        }
+        cycles_per_signature[i][0] = (DWT->CYCCNT - start) / n;
+
+        start = DWT->CYCCNT;
+        ok &= p256_verify_batch(results, items, n, batch_random);
+        cycles_per_signature[i][1] = (DWT->CYCCNT - start) / n;
+
+        start = DWT->CYCCNT;
+        for (uint32_t j = 0; j < n; j++) {
+            ok &= p256_keygen(pubkeys_x[j], pubkeys_y[j], privkeys[j]);
+        }
+        cycles_per_key[i][0] = (DWT->CYCCNT - start) / n;
+
+        start = DWT->CYCCNT;
+        ok &= p256_keygen_batch(results, pubkeys_x, pubkeys_y, privkeys, n);
+        cycles_per_key[i][1] = (DWT->CYCCNT - start) / n;
+
+        start = DWT->CYCCNT;
+        for (uint32_t j = 0; j < n; j++) {
+            ok &= p256_sign_step1(&sign_precomps[j], nonces[j]);
+        }
+        cycles_per_nonce[i][0] = (DWT->CYCCNT - start) / n;
+
+        start = DWT->CYCCNT;
+        ok &= p256_sign_step1_batch(results, sign_precomps, nonces, n, (const uint32_t*)batch_random);
+        cycles_per_nonce[i][1] = (DWT->CYCCNT - start) / n;
+    }
+
+    assert(ok);
+    return ok ? 0 : 1;
+}
@@ -31,7 +31,55 @@
 	area |.text|, code, readonly
 	align 4
 
-#if (include_p256_basemult || include_p256_varmult) && has_d_cache
+#if p256_enable_stats
+; struct P256OpCounts, incremented at the entry of each counted function
+	extern p256_op_counts
+#endif
+
+#if (include_p256_basemult || include_p256_varmult || include_p256_ecdh_precomp) && has_d_cache
+#if has_mve
+; Selects one of many values
+; *r0 = output, *r1 = table, r2 = num coordinates, r3 = index to choose [0..7]
+; All 8 entries are loaded, one coordinate at a time, and merged into q0-q1 with vpsel,
+; using a predicate that is all ones only for the chosen entry.
+P256_select_point proc
+	export P256_select_point
+	push {r4-r6,lr}
+	frame push {r4-r6,lr}
+	
+	lsls r4,r2,#5
+0
+	vmov.i32 q0,#0
+	vmov.i32 q1,#0
+	mov r5,r1
+	movs r6,#0
+1
+	vldrw.u32 q2,[r5]
+	vldrw.u32 q3,[r5,#16]
+	adds r5,r4
+	
+	eors r12,r6,r3
+	clz r12,r12
+	lsrs r12,#5
+	rsbs r12,#0
+	vmsr p0,r12
+	vpsel q0,q2,q0
+	vpsel q1,q3,q1
+	
+	adds r6,#1
+	cmp r6,#8
+	bne %b1
+	
+	vstrw.32 q0,[r0]
+	vstrw.32 q1,[r0,#16]
+	adds r0,#32
+	adds r1,#32
+	subs r2,#1
+	bne %b0
+	
+	pop {r4-r6,pc}
+	endp
+#else
 ; Selects one of many values
 ; *r0 = output, *r1 = table, r2 = num coordinates, r3 = index to choose [0..7]
 ; 547 cycles for affine coordinates
@@ -103,6 +151,7 @@ P256_select_point proc
 	pop {r4-r11,pc}
 	endp
 #endif
+#endif
 	
 #if include_p256_verify || include_p256_sign
 ; in: *r0 = out, *r1 = a, *r2 = b
@@ -172,8 +221,13 @@ setzero proc
 ; To convert a value to Montgomery class, use P256_mulmod(value, R^512 mod p)
 ; To convert a value from Montgomery class to standard form, use P256_mulmod(value, 1)
 
-#if include_p256_mult || include_p256_decompress_point || include_p256_decode_point
-#if use_mul_for_sqr
+#if place_hot_code_in_ram
+	area |.ramfunc|, code, readonly
+	align 4
+#endif
+
+#if include_p256_mult || include_p256_point_decompression || include_p256_decode_point
+#if use_mul_for_sqr || (has_mve && use_mve_mulmod)
 P256_sqrmod proc
 	push {r0-r7,lr}
 	frame push {lr}
@@ -187,12 +241,342 @@ P256_sqrmod proc
 	endp
 #endif
 	
-#if has_fpu
+#if has_mve && use_mve_mulmod
+; If inputs are A*R mod p and B*R mod p, computes AB*R mod p
+; *r1 = in1, *r2 = in2
+; out: r0-r7
+; clobbers all other registers and q0-q3
+; The product is computed by product scanning over 16-bit limbs. Every column is a sum of at most 16 products,
+; which vmlaldav accumulates, 8 at a time, into a 64-bit register pair. The limbs of in2 are stored reversed on
+; the stack, surrounded by zeros, so that the in2 operand of each dot product is a single unaligned vector load.
+P256_mulmod proc
+#if p256_enable_stats
+	ldr r0,=p256_op_counts
+	ldr r3,[r0,#0] ; mulmod
+	adds r3,#1
+	str r3,[r0,#0]
+#endif
+	push {lr}
+	frame push {lr}
+	sub sp,#128
+	frame address sp,132
+	
+	; sp+0: product, sp+64: 7 zero limbs, in2 reversed, 7 zero limbs
+	mov r12,#28
+	vddup.u32 q2,r12,#4
+	vldrw.u32 q3,[r2,q2]
+	vrev32.16 q3,q3
+	vstrw.32 q3,[sp,#80]
+	vddup.u32 q2,r12,#4
+	vldrw.u32 q3,[r2,q2]
+	vrev32.16 q3,q3
+	vstrw.32 q3,[sp,#96]
+	vmov.i32 q3,#0
+	vstrw.32 q3,[sp,#64]
+	vstrw.32 q3,[sp,#112]
+	
+	vldrw.u32 q0,[r1]
+	vldrw.u32 q1,[r1,#16]
+	
+	; Column k is at sp+64+2*(23-k) for in1 limbs 0-7 and at sp+64+2*(31-k) for in1 limbs 8-15.
+	; r4:r5 accumulates the even column plus the carry, r6:r7 the odd column, which is then added shifted by 16 bits.
+	
+	vldrh.u16 q2,[sp,#110]
+	vmlaldav.u16 r4,r5,q0,q2
+	vldrh.u16 q3,[sp,#108]
+	vmlaldav.u16 r6,r7,q0,q3
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#0]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q2,[sp,#106]
+	vmlaldava.u16 r4,r5,q0,q2
+	vldrh.u16 q3,[sp,#104]
+	vmlaldav.u16 r6,r7,q0,q3
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#4]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q2,[sp,#102]
+	vmlaldava.u16 r4,r5,q0,q2
+	vldrh.u16 q3,[sp,#100]
+	vmlaldav.u16 r6,r7,q0,q3
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#8]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q2,[sp,#98]
+	vmlaldava.u16 r4,r5,q0,q2
+	vldrh.u16 q3,[sp,#96]
+	vmlaldav.u16 r6,r7,q0,q3
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#12]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q2,[sp,#94]
+	vldrh.u16 q3,[sp,#110]
+	vmlaldava.u16 r4,r5,q0,q2
+	vmlaldava.u16 r4,r5,q1,q3
+	vldrh.u16 q2,[sp,#92]
+	vldrh.u16 q3,[sp,#108]
+	vmlaldav.u16 r6,r7,q0,q2
+	vmlaldava.u16 r6,r7,q1,q3
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#16]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q2,[sp,#90]
+	vldrh.u16 q3,[sp,#106]
+	vmlaldava.u16 r4,r5,q0,q2
+	vmlaldava.u16 r4,r5,q1,q3
+	vldrh.u16 q2,[sp,#88]
+	vldrh.u16 q3,[sp,#104]
+	vmlaldav.u16 r6,r7,q0,q2
+	vmlaldava.u16 r6,r7,q1,q3
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#20]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q2,[sp,#86]
+	vldrh.u16 q3,[sp,#102]
+	vmlaldava.u16 r4,r5,q0,q2
+	vmlaldava.u16 r4,r5,q1,q3
+	vldrh.u16 q2,[sp,#84]
+	vldrh.u16 q3,[sp,#100]
+	vmlaldav.u16 r6,r7,q0,q2
+	vmlaldava.u16 r6,r7,q1,q3
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#24]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q2,[sp,#82]
+	vldrh.u16 q3,[sp,#98]
+	vmlaldava.u16 r4,r5,q0,q2
+	vmlaldava.u16 r4,r5,q1,q3
+	vldrh.u16 q2,[sp,#80]
+	vldrh.u16 q3,[sp,#96]
+	vmlaldav.u16 r6,r7,q0,q2
+	vmlaldava.u16 r6,r7,q1,q3
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#28]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q2,[sp,#78]
+	vldrh.u16 q3,[sp,#94]
+	vmlaldava.u16 r4,r5,q0,q2
+	vmlaldava.u16 r4,r5,q1,q3
+	vldrh.u16 q2,[sp,#76]
+	vldrh.u16 q3,[sp,#92]
+	vmlaldav.u16 r6,r7,q0,q2
+	vmlaldava.u16 r6,r7,q1,q3
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#32]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q2,[sp,#74]
+	vldrh.u16 q3,[sp,#90]
+	vmlaldava.u16 r4,r5,q0,q2
+	vmlaldava.u16 r4,r5,q1,q3
+	vldrh.u16 q2,[sp,#72]
+	vldrh.u16 q3,[sp,#88]
+	vmlaldav.u16 r6,r7,q0,q2
+	vmlaldava.u16 r6,r7,q1,q3
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#36]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q2,[sp,#70]
+	vldrh.u16 q3,[sp,#86]
+	vmlaldava.u16 r4,r5,q0,q2
+	vmlaldava.u16 r4,r5,q1,q3
+	vldrh.u16 q2,[sp,#68]
+	vldrh.u16 q3,[sp,#84]
+	vmlaldav.u16 r6,r7,q0,q2
+	vmlaldava.u16 r6,r7,q1,q3
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#40]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q2,[sp,#66]
+	vldrh.u16 q3,[sp,#82]
+	vmlaldava.u16 r4,r5,q0,q2
+	vmlaldava.u16 r4,r5,q1,q3
+	vldrh.u16 q2,[sp,#80]
+	vmlaldav.u16 r6,r7,q1,q2
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#44]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q3,[sp,#78]
+	vmlaldava.u16 r4,r5,q1,q3
+	vldrh.u16 q2,[sp,#76]
+	vmlaldav.u16 r6,r7,q1,q2
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#48]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q3,[sp,#74]
+	vmlaldava.u16 r4,r5,q1,q3
+	vldrh.u16 q2,[sp,#72]
+	vmlaldav.u16 r6,r7,q1,q2
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#52]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q3,[sp,#70]
+	vmlaldava.u16 r4,r5,q1,q3
+	vldrh.u16 q2,[sp,#68]
+	vmlaldav.u16 r6,r7,q1,q2
+	lsll r6,r7,#16
+	adds r4,r4,r6
+	adc r5,r5,r7
+	str r4,[sp,#56]
+	lsrl r4,r5,#32
+	
+	vldrh.u16 q3,[sp,#66]
+	vmlaldava.u16 r4,r5,q1,q3
+	str r4,[sp,#60]
+	
+	; now reduce, the same way as the scalar version
+	add r0,sp,#36
+	ldm r0,{r9-r11,lr}
+	ldm sp,{r0-r8}
+	
+	mov r12,#0
+
+	adds r3,r0
+	adcs r4,r1
+	adcs r5,r2
+	adcs r6,r0
+	adcs r7,r1
+	adcs r8,r0
+	adcs r9,r1
+	adcs r10,#0
+	adcs r11,#0
+	adcs r12,#0
+
+	adds r6,r3
+	adcs r7,r4 ; r4 instead of 0
+	adcs r8,r2
+	adcs r9,r3
+	adcs r10,r2
+	adcs r11,r3
+	adcs r12,#0
+
+	subs r7,r0
+	sbcs r8,r1
+	sbcs r9,r2
+	sbcs r10,r3
+	sbcs r11,#0
+	sbcs r12,#0 ; r12 is between 0 and 2
+
+	add r1,sp,#52
+	ldm r1,{r1-r3}
+
+	adds r0,lr,r12
+	adcs r1,#0
+	mov r12,#0
+	adcs r12,#0
+
+	;adds r7,r4 (added above instead)
+	adcs r8,r5
+	adcs r9,r6
+	adcs r10,r4
+	adcs r11,r5
+	adcs r0,r4
+	adcs r1,r5
+	adcs r2,r12
+	adcs r3,#0
+	mov r12,#0
+	adcs r12,#0
+
+	adcs r10,r7
+	adcs r11,#0
+	adcs r0,r6
+	adcs r1,r7
+	adcs r2,r6
+	adcs r3,r7
+	adcs r12,#0
+
+	subs r11,r4
+	sbcs r0,r5
+	sbcs r1,r6
+	sbcs r2,r7
+	sbcs r3,#0
+	sbcs r12,#0
+	
+	; now (T + mN) / R is
+	; 8 9 10 11 0 1 2 3 12 (lsb -> msb)
+	
+	subs r8,r8,#0xffffffff
+	sbcs r9,r9,#0xffffffff
+	sbcs r10,r10,#0xffffffff
+	sbcs r11,r11,#0
+	sbcs r4,r0,#0
+	sbcs r5,r1,#0
+	sbcs r6,r2,#1
+	sbcs r7,r3,#0xffffffff
+	sbc r12,r12,#0
+	
+	adds r0,r8,r12
+	adcs r1,r9,r12
+	adcs r2,r10,r12
+	adcs r3,r11,#0
+	adcs r4,r4,#0
+	adcs r5,r5,#0
+	adcs r6,r6,r12, lsr #31
+	adcs r7,r7,r12
+	
+	add sp,#128
+	frame address sp,4
+	
+	pop {pc}
+	
+	endp
+#if p256_enable_stats
+	ltorg
+#endif
+	
+#elif has_fpu
 ; If inputs are A*R mod p and B*R mod p, computes AB*R mod p
 ; *r1 = in1, *r2 = in2
 ; out: r0-r7
 ; clobbers all other registers
 P256_mulmod proc
+#if p256_enable_stats
+	ldr r0,=p256_op_counts
+	ldr r3,[r0,#0] ; mulmod
+	adds r3,#1
+	str r3,[r0,#0]
+#endif
 	push {lr}
 	frame push {lr}
 	
@@ -431,12 +815,21 @@ P256_mulmod proc
 	
 	pop {pc}
 	endp
+#if p256_enable_stats
+	ltorg
+#endif
 	
 #if !use_mul_for_sqr
 ; If input is A*R mod p, computes A^2*R mod p
 ; in/out: r0-r7
 ; clobbers all other registers
 P256_sqrmod proc
+#if p256_enable_stats
+	ldr r9,=p256_op_counts
+	ldr r10,[r9,#4] ; sqrmod
+	adds r10,#1
+	str r10,[r9,#4]
+#endif
 	push {lr}
 	frame push {lr}
 	
@@ -714,6 +1107,9 @@ X15 RN 2
 	
 	pop {pc}
 	endp
+#if p256_enable_stats
+	ltorg
+#endif
 #endif
 	
 #else
@@ -723,6 +1119,12 @@ X15 RN 2
 ; clobbers all other registers
 ; cycles: 231
 P256_mulmod proc
+#if p256_enable_stats
+	ldr r0,=p256_op_counts
+	ldr r3,[r0,#0] ; mulmod
+	adds r3,#1
+	str r3,[r0,#0]
+#endif
 	push {r2,lr}
 	frame push {lr}
 	frame address sp,8
@@ -963,6 +1365,9 @@ P256_mulmod proc
 	pop {pc}
 	
 	endp
+#if p256_enable_stats
+	ltorg
+#endif
 
 #if !use_mul_for_sqr
 ; 173 cycles
@@ -970,6 +1375,12 @@ P256_mulmod proc
 ; in/out: r0-r7
 ; clobbers all other registers
 P256_sqrmod proc
+#if p256_enable_stats
+	ldr r9,=p256_op_counts
+	ldr r10,[r9,#4] ; sqrmod
+	adds r10,#1
+	str r10,[r9,#4]
+#endif
 	push {lr}
 	frame push {lr}
 	
@@ -1258,6 +1669,9 @@ X15 RN 12
 	pop {pc}
 	
 	endp
+#if p256_enable_stats
+	ltorg
+#endif
 #endif
 #endif
 
@@ -1267,6 +1681,12 @@ X15 RN 12
 ; out: r0-r7
 ; clobbers all other registers
 P256_submod proc
+#if p256_enable_stats
+	ldr r0,=p256_op_counts
+	ldr r12,[r0,#12] ; submod
+	adds r12,#1
+	str r12,[r0,#12]
+#endif
 	ldm r1,{r3-r10}
 	ldm r2!,{r0,r1,r11,r12}
 	subs r3,r0
@@ -1293,15 +1713,24 @@ P256_submod proc
 	bx lr
 	
 	endp
+#if p256_enable_stats
+	ltorg
+#endif
 #endif
 
-#if include_p256_mult || include_p256_decompress_point
+#if include_p256_mult || include_p256_point_decompression
 ; 52 cycles
 ; Computes A + B mod p, assumes A, B < p
 ; in: *r1, *r2
 ; out: r0-r7
 ; clobbers all other registers
 P256_addmod proc
+#if p256_enable_stats
+	ldr r0,=p256_op_counts
+	ldr r12,[r0,#8] ; addmod
+	adds r12,#1
+	str r12,[r0,#8]
+#endif
 	ldm r2,{r2-r9}
 	ldm r1!,{r0,r10,r11,r12}
 	adds r2,r0
@@ -1338,9 +1767,12 @@ P256_addmod proc
 	bx lr
 	
 	endp
+#if p256_enable_stats
+	ltorg
+#endif
 #endif
 	
-#if include_p256_mult || include_p256_decompress_point
+#if include_p256_point_decompression || include_p256_xycz_ladder || include_p256_bench_internals || (include_p256_mult && !use_safegcd_mod_p_inv)
 ; cycles: 19 + 181*n
 P256_sqrmod_many proc
 	; in: r0-r7, count: r8
@@ -1374,12 +1806,19 @@ P256_sqrmod_many_and_mulmod proc
 	endp
 	
 
-; in: r0-r7 = value, r8 = 0 for modinv and 1 for sqrt
+; in: r0-r7 = value, r8 = 0 for modinv, 1 for sqrt and 2 for the inverse square root candidate
 ; out: r0-r7
 ; for modinv, call input a, then if a = A * R % p, then it calculates A^-1 * R % p = (a/R)^-1 * R % p = R^2 / a % p
 ; for sqrt, call input a, then if a = A * R % p, then it calculates sqrt(A) * R % p
+; for the inverse square root candidate, call input a, then if a = A * R % p, then it calculates A^((p-3)/4) * R % p
 P256_modinv_sqrt proc
 	push {r0-r8,lr}
+#if p256_enable_stats
+	ldr r9,=p256_op_counts
+	ldr r10,[r9,#24] ; modinv_sqrt
+	adds r10,#1
+	str r10,[r9,#24]
+#endif
 	
 	; t = a^2*a
 	mov r8,#1
@@ -1423,8 +1862,8 @@ P256_modinv_sqrt proc
 	bl P256_sqrmod_many_and_mulmod
 	
 	ldr r8,[sp,#6*32]
-	cmp r8,#0
-	bne %f0
+	cmp r8,#1
+	beq %f0
 	
 	; t = t^(2^(192-64))*a32_0
 	mov r8,#192-64
@@ -1451,6 +1890,12 @@ P256_modinv_sqrt proc
 	add r9,sp,#128
 	bl P256_sqrmod_many_and_mulmod
 	
+#if include_p256_xycz_ladder
+	ldr r8,[sp,#6*32]
+	cmp r8,#2
+	beq %f2
+#endif
+	
 	; t = t^(2^(256-252))*a4_2
 	mov r8,#256-252
 	add r9,sp,#96
@@ -1463,6 +1908,20 @@ P256_modinv_sqrt proc
 	bl P256_mulmod
 	b %f1
 
+#if include_p256_xycz_ladder
+2
+	; t = t^(2^(253-252))*a
+	mov r8,#1
+	add r9,sp,#5*32
+	bl P256_sqrmod_many_and_mulmod
+	
+	; r = t^(2^(254-253))*a
+	mov r8,#1
+	add r9,sp,#5*32
+	bl P256_sqrmod_many_and_mulmod
+	b %f1
+#endif
+
 0
 	; t = t^(2^(160-64))*a
 	mov r8,#160-64
@@ -1479,6 +1938,9 @@ P256_modinv_sqrt proc
 	pop {pc}
 	
 	endp
+#if p256_enable_stats
+	ltorg
+#endif
 #endif
 
 #if include_p256_mult
@@ -1519,7 +1981,11 @@ P256_times2 proc
 	endp
 #endif
 
-#if include_p256_verify || include_p256_varmult || include_p256_decompress_point
+#if place_hot_code_in_ram
+	area |.text|, code, readonly
+#endif
+
+#if include_p256_verify || include_p256_varmult || include_p256_xycz_ladder || include_p256_point_decompression
 	align 4
 	; (2^256)^2 mod p
 R2_mod_p
@@ -1548,7 +2014,7 @@ P256_to_montgomery proc
 	endp
 #endif
 
-#if include_p256_basemult || include_p256_varmult || include_p256_decompress_point
+#if include_p256_basemult || include_p256_varmult || include_p256_xycz_ladder || include_p256_point_decompression
 ; in: *r1
 ; out: *r0
 P256_from_montgomery proc
@@ -1578,7 +2044,7 @@ P256_from_montgomery proc
 	endp
 #endif
 
-#if include_p256_verify || include_p256_varmult || include_p256_decompress_point || include_p256_decode_point
+#if include_p256_verify || include_p256_varmult || include_p256_xycz_ladder || include_p256_point_decompression || include_p256_decode_point
 ; Checks whether the input number is within [0,p-1]
 ; in: *r0
 ; out: r0 = 1 if ok, else 0
@@ -1608,6 +2074,60 @@ P256_check_range_p proc
 	endp
 #endif
 
+#if include_p256_batch_inversion || include_p256_bench_internals || include_p256_safegcd_mod_p
+; If inputs are A*R mod p and B*R mod p, computes AB*R mod p
+; in: *r1, *r2
+; out: *r0
+P256_mul_mod_p proc
+	export P256_mul_mod_p
+	push {r0,r4-r11,lr}
+	frame push {r4-r11,lr}
+	frame address sp,40
+	bl P256_mulmod
+	pop {r8}
+	frame address sp,36
+	stm r8,{r0-r7}
+	pop {r4-r11,pc}
+	endp
+
+#if include_p256_bench_internals
+; If input is A*R mod p, computes A^2*R mod p
+; in: *r1
+; out: *r0
+P256_sqr_mod_p proc
+	export P256_sqr_mod_p
+	push {r0,r4-r11,lr}
+	frame push {r4-r11,lr}
+	frame address sp,40
+	ldm r1,{r0-r7}
+	bl P256_sqrmod
+	pop {r8}
+	frame address sp,36
+	stm r8,{r0-r7}
+	pop {r4-r11,pc}
+	endp
+#endif
+
+#if (include_p256_batch_inversion && !use_safegcd_mod_p_inv) || include_p256_bench_internals
+; If input is A*R mod p, computes A^-1 * R mod p
+; in: *r1
+; out: *r0
+P256_mod_p_inv proc
+	export P256_mod_p_inv
+	push {r0,r4-r11,lr}
+	frame push {r4-r11,lr}
+	frame address sp,40
+	ldm r1,{r0-r7}
+	mov r8,#0
+	bl P256_modinv_sqrt
+	pop {r8}
+	frame address sp,36
+	stm r8,{r0-r7}
+	pop {r4-r11,pc}
+	endp
+#endif
+#endif
+
 
 ; Arithmetics for the group order n =
 ; 0xffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632551
@@ -1727,8 +2247,9 @@ P256_reduce_mod_n_32bytes proc
 	stm r8,{r0-r7}
 	pop {r4-r11,pc}
 	endp
+#endif
 
-
+#if include_p256_sign || include_p256_verify_batch
 ; Adds two numbers mod n, both inputs can be any 256-bit numbers
 ; out and in may overlap
 ; in: *r1, *r2
@@ -1808,8 +2329,9 @@ P256_mul_mod_n proc
 	pop {r4-r10,pc}
 	
 	endp
+#endif
 
-#if include_p256_sign
+#if include_p256_sign || include_p256_safegcd_mod_p
 ; r0: delta (also returned)
 ; r1: f
 ; r2: g
@@ -1986,7 +2508,9 @@ P256_matrix_mul_fg_9 proc
 	
 	pop {r4-r11,pc}
 	endp
+#endif
 
+#if include_p256_sign
 ; r0: a, r1: b
 ; *r2: x,y
 ; *r3: out
@@ -2142,42 +2666,191 @@ P256_matrix_mul_mod_n proc
 	
 	ltorg
 	endp
-#else
-; *r0=u
-; *r1=x1
-mod_inv_vartime_inner_n proc
-	adr r11,P256_order
-	ldm r0,{r2-r9}
-	cmp r2,#1
-	bne %f1
-
-	orrs r10,r3,r4
-	orrs r10,r5
-	orrs r10,r6
-	orrs r10,r7
-	orrs r10,r8
-	orrs r10,r9
-	itt eq
-	moveq r0,#1
-	bxeq lr
+#endif
 
-1
-	tst r2,#1
-	itt ne
-	movne r0,#0
-	bxne lr
-2
-	lsrs r9,#1
-	rrxs r8,r8
-	rrxs r7,r7
-	rrxs r6,r6
-	rrxs r5,r5
-	rrxs r4,r4
-	rrxs r3,r3
-	rrxs r2,r2
-	stm r0,{r2-r9}
-	ldm r1,{r3-r10}
-	tst r3,#1
+#if include_p256_safegcd_mod_p
+; r0: a, r1: b
+; *r2: x,y
+; *r3: out
+	align 4
+P256_matrix_mul_mod_p proc
+	export P256_matrix_mul_mod_p
+	push {r4-r11,lr}
+	frame push {r4-r11,lr}
+	
+	; this function calculates a * x + b * y mod p (where p is the prime of the P-256 field)
+	
+	; the range is [-2^30, 2^31], so if negative, the top 2 bits are both 1s
+	; convert to absolute value and sign
+	and r4,r0,r0,lsl #1
+	asrs r4,r4,#31
+	eors r0,r0,r4
+	subs r0,r0,r4
+	
+	and r5,r1,r1,lsl #1
+	asrs r5,r5,#31
+	eors r1,r1,r5
+	subs r1,r1,r5
+	
+	ldm r2!,{r6} ; x sign
+	ldr r7,[r2,#32] ; y sign
+	
+	; compute the resulting sign, which will be negative if exactly one of x'sign and y's sign is negative
+	eors r4,r4,r6 ; combine x's sign and a's sign
+	eors r5,r5,r7 ; combine y's sign and b's sign
+	eors r4,r4,r5 ; mask for negating a * x before adding to b * y
+	stm r3!,{r5}
+	push {r1,r2,r3}
+	frame address sp,48
+	
+	; load x, which is stored as an unsigned 256-bit integer and initially conditionally negated through r6
+	; now conditionally negate it depending on the r4 mask
+	ldm r2,{r1-r3,r5-r9}
+	eors r1,r1,r4
+	eors r2,r2,r4
+	eors r3,r3,r4
+	eors r5,r5,r4
+	eors r6,r6,r4
+	eors r7,r7,r4
+	eor r8,r8,r4
+	eor r9,r9,r4
+	
+	subs r1,r1,r4
+	sbcs r2,r2,r4
+	sbcs r3,r3,r4
+	sbcs r5,r5,r4
+	sbcs r6,r6,r4
+	sbcs r7,r7,r4
+	sbcs r8,r8,r4
+	sbcs r9,r9,r4
+	
+	sbcs r4,r4,r4 ; if the value is nonzero, r4 will now contain -1 and we will add p to make it positive
+	
+	adds r1,r1,r4
+	adcs r2,r2,r4
+	adcs r3,r3,r4
+	adcs r5,r5,#0
+	adcs r6,r6,#0
+	adcs r7,r7,#0
+	adcs r8,r8,r4,lsr #31
+	adc r9,r9,r4
+	mov r10,#0
+	
+	; calculate a * x, the result fits in 287 bits
+	umull r11,lr,r10,r10
+	umull r10,lr,r0,r1
+	umull r1,r12,r11,r11
+	umaal r11,lr,r0,r2
+	umaal r1,lr,r0,r3
+	umull r2,r3,r12,r12
+	umaal r2,lr,r0,r5
+	umaal r3,lr,r0,r6
+	umull r4,r5,r12,r12
+	umaal r4,lr,r0,r7
+	umaal r5,lr,r0,r8
+	umaal r12,lr,r0,r9
+	
+	; add b*y, the result will fit in 288 bits
+	pop {r0,r6}
+	frame address sp,40
+	adds r6,r6,#36
+	ldm r6!,{r8,r9}
+	movs r7,#0
+	umaal r10,r7,r0,r8
+	umaal r11,r7,r0,r9
+	ldm r6!,{r8,r9}
+	umaal r1,r7,r0,r8
+	umaal r2,r7,r0,r9
+	ldm r6!,{r8,r9}
+	umaal r3,r7,r0,r8
+	umaal r4,r7,r0,r9
+	ldm r6!,{r8,r9}
+	umaal r5,r7,r0,r8
+	umaal r12,r7,r0,r9
+	add lr,lr,r7
+	
+	; reduce modulo p using montgomery redc algorithm
+	; since p = -1 mod R, the factor m = ((T mod R)p') mod R is simply T mod R = r10,
+	; and t = (T + mp) / R = floor(T / R) + m * (2^224 - 2^192 + 2^160 + 2^64)
+	movs r0,#0
+	adds r2,r2,r10
+	adcs r3,r3,#0
+	adcs r4,r4,#0
+	adcs r5,r5,r10
+	adcs r12,r12,#0
+	adcs lr,lr,r10
+	adc r0,r0,#0
+	subs r12,r12,r10
+	sbcs lr,lr,#0
+	sbc r0,r0,#0
+	
+	; since |a| + |b| <= 2^31, t < 2p, so conditionally subtract p unless the result becomes negative
+	subs r11,r11,#0xffffffff
+	sbcs r1,r1,#0xffffffff
+	sbcs r2,r2,#0xffffffff
+	sbcs r3,r3,#0
+	sbcs r4,r4,#0
+	sbcs r5,r5,#0
+	sbcs r12,r12,#1
+	sbcs lr,lr,#0xffffffff
+	sbcs r0,r0,#0 ; if the result becomes negative, r0 becomes -1
+	
+	; conditionally add back p
+	adds r11,r11,r0
+	adcs r1,r1,r0
+	adcs r2,r2,r0
+	adcs r3,r3,#0
+	adcs r4,r4,#0
+	adcs r5,r5,#0
+	adcs r12,r12,r0,lsr #31
+	adc lr,lr,r0
+	
+	pop {r6}
+	frame address sp,36
+	stm r6!,{r11}
+	stm r6,{r1,r2,r3,r4,r5,r12,lr}
+	
+	pop {r4-r11,pc}
+	
+	endp
+#endif
+
+#if include_p256_verify && !include_p256_sign
+; *r0=u
+; *r1=x1
+mod_inv_vartime_inner_n proc
+	adr r11,P256_order
+	ldm r0,{r2-r9}
+	cmp r2,#1
+	bne %f1
+
+	orrs r10,r3,r4
+	orrs r10,r5
+	orrs r10,r6
+	orrs r10,r7
+	orrs r10,r8
+	orrs r10,r9
+	itt eq
+	moveq r0,#1
+	bxeq lr
+
+1
+	tst r2,#1
+	itt ne
+	movne r0,#0
+	bxne lr
+2
+	lsrs r9,#1
+	rrxs r8,r8
+	rrxs r7,r7
+	rrxs r6,r6
+	rrxs r5,r5
+	rrxs r4,r4
+	rrxs r3,r3
+	rrxs r2,r2
+	stm r0,{r2-r9}
+	ldm r1,{r3-r10}
+	tst r3,#1
 	beq %f3
 	ldr r12,[r11,#0]
 	adds r3,r12
@@ -2214,6 +2887,12 @@ mod_inv_vartime_inner_n proc
 ; *r1 = input
 P256_mod_n_inv_vartime proc
 	export P256_mod_n_inv_vartime
+#if p256_enable_stats
+	ldr r2,=p256_op_counts
+	ldr r3,[r2,#28] ; inv_mod_n
+	adds r3,#1
+	str r3,[r2,#28]
+#endif
 	push {r0,r4-r11,lr}
 	frame push {r4-r11,lr}
 	frame address sp,40
@@ -2335,6 +3014,8 @@ P256_mod_n_inv_vartime proc
 	pop {r4-r11,pc}
 	
 	endp
+#if p256_enable_stats
+	ltorg
 #endif
 #endif
 
@@ -2396,7 +3077,7 @@ P256_check_range_n proc
 
 ; Elliptic curve operations on the NIST curve P-256
 
-#if include_p256_verify || include_p256_varmult || include_p256_decompress_point || include_p256_decode_point
+#if include_p256_verify || include_p256_varmult || include_p256_xycz_ladder || include_p256_point_decompression || include_p256_decode_point
 	align 4
 b_mont
 	dcd 0x29c4bddf
@@ -2418,7 +3099,7 @@ three_mont
 	dcd 0x2
 #endif
 
-#if include_p256_verify || include_p256_varmult || include_p256_decode_point
+#if include_p256_verify || include_p256_varmult || include_p256_xycz_ladder || include_p256_decode_point
 ; Checks if a point is on curve
 ; in: *r0 = x, *r1 = y, in Montgomery form
 ; out: r0 = 1 if on curve, else 0
@@ -2486,7 +3167,7 @@ P256_point_is_on_curve proc
 	endp
 #endif
 
-#if include_p256_basemult || include_p256_varmult || include_p256_decompress_point
+#if include_p256_basemult || include_p256_varmult || include_p256_xycz_ladder || include_p256_point_decompression || include_p256_safegcd_mod_p
 	align 4
 P256_p
 	dcd 0xffffffff
@@ -2499,137 +3180,734 @@ P256_p
 	dcd 0xffffffff
 #endif
 
-#if include_p256_decompress_point
-; in: r0 = output location for y, *r1 = x, r2 = parity bit for y
-; out: r0 = 1 if ok, 0 if invalid x
-P256_decompress_point proc
-	export P256_decompress_point
-	push {r0,r2,r4-r11,lr}
+#if include_p256_point_decompression
+; in: r0 = output location for y, *r1 = x, r2 = parity bit for y
+; out: r0 = 1 if ok, 0 if invalid x
+P256_decompress_point proc
+	export P256_decompress_point
+	push {r0,r2,r4-r11,lr}
+	frame push {r4-r11,lr}
+	frame address sp,44
+	sub sp,#32
+	frame address sp,76
+	
+	mov r0,sp
+	bl P256_to_montgomery
+	ldm sp,{r0-r7}
+	
+	bl P256_sqrmod
+	push {r0-r7}
+	
+	mov r1,sp
+	adr r2,three_mont
+	bl P256_submod
+	stm sp,{r0-r7}
+	frame address sp,108
+	
+	add r1,sp,#32
+	mov r2,sp
+	bl P256_mulmod
+	stm sp,{r0-r7}
+	
+	mov r1,sp
+	adr r2,b_mont
+	bl P256_addmod
+	stm sp,{r0-r7}
+	
+	mov r8,#1
+	bl P256_modinv_sqrt
+	add r8,sp,#32
+	stm r8,{r0-r7}
+	
+	bl P256_sqrmod
+	
+	pop {r8-r11}
+	frame address sp,92
+	eors r8,r0
+	ittt eq
+	eorseq r9,r1
+	eorseq r10,r2
+	eorseq r11,r3
+	pop {r8-r11}
+	frame address sp,76
+	itttt eq
+	eorseq r8,r4
+	eorseq r9,r5
+	eorseq r10,r6
+	eorseq r11,r7
+	it ne
+	movne r0,#0
+	bne %f1
+	
+	mov r0,sp
+	mov r1,sp
+	bl P256_from_montgomery
+	
+	ldr r3,[sp]
+	ldrd r0,r1,[sp,#32]
+	and r2,r3,#1
+	eors r2,r1
+	mov r1,sp
+	adr r3,P256_p
+	bl P256_negate_mod_m_if
+	movs r0,#1
+1
+	add sp,#32+8
+	frame address sp,36
+	pop {r4-r11,pc}
+	
+	endp
+#endif
+
+#if include_p256_jacobian_to_affine && !use_safegcd_mod_p_inv
+; *r0 = output affine montgomery x
+; *r1 = output affine montgomery y
+; *r2 = input jacobian montgomery
+P256_jacobian_to_affine proc
+	export P256_jacobian_to_affine
+	push {r0,r1,r2,r4-r11,lr}
+	frame push {r4-r11,lr}
+	frame address sp,48
+	
+	adds r2,#64
+	ldm r2,{r0-r7}
+	mov r8,#0
+	bl P256_modinv_sqrt
+	push {r0-r7}
+	frame address sp,80
+	
+	bl P256_sqrmod
+	push {r0-r7}
+	frame address sp,112
+	
+	add r1,sp,#32
+	mov r2,sp
+	bl P256_mulmod
+	add r8,sp,#32
+	stm r8,{r0-r7}
+	
+	mov r1,sp
+	ldr r2,[sp,#72]
+	bl P256_mulmod
+	ldr r8,[sp,#64]
+	stm r8,{r0-r7}
+	
+	ldr r2,[sp,#72]
+	add r1,sp,#32
+	adds r2,r2,#32
+	bl P256_mulmod
+	ldr r8,[sp,#68]
+	stm r8,{r0-r7}
+	
+	add sp,#76
+	frame address sp,36
+	
+	pop {r4-r11,pc}
+	endp
+#endif
+	
+#if include_p256_xycz_ladder
+; Conditionally swaps the two points (X0,Y0) at *r0 and (X1,Y1) at *r0+64
+; in: *r0, r1 = 1 to swap, 0 to leave unchanged
+; out: r0 is preserved
+; clobbers r1-r12
+P256_xycz_cswap proc
+	rsbs r1,r1,#0
+	movs r12,#4
+0
+	add r10,r0,#64
+	ldm r0,{r2-r5}
+	ldm r10,{r6-r9}
+	eors r11,r2,r6
+	ands r11,r1
+	eors r2,r11
+	eors r6,r11
+	eors r11,r3,r7
+	ands r11,r1
+	eors r3,r11
+	eors r7,r11
+	eors r11,r4,r8
+	ands r11,r1
+	eors r4,r11
+	eors r8,r11
+	eors r11,r5,r9
+	ands r11,r1
+	eors r5,r11
+	eors r9,r11
+	stm r0!,{r2-r5}
+	stm r10,{r6-r9}
+	subs r12,#1
+	bne %b0
+	subs r0,#64
+	bx lr
+	endp
+
+; Co-Z conjugate addition (XYCZ-ADDC), https://eprint.iacr.org/2011/338.pdf
+; The points P = (X1,Y1) at *r0 and Q = (X2,Y2) at *r0+64 share the same Z coordinate (integers are in Montgomery form).
+; They are replaced by P+Q and P-Q, which also share the same (new) Z coordinate.
+; in: *r0
+; out: r0 is preserved
+; clobbers all other registers
+P256_xycz_addc proc
+	push {r0,lr}
+	frame push {lr}
+	frame address sp,8
+	sub sp,#160
+	frame address sp,168
+	
+	; C = (X1 - X2)^2
+	mov r1,r0
+	add r2,r0,#64
+	bl P256_submod
+	bl P256_sqrmod
+	stm sp,{r0-r7}
+	
+	; X2 = W2 = X2 * C
+	ldr r1,[sp,#160]
+	adds r1,#64
+	mov r2,sp
+	bl P256_mulmod
+	ldr r8,[sp,#160]
+	add r8,#64
+	stm r8,{r0-r7}
+	
+	; X1 = W1 = X1 * C
+	ldr r1,[sp,#160]
+	mov r2,sp
+	bl P256_mulmod
+	ldr r8,[sp,#160]
+	stm r8,{r0-r7}
+	
+	; A1 = Y1 * (W1 - W2)
+	ldr r1,[sp,#160]
+	add r2,r1,#64
+	bl P256_submod
+	stm sp,{r0-r7}
+	ldr r1,[sp,#160]
+	adds r1,#32
+	mov r2,sp
+	bl P256_mulmod
+	stm sp,{r0-r7}
+	
+	; t1 = Y1 - Y2
+	ldr r1,[sp,#160]
+	adds r1,#32
+	add r2,r1,#64
+	bl P256_submod
+	add r8,sp,#32
+	stm r8,{r0-r7}
+	
+	; t2 = Y1 + Y2
+	ldr r1,[sp,#160]
+	adds r1,#32
+	add r2,r1,#64
+	bl P256_addmod
+	add r8,sp,#64
+	stm r8,{r0-r7}
+	
+	; t3 = X3 = t1^2 - W1 - W2
+	add r0,sp,#32
+	ldm r0,{r0-r7}
+	bl P256_sqrmod
+	add r8,sp,#96
+	stm r8,{r0-r7}
+	add r1,sp,#96
+	ldr r2,[sp,#160]
+	bl P256_submod
+	add r8,sp,#96
+	stm r8,{r0-r7}
+	add r1,sp,#96
+	ldr r2,[sp,#160]
+	adds r2,#64
+	bl P256_submod
+	add r8,sp,#96
+	stm r8,{r0-r7}
+	
+	; Y1 = Y3 = t1 * (W1 - X3) - A1
+	ldr r1,[sp,#160]
+	add r2,sp,#96
+	bl P256_submod
+	add r8,sp,#128
+	stm r8,{r0-r7}
+	add r1,sp,#32
+	add r2,sp,#128
+	bl P256_mulmod
+	add r8,sp,#128
+	stm r8,{r0-r7}
+	add r1,sp,#128
+	mov r2,sp
+	bl P256_submod
+	ldr r8,[sp,#160]
+	add r8,#32
+	stm r8,{r0-r7}
+	
+	; X2 = X3' = t2^2 - W1 - W2
+	add r0,sp,#64
+	ldm r0,{r0-r7}
+	bl P256_sqrmod
+	add r8,sp,#32
+	stm r8,{r0-r7}
+	add r1,sp,#32
+	ldr r2,[sp,#160]
+	bl P256_submod
+	add r8,sp,#32
+	stm r8,{r0-r7}
+	add r1,sp,#32
+	ldr r2,[sp,#160]
+	adds r2,#64
+	bl P256_submod
+	ldr r8,[sp,#160]
+	add r8,#64
+	stm r8,{r0-r7}
+	
+	; Y2 = Y3' = t2 * (W1 - X3') - A1
+	ldr r1,[sp,#160]
+	add r2,r1,#64
+	bl P256_submod
+	add r8,sp,#32
+	stm r8,{r0-r7}
+	add r1,sp,#64
+	add r2,sp,#32
+	bl P256_mulmod
+	add r8,sp,#32
+	stm r8,{r0-r7}
+	add r1,sp,#32
+	mov r2,sp
+	bl P256_submod
+	ldr r8,[sp,#160]
+	add r8,#96
+	stm r8,{r0-r7}
+	
+	; X1 = X3
+	add r0,sp,#96
+	ldm r0,{r0-r7}
+	ldr r8,[sp,#160]
+	stm r8,{r0-r7}
+	
+	add sp,#160
+	frame address sp,8
+	pop {r0,pc}
+	endp
+
+; Co-Z addition with update (XYCZ-ADDU), https://eprint.iacr.org/2011/338.pdf
+; The points P = (X1,Y1) at *r0 and Q = (X2,Y2) at *r0+64 share the same Z coordinate (integers are in Montgomery form).
+; They are replaced by P+Q and P, which also share the same (new) Z coordinate.
+; in: *r0
+; out: r0 is preserved
+; clobbers all other registers
+P256_xycz_addu proc
+	push {r0,lr}
+	frame push {lr}
+	frame address sp,8
+	sub sp,#128
+	frame address sp,136
+	
+	; C = (X1 - X2)^2
+	mov r1,r0
+	add r2,r0,#64
+	bl P256_submod
+	bl P256_sqrmod
+	stm sp,{r0-r7}
+	
+	; X2 = W2 = X2 * C
+	ldr r1,[sp,#128]
+	adds r1,#64
+	mov r2,sp
+	bl P256_mulmod
+	ldr r8,[sp,#128]
+	add r8,#64
+	stm r8,{r0-r7}
+	
+	; t1 = W1 = X1 * C
+	ldr r1,[sp,#128]
+	mov r2,sp
+	bl P256_mulmod
+	add r8,sp,#32
+	stm r8,{r0-r7}
+	
+	; t2 = A1 = Y1 * (W1 - W2)
+	add r1,sp,#32
+	ldr r2,[sp,#128]
+	adds r2,#64
+	bl P256_submod
+	add r8,sp,#64
+	stm r8,{r0-r7}
+	ldr r1,[sp,#128]
+	adds r1,#32
+	add r2,sp,#64
+	bl P256_mulmod
+	add r8,sp,#64
+	stm r8,{r0-r7}
+	
+	; t0 = Y1 - Y2
+	ldr r1,[sp,#128]
+	adds r1,#32
+	add r2,r1,#64
+	bl P256_submod
+	stm sp,{r0-r7}
+	
+	; X1 = X3 = t0^2 - W1 - W2
+	bl P256_sqrmod
+	add r8,sp,#96
+	stm r8,{r0-r7}
+	add r1,sp,#96
+	add r2,sp,#32
+	bl P256_submod
+	add r8,sp,#96
+	stm r8,{r0-r7}
+	add r1,sp,#96
+	ldr r2,[sp,#128]
+	adds r2,#64
+	bl P256_submod
+	ldr r8,[sp,#128]
+	stm r8,{r0-r7}
+	
+	; Y1 = Y3 = t0 * (W1 - X3) - A1
+	add r1,sp,#32
+	ldr r2,[sp,#128]
+	bl P256_submod
+	add r8,sp,#96
+	stm r8,{r0-r7}
+	mov r1,sp
+	add r2,sp,#96
+	bl P256_mulmod
+	add r8,sp,#96
+	stm r8,{r0-r7}
+	add r1,sp,#96
+	add r2,sp,#64
+	bl P256_submod
+	ldr r8,[sp,#128]
+	add r8,#32
+	stm r8,{r0-r7}
+	
+	; (X2,Y2) = (W1,A1)
+	add r0,sp,#32
+	ldm r0,{r0-r7}
+	ldr r8,[sp,#128]
+	add r8,#64
+	stm r8!,{r0-r7}
+	add r0,sp,#64
+	ldm r0,{r0-r7}
+	stm r8,{r0-r7}
+	
+	add sp,#128
+	frame address sp,8
+	pop {r0,pc}
+	endp
+
+; Initializes the state of the x-only co-Z Montgomery ladder
+; *r0 = state, consisting of R0 = (X0,Y0), R1 = (X1,Y1), x and g, 8 words each, in Montgomery form
+; in: x, the x coordinate of the input point P (must be < p)
+; out: g = x^3 - 3x + b, R0 = P' and R1 = 2P' sharing the same Z coordinate, where P' = (x*g, g^2) lies on
+; the curve y^2 = x^3 - 3g^2*x + b*g^3, which is isomorphic to P-256 if g is a square and to its quadratic twist otherwise
+P256_xycz_ladder_init proc
+	export P256_xycz_ladder_init
+	push {r0,r4-r11,lr}
 	frame push {r4-r11,lr}
-	frame address sp,44
-	sub sp,#32
-	frame address sp,76
-	
-	mov r0,sp
-	bl P256_to_montgomery
-	ldm sp,{r0-r7}
+	frame address sp,40
 	
+	; g = x(x^2 - 3) + b
+	adds r0,#128
+	ldm r0,{r0-r7}
 	bl P256_sqrmod
 	push {r0-r7}
-	
+	frame address sp,72
 	mov r1,sp
 	adr r2,three_mont
 	bl P256_submod
 	stm sp,{r0-r7}
-	frame address sp,108
-	
-	add r1,sp,#32
+	ldr r1,[sp,#32]
+	adds r1,#128
 	mov r2,sp
 	bl P256_mulmod
 	stm sp,{r0-r7}
-	
 	mov r1,sp
 	adr r2,b_mont
 	bl P256_addmod
-	stm sp,{r0-r7}
+	ldr r8,[sp,#32]
+	add r8,#160
+	stm r8,{r0-r7}
 	
-	mov r8,#1
-	bl P256_modinv_sqrt
-	add r8,sp,#32
+	; Y0 = g^2
+	bl P256_sqrmod
+	ldr r8,[sp,#32]
+	add r8,#32
 	stm r8,{r0-r7}
 	
+	; t0 = Y0^2
 	bl P256_sqrmod
+	stm sp,{r0-r7}
 	
-	pop {r8-r11}
-	frame address sp,92
-	eors r8,r0
-	ittt eq
-	eorseq r9,r1
-	eorseq r10,r2
-	eorseq r11,r3
-	pop {r8-r11}
-	frame address sp,76
-	itttt eq
-	eorseq r8,r4
-	eorseq r9,r5
-	eorseq r10,r6
-	eorseq r11,r7
-	it ne
-	movne r0,#0
-	bne %f1
+	; X0 = x * g
+	ldr r1,[sp,#32]
+	add r2,r1,#160
+	adds r1,#128
+	bl P256_mulmod
+	ldr r8,[sp,#32]
+	stm r8,{r0-r7}
 	
-	mov r0,sp
+	; Now double (X0,Y0,1) and keep the input point with the same Z coordinate (XYCZ-IDBL)
+	
+	; X1 = S = 4 * X0 * t0
+	ldr r1,[sp,#32]
+	mov r2,sp
+	bl P256_mulmod
+	bl P256_times2
+	bl P256_times2
+	ldr r8,[sp,#32]
+	add r8,#64
+	stm r8,{r0-r7}
+	
+	; Y1 = L = 8 * t0^2
+	ldm sp,{r0-r7}
+	bl P256_sqrmod
+	bl P256_times2
+	bl P256_times2
+	bl P256_times2
+	ldr r8,[sp,#32]
+	add r8,#96
+	stm r8,{r0-r7}
+	
+	; M = 3 * X0^2 - 3g^2 = 3 * (X0 - g) * (X0 + g)
+	ldr r1,[sp,#32]
+	add r2,r1,#160
+	bl P256_submod
+	push {r0-r7}
+	frame address sp,104
+	ldr r1,[sp,#64]
+	add r2,r1,#160
+	bl P256_addmod
+	add r8,sp,#32
+	stm r8,{r0-r7}
 	mov r1,sp
-	bl P256_from_montgomery
+	add r2,sp,#32
+	bl P256_mulmod
+	stm sp,{r0-r7}
+	bl P256_times2
+	add r8,sp,#32
+	stm r8,{r0-r7}
+	mov r1,sp
+	add r2,sp,#32
+	bl P256_addmod
+	stm sp,{r0-r7}
 	
-	ldr r3,[sp]
-	ldrd r0,r1,[sp,#32]
-	and r2,r3,#1
-	eors r2,r1
+	; t1 = X(2P') = M^2 - 2S
+	bl P256_sqrmod
+	add r8,sp,#32
+	stm r8,{r0-r7}
+	ldr r0,[sp,#64]
+	adds r0,#64
+	ldm r0,{r0-r7}
+	bl P256_times2
+	ldr r8,[sp,#64]
+	stm r8,{r0-r7}
+	add r1,sp,#32
+	ldr r2,[sp,#64]
+	bl P256_submod
+	add r8,sp,#32
+	stm r8,{r0-r7}
+	
+	; Y(2P') = M * (S - X(2P')) - L
+	ldr r1,[sp,#64]
+	adds r1,#64
+	add r2,sp,#32
+	bl P256_submod
+	ldr r8,[sp,#64]
+	stm r8,{r0-r7}
 	mov r1,sp
-	adr r3,P256_p
-	bl P256_negate_mod_m_if
-	movs r0,#1
-1
-	add sp,#32+8
+	ldr r2,[sp,#64]
+	bl P256_mulmod
+	ldr r8,[sp,#64]
+	stm r8,{r0-r7}
+	ldr r1,[sp,#64]
+	add r2,r1,#96
+	bl P256_submod
+	stm sp,{r0-r7}
+	
+	; R0 = (S,L) = P' and R1 = 2P'
+	ldr r8,[sp,#64]
+	add r9,r8,#64
+	ldm r9,{r0-r7}
+	stm r8!,{r0-r7}
+	add r9,#32
+	ldm r9,{r0-r7}
+	stm r8!,{r0-r7}
+	add r0,sp,#32
+	ldm r0,{r0-r7}
+	stm r8!,{r0-r7}
+	ldm sp,{r0-r7}
+	stm r8,{r0-r7}
+	
+	add sp,#68
 	frame address sp,36
 	pop {r4-r11,pc}
+	endp
+
+; Performs one step of the x-only co-Z Montgomery ladder, https://eprint.iacr.org/2011/338.pdf
+; *r0 = state (see P256_xycz_ladder_init)
+; r1 = 1 if R0 and R1 should first be swapped, else 0
+; Afterwards, R1 = R0 + R1 and R0 = 2 * R0, sharing the same Z coordinate
+P256_xycz_ladder_step proc
+	export P256_xycz_ladder_step
+	push {r4-r11,lr}
+	frame push {r4-r11,lr}
+	
+	bl P256_xycz_cswap
+	bl P256_xycz_addc
+	bl P256_xycz_addu
 	
+	pop {r4-r11,pc}
 	endp
-#endif
 
-#if include_p256_basemult || include_p256_varmult
-; *r0 = output affine montgomery x
-; *r1 = output affine montgomery y
-; *r2 = input jacobian montgomery
-P256_jacobian_to_affine proc
-	export P256_jacobian_to_affine
-	push {r0,r1,r2,r4-r11,lr}
+; Performs the last step of the x-only co-Z Montgomery ladder and calculates the affine x coordinate of the result
+; *r0 = output x, in Montgomery form
+; *r1 = state (see P256_xycz_ladder_init), which is destroyed
+; r2 = 1 if R0 and R1 should first be swapped, else 0
+; r3 = the least significant bit of the scalar
+; out: r0 = 1 if x was the x coordinate of a point on P-256, else 0
+P256_xycz_ladder_final proc
+	export P256_xycz_ladder_final
+	push {r0,r1,r3,r4-r11,lr}
 	frame push {r4-r11,lr}
 	frame address sp,48
+	sub sp,#64
+	frame address sp,112
 	
-	adds r2,#64
-	ldm r2,{r0-r7}
-	mov r8,#0
-	bl P256_modinv_sqrt
-	push {r0-r7}
-	frame address sp,80
+	mov r0,r1
+	mov r1,r2
+	bl P256_xycz_cswap
+	
+	; Now (X0,Y0) = A = R_b and (X1,Y1) = B = R_(1-b), where b is the last bit of the scalar
 	
+	; (X0,Y0) = A + B, (X1,Y1) = A - B = +-P'
+	bl P256_xycz_addc
+	
+	; Since X1 = x(P') * Z^2, the final Z coordinate after the next addition, Z * (X0 - X1), satisfies
+	; Z_final^2 = X1 * (X0 - X1)^2 / x(P') = t0 / (x * g), where t0 = X1 * (X0 - X1)^2
+	mov r1,r0
+	add r2,r0,#64
+	bl P256_submod
 	bl P256_sqrmod
-	push {r0-r7}
-	frame address sp,112
+	stm sp,{r0-r7}
+	ldr r1,[sp,#68]
+	adds r1,#64
+	mov r2,sp
+	bl P256_mulmod
+	stm sp,{r0-r7}
+	
+	; (X0,Y0) = 2A, (X1,Y1) = A + B
+	ldr r0,[sp,#68]
+	bl P256_xycz_addu
+	
+	; The result is 2A if b = 0, otherwise A + B, so set X0 = b ? X1 : X0
+	ldr r8,[sp,#68]
+	ldr r9,[sp,#72]
+	rsbs r9,r9,#0
+	add r10,r8,#64
+	movs r11,#2
+0
+	ldm r8,{r0-r3}
+	ldm r10!,{r4-r7}
+	eors r4,r0
+	eors r5,r1
+	eors r6,r2
+	eors r7,r3
+	ands r4,r9
+	ands r5,r9
+	ands r6,r9
+	ands r7,r9
+	eors r0,r4
+	eors r1,r5
+	eors r2,r6
+	eors r3,r7
+	stm r8!,{r0-r3}
+	subs r11,#1
+	bne %b0
 	
+	; t1 = w = g * t0^2
+	ldm sp,{r0-r7}
+	bl P256_sqrmod
+	add r8,sp,#32
+	stm r8,{r0-r7}
 	add r1,sp,#32
-	mov r2,sp
+	ldr r2,[sp,#68]
+	adds r2,#160
 	bl P256_mulmod
 	add r8,sp,#32
 	stm r8,{r0-r7}
 	
-	mov r1,sp
-	ldr r2,[sp,#72]
-	bl P256_mulmod
-	ldr r8,[sp,#64]
+	; Y0 = w^((p-3)/2), which is 1/w if w is a square, otherwise -1/w (or 0 if w = 0)
+	mov r8,#2
+	bl P256_modinv_sqrt
+	bl P256_sqrmod
+	ldr r8,[sp,#68]
+	add r8,#32
 	stm r8,{r0-r7}
 	
-	ldr r2,[sp,#72]
-	add r1,sp,#32
-	adds r2,r2,#32
+	; Assuming w is a square, x(scalar*P') / g = X0 / (Z_final^2 * g) = X0 * x / t0 = X0 * x * g * t0 / w
+	ldr r1,[sp,#68]
+	add r2,r1,#128
 	bl P256_mulmod
 	ldr r8,[sp,#68]
 	stm r8,{r0-r7}
+	ldr r1,[sp,#68]
+	add r2,r1,#160
+	bl P256_mulmod
+	ldr r8,[sp,#68]
+	stm r8,{r0-r7}
+	ldr r1,[sp,#68]
+	mov r2,sp
+	bl P256_mulmod
+	ldr r8,[sp,#68]
+	stm r8,{r0-r7}
+	ldr r1,[sp,#68]
+	add r2,r1,#32
+	bl P256_mulmod
+	ldr r8,[sp,#64]
+	stm r8,{r0-r7}
+	
+	; Check that w * w^((p-3)/2) = w^((p-1)/2) = 1, i.e. that w (and therefore g) is a non-zero square
+	ldr r1,[sp,#68]
+	adds r1,#32
+	add r2,sp,#32
+	bl P256_mulmod
+	subs r0,#1
+	orrs r0,r1
+	orrs r0,r2
+	adds r3,#1
+	orrs r0,r3
+	adds r4,#1
+	orrs r0,r4
+	adds r5,#1
+	orrs r0,r5
+	adds r6,#2
+	orrs r0,r6
+	orrs r0,r7
+	clz r0,r0
+	lsrs r0,r0,#5
 	
 	add sp,#76
 	frame address sp,36
-	
 	pop {r4-r11,pc}
 	endp
 #endif
-	
+
+#if place_hot_code_in_ram
+	area |.ramfunc|, code, readonly
+	align 4
+#endif
+
 #if include_p256_mult
 ; Doubles the point in Jacobian form (integers are in Montgomery form)
 ; *r0 = out, *r1 = in
 P256_double_j proc
 	export P256_double_j
+#if p256_enable_stats
+	ldr r2,=p256_op_counts
+	ldr r3,[r2,#16] ; double_j
+	adds r3,#1
+	str r3,[r2,#16]
+#endif
 	push {r0,r1,r4-r11,lr}
 	frame push {r4-r11,lr}
 	frame address sp,44
@@ -2765,6 +4043,9 @@ P256_double_j proc
 	
 	pop {r4-r11,pc}
 	endp
+#if p256_enable_stats
+	ltorg
+#endif
 
 ; sets the jacobian *r0 point to *r1
 ; if r2=1, then Y will be negated
@@ -2823,6 +4104,12 @@ P256_add_sub_j proc
 	push {r0-r11,lr}
 	frame push {r4-r11,lr}
 	frame address sp,52
+#if p256_enable_stats
+	ldr r4,=p256_op_counts
+	ldr r5,[r4,#20] ; add_sub_j
+	adds r5,#1
+	str r5,[r4,#20]
+#endif
 	
 	;ldr r4,[r0,#64]
 	;cbnz r4,%f2
@@ -3086,6 +4373,13 @@ P256_add_sub_j proc
 	
 	pop {r4-r11,pc}
 	endp
+#if p256_enable_stats
+	ltorg
+#endif
+#endif
+
+#if place_hot_code_in_ram
+	area |.text|, code, readonly
 #endif
 
 #if include_p256_verify
@@ -3205,7 +4499,7 @@ P256_verify_last_step proc
 	endp
 #endif
 
-#if include_p256_basemult || include_p256_varmult || include_p256_decompress_point
+#if include_p256_basemult || include_p256_varmult || include_p256_xycz_ladder || include_p256_point_decompression || include_p256_safegcd_mod_p
 ; in: *r0 = output location, *r1 = input, *r2 = 0/1, *r3 = m
 ; if r2 = 0, then *r0 is set to *r1
 ; if r2 = 1, then *r0 is set to m - *r1
@@ -3235,7 +4529,7 @@ P256_negate_mod_m_if proc
 	endp
 #endif
 
-#if include_p256_basemult || include_p256_varmult
+#if include_p256_basemult || include_p256_varmult || include_p256_xycz_ladder || include_p256_safegcd_mod_p
 P256_negate_mod_n_if proc
 	export P256_negate_mod_n_if
 	ldr r3,=P256_order
@@ -3249,5 +4543,316 @@ P256_negate_mod_p_if proc
 	endp
 #endif
 
+#if include_p256_sha256
+; SHA-256, used by p256_verify_init/update/final and p256_sign_deterministic
+
+	align 4
+P256_sha256_k
+	dcd 0x428a2f98
+	dcd 0x71374491
+	dcd 0xb5c0fbcf
+	dcd 0xe9b5dba5
+	dcd 0x3956c25b
+	dcd 0x59f111f1
+	dcd 0x923f82a4
+	dcd 0xab1c5ed5
+	dcd 0xd807aa98
+	dcd 0x12835b01
+	dcd 0x243185be
+	dcd 0x550c7dc3
+	dcd 0x72be5d74
+	dcd 0x80deb1fe
+	dcd 0x9bdc06a7
+	dcd 0xc19bf174
+	dcd 0xe49b69c1
+	dcd 0xefbe4786
+	dcd 0x0fc19dc6
+	dcd 0x240ca1cc
+	dcd 0x2de92c6f
+	dcd 0x4a7484aa
+	dcd 0x5cb0a9dc
+	dcd 0x76f988da
+	dcd 0x983e5152
+	dcd 0xa831c66d
+	dcd 0xb00327c8
+	dcd 0xbf597fc7
+	dcd 0xc6e00bf3
+	dcd 0xd5a79147
+	dcd 0x06ca6351
+	dcd 0x14292967
+	dcd 0x27b70a85
+	dcd 0x2e1b2138
+	dcd 0x4d2c6dfc
+	dcd 0x53380d13
+	dcd 0x650a7354
+	dcd 0x766a0abb
+	dcd 0x81c2c92e
+	dcd 0x92722c85
+	dcd 0xa2bfe8a1
+	dcd 0xa81a664b
+	dcd 0xc24b8b70
+	dcd 0xc76c51a3
+	dcd 0xd192e819
+	dcd 0xd6990624
+	dcd 0xf40e3585
+	dcd 0x106aa070
+	dcd 0x19a4c116
+	dcd 0x1e376c08
+	dcd 0x2748774c
+	dcd 0x34b0bcb5
+	dcd 0x391c0cb3
+	dcd 0x4ed8aa4a
+	dcd 0x5b9cca4f
+	dcd 0x682e6ff3
+	dcd 0x748f82ee
+	dcd 0x78a5636f
+	dcd 0x84c87814
+	dcd 0x8cc70208
+	dcd 0x90befffa
+	dcd 0xa4506ceb
+	dcd 0xbef9a3f7
+	dcd 0xc67178f2
+
+; Processes a number of 64-byte blocks (big endian message words) and updates the hash state.
+; The message schedule W[0..63] is first expanded on the stack, then the 64 rounds are performed,
+; 8 at a time with the roles of the working variables a-h rotated between r4-r11 instead of moving them.
+; in: *r0 = state (8 words), *r1 = blocks (4-byte aligned), r2 = number of blocks (> 0)
+; out: *r0
+P256_sha256_compress proc
+	export P256_sha256_compress
+	push {r0-r2,r4-r11,lr}
+	frame push {r4-r11,lr}
+	frame address sp,48
+	sub sp,#256
+	frame address sp,304
+	; stack: W[0..63], state, blocks, number of blocks left
+0
+	; W[0..15] = the big endian words of the block
+	ldr r1,[sp,#260]
+	mov r12,sp
+	movs r2,#16
+1
+	ldr r0,[r1],#4
+	rev r0,r0
+	str r0,[r12],#4
+	subs r2,#1
+	bne %b1
+	str r1,[sp,#260]
+	
+	; W[i] = s1(W[i-2]) + W[i-7] + s0(W[i-15]) + W[i-16] for i = 16..63
+	add r1,sp,#256
+2
+	ldr r2,[r12,#-64]
+	ldr r3,[r12,#-28]
+	add r2,r3
+	ldr r3,[r12,#-60]
+	eor lr,r3,r3,ror #11
+	lsrs r3,#3
+	eor r3,r3,lr,ror #7 ; s0 = ror(x,7) ^ ror(x,18) ^ (x >> 3)
+	add r2,r3
+	ldr r3,[r12,#-8]
+	eor lr,r3,r3,ror #2
+	lsrs r3,#10
+	eor r3,r3,lr,ror #17 ; s1 = ror(x,17) ^ ror(x,19) ^ (x >> 10)
+	add r2,r3
+	str r2,[r12],#4
+	cmp r12,r1
+	bne %b2
+	
+	ldr r0,[sp,#256]
+	ldm r0,{r4-r11}
+	adr lr,P256_sha256_k
+	mov r12,sp
+	eor r3,r5,r6 ; b ^ c, used by Maj in the first round
+3
+	; round with a-h = r4,r5,r6,r7,r8,r9,r10,r11
+	ldr r0,[r12],#4
+	ldr r1,[lr],#4
+	add r11,r0
+	add r11,r1
+	eor r0,r8,r8,ror #5
+	eor r0,r0,r8,ror #19
+	add r11,r11,r0,ror #6 ; S1 = ror(e,6) ^ ror(e,11) ^ ror(e,25)
+	eor r0,r9,r10
+	and r0,r8
+	eor r0,r10 ; Ch = (e & f) ^ (~e & g)
+	add r11,r0
+	add r7,r11
+	eor r0,r4,r4,ror #11
+	eor r0,r0,r4,ror #20
+	add r11,r11,r0,ror #2 ; S0 = ror(a,2) ^ ror(a,13) ^ ror(a,22)
+	eor r2,r4,r5
+	and r0,r2,r3
+	eor r0,r5 ; Maj = ((a ^ b) & (b ^ c)) ^ b
+	add r11,r0
+	; round with a-h = r11,r4,r5,r6,r7,r8,r9,r10
+	ldr r0,[r12],#4
+	ldr r1,[lr],#4
+	add r10,r0
+	add r10,r1
+	eor r0,r7,r7,ror #5
+	eor r0,r0,r7,ror #19
+	add r10,r10,r0,ror #6 ; S1 = ror(e,6) ^ ror(e,11) ^ ror(e,25)
+	eor r0,r8,r9
+	and r0,r7
+	eor r0,r9 ; Ch = (e & f) ^ (~e & g)
+	add r10,r0
+	add r6,r10
+	eor r0,r11,r11,ror #11
+	eor r0,r0,r11,ror #20
+	add r10,r10,r0,ror #2 ; S0 = ror(a,2) ^ ror(a,13) ^ ror(a,22)
+	eor r3,r11,r4
+	and r0,r3,r2
+	eor r0,r4 ; Maj = ((a ^ b) & (b ^ c)) ^ b
+	add r10,r0
+	; round with a-h = r10,r11,r4,r5,r6,r7,r8,r9
+	ldr r0,[r12],#4
+	ldr r1,[lr],#4
+	add r9,r0
+	add r9,r1
+	eor r0,r6,r6,ror #5
+	eor r0,r0,r6,ror #19
+	add r9,r9,r0,ror #6 ; S1 = ror(e,6) ^ ror(e,11) ^ ror(e,25)
+	eor r0,r7,r8
+	and r0,r6
+	eor r0,r8 ; Ch = (e & f) ^ (~e & g)
+	add r9,r0
+	add r5,r9
+	eor r0,r10,r10,ror #11
+	eor r0,r0,r10,ror #20
+	add r9,r9,r0,ror #2 ; S0 = ror(a,2) ^ ror(a,13) ^ ror(a,22)
+	eor r2,r10,r11
+	and r0,r2,r3
+	eor r0,r11 ; Maj = ((a ^ b) & (b ^ c)) ^ b
+	add r9,r0
+	; round with a-h = r9,r10,r11,r4,r5,r6,r7,r8
+	ldr r0,[r12],#4
+	ldr r1,[lr],#4
+	add r8,r0
+	add r8,r1
+	eor r0,r5,r5,ror #5
+	eor r0,r0,r5,ror #19
+	add r8,r8,r0,ror #6 ; S1 = ror(e,6) ^ ror(e,11) ^ ror(e,25)
+	eor r0,r6,r7
+	and r0,r5
+	eor r0,r7 ; Ch = (e & f) ^ (~e & g)
+	add r8,r0
+	add r4,r8
+	eor r0,r9,r9,ror #11
+	eor r0,r0,r9,ror #20
+	add r8,r8,r0,ror #2 ; S0 = ror(a,2) ^ ror(a,13) ^ ror(a,22)
+	eor r3,r9,r10
+	and r0,r3,r2
+	eor r0,r10 ; Maj = ((a ^ b) & (b ^ c)) ^ b
+	add r8,r0
+	; round with a-h = r8,r9,r10,r11,r4,r5,r6,r7
+	ldr r0,[r12],#4
+	ldr r1,[lr],#4
+	add r7,r0
+	add r7,r1
+	eor r0,r4,r4,ror #5
+	eor r0,r0,r4,ror #19
+	add r7,r7,r0,ror #6 ; S1 = ror(e,6) ^ ror(e,11) ^ ror(e,25)
+	eor r0,r5,r6
+	and r0,r4
+	eor r0,r6 ; Ch = (e & f) ^ (~e & g)
+	add r7,r0
+	add r11,r7
+	eor r0,r8,r8,ror #11
+	eor r0,r0,r8,ror #20
+	add r7,r7,r0,ror #2 ; S0 = ror(a,2) ^ ror(a,13) ^ ror(a,22)
+	eor r2,r8,r9
+	and r0,r2,r3
+	eor r0,r9 ; Maj = ((a ^ b) & (b ^ c)) ^ b
+	add r7,r0
+	; round with a-h = r7,r8,r9,r10,r11,r4,r5,r6
+	ldr r0,[r12],#4
+	ldr r1,[lr],#4
+	add r6,r0
+	add r6,r1
+	eor r0,r11,r11,ror #5
+	eor r0,r0,r11,ror #19
+	add r6,r6,r0,ror #6 ; S1 = ror(e,6) ^ ror(e,11) ^ ror(e,25)
+	eor r0,r4,r5
+	and r0,r11
+	eor r0,r5 ; Ch = (e & f) ^ (~e & g)
+	add r6,r0
+	add r10,r6
+	eor r0,r7,r7,ror #11
+	eor r0,r0,r7,ror #20
+	add r6,r6,r0,ror #2 ; S0 = ror(a,2) ^ ror(a,13) ^ ror(a,22)
+	eor r3,r7,r8
+	and r0,r3,r2
+	eor r0,r8 ; Maj = ((a ^ b) & (b ^ c)) ^ b
+	add r6,r0
+	; round with a-h = r6,r7,r8,r9,r10,r11,r4,r5
+	ldr r0,[r12],#4
+	ldr r1,[lr],#4
+	add r5,r0
+	add r5,r1
+	eor r0,r10,r10,ror #5
+	eor r0,r0,r10,ror #19
+	add r5,r5,r0,ror #6 ; S1 = ror(e,6) ^ ror(e,11) ^ ror(e,25)
+	eor r0,r11,r4
+	and r0,r10
+	eor r0,r4 ; Ch = (e & f) ^ (~e & g)
+	add r5,r0
+	add r9,r5
+	eor r0,r6,r6,ror #11
+	eor r0,r0,r6,ror #20
+	add r5,r5,r0,ror #2 ; S0 = ror(a,2) ^ ror(a,13) ^ ror(a,22)
+	eor r2,r6,r7
+	and r0,r2,r3
+	eor r0,r7 ; Maj = ((a ^ b) & (b ^ c)) ^ b
+	add r5,r0
+	; round with a-h = r5,r6,r7,r8,r9,r10,r11,r4
+	ldr r0,[r12],#4
+	ldr r1,[lr],#4
+	add r4,r0
+	add r4,r1
+	eor r0,r9,r9,ror #5
+	eor r0,r0,r9,ror #19
+	add r4,r4,r0,ror #6 ; S1 = ror(e,6) ^ ror(e,11) ^ ror(e,25)
+	eor r0,r10,r11
+	and r0,r9
+	eor r0,r11 ; Ch = (e & f) ^ (~e & g)
+	add r4,r0
+	add r8,r4
+	eor r0,r5,r5,ror #11
+	eor r0,r0,r5,ror #20
+	add r4,r4,r0,ror #2 ; S0 = ror(a,2) ^ ror(a,13) ^ ror(a,22)
+	eor r3,r5,r6
+	and r0,r3,r2
+	eor r0,r6 ; Maj = ((a ^ b) & (b ^ c)) ^ b
+	add r4,r0
+	add r0,sp,#256
+	cmp r12,r0
+	bne %b3
+	
+	ldr r0,[sp,#256]
+	ldm r0,{r1-r3,r12}
+	add r1,r4
+	add r2,r5
+	add r3,r6
+	add r12,r7
+	stm r0!,{r1-r3,r12}
+	ldm r0,{r1-r3,r12}
+	add r1,r8
+	add r2,r9
+	add r3,r10
+	add r12,r11
+	stm r0,{r1-r3,r12}
+	
+	ldr r2,[sp,#264]
+	subs r2,#1
+	str r2,[sp,#264]
+	bne %b0
+	
+	add sp,#268
+	frame address sp,36
+	pop {r4-r11,pc}
+	endp
+#endif
+
 	align 4
 	end
@@ -34,18 +34,64 @@
 #define include_p256_verify 1
 #endif
 
+#ifndef include_p256_verify_batch
+#define include_p256_verify_batch include_p256_verify
+#endif
+
+#ifndef include_p256_verify_precomp
+#define include_p256_verify_precomp include_p256_verify
+#endif
+
+/**
+ * Includes p256_verify_init, p256_verify_update and p256_verify_final, which hash the message with the bundled
+ * SHA-256 implementation while it is streamed in, so that a large message never needs to be in RAM at once.
+ */
+#ifndef include_p256_verify_stream
+#define include_p256_verify_stream include_p256_verify
+#endif
+
 #ifndef include_p256_sign
 #define include_p256_sign 1
 #endif
 
+#ifndef include_p256_sign_batch
+#define include_p256_sign_batch include_p256_sign
+#endif
+
+#ifndef include_p256_sign_deterministic
+#define include_p256_sign_deterministic include_p256_sign
+#endif
+
+/**
+ * Includes p256_sign_fast, which creates signatures from a library managed pool of precomputed signing states
+ * that is refilled when the device is idle. The pool uses sign_pool_size * 64 bytes of static RAM.
+ */
+#ifndef include_p256_sign_pool
+#define include_p256_sign_pool 0
+#endif
+
 #ifndef include_p256_keygen
 #define include_p256_keygen 1
 #endif
 
+#ifndef include_p256_keygen_batch
+#define include_p256_keygen_batch include_p256_keygen
+#endif
+
 #ifndef include_p256_ecdh
 #define include_p256_ecdh 1
 #endif
 
+/**
+ * Includes p256_fixed_point_precompute and p256_ecdh_with_precomp, which speed up repeated ECDH against the same
+ * static peer public key by running the comb method used for the fixed base point against a table that is
+ * computed once for the peer's key. The table layout is given by fast_basemult_comb_teeth and
+ * fast_basemult_comb_tables, also when use_fast_p256_basemult is disabled.
+ */
+#ifndef include_p256_ecdh_precomp
+#define include_p256_ecdh_precomp include_p256_ecdh
+#endif
+
 #ifndef include_p256_raw_scalarmult_generic
 #define include_p256_raw_scalarmult_generic 1
 #endif
@@ -54,6 +100,10 @@
 #define include_p256_raw_scalarmult_base 1
 #endif
 
+#ifndef include_p256_raw_scalarmult_base_batch
+#define include_p256_raw_scalarmult_base_batch include_p256_raw_scalarmult_base
+#endif
+
 #ifndef include_p256_to_octet_string_uncompressed
 #define include_p256_to_octet_string_uncompressed 1
 #endif
@@ -74,6 +124,49 @@
 #define include_p256_decode_point 1
 #endif
 
+/**
+ * Includes p256_signature_from_der and p256_signature_to_der, which convert between the DER encoded
+ * "SEQUENCE { INTEGER r, INTEGER s }" signature format used by X.509, TLS and most crypto libraries and the r and s
+ * word arrays, as well as p256_public_key_to_spki, which creates the DER encoded P-256 SubjectPublicKeyInfo structure
+ * for a public key. If also include_p256_decode_point or include_p256_decompress_point is enabled, the corresponding
+ * parser p256_public_key_from_spki is included. The parsers work directly on the input buffer without any intermediate
+ * copies.
+ */
+#ifndef include_p256_der
+#define include_p256_der 1
+#endif
+
+/**
+ * Includes the resumable variants of keygen, ECDH and verify (p256_keygen_start, p256_ecdh_start, p256_verify_start,
+ * p256_op_step and the corresponding finish functions), for the algorithms that are included. These split up the
+ * scalar multiplication into small steps, so that a cooperative scheduler or a BLE stack can run other tasks in between.
+ * The resumable ECDH always uses the generic variable base scalar multiplication, even if use_coz_ladder_ecdh is enabled.
+ */
+#ifndef include_p256_resumable
+#define include_p256_resumable 0
+#endif
+
+/**
+ * Exports the internal field arithmetic functions P256_mul_mod_p, P256_sqr_mod_p and P256_mod_p_inv even if no
+ * included algorithm needs them (and the safegcd field inversions P256_mod_p_inv_safegcd and
+ * P256_mod_p_inv_safegcd_vartime when use_safegcd_mod_p_inv is enabled), so that arm_bench_main.c can measure
+ * them. Only enable this for benchmarking.
+ */
+#ifndef include_p256_bench_internals
+#define include_p256_bench_internals 0
+#endif
+
+/**
+ * Counts the executed field operations (multiplications, squarings, additions, subtractions), point doublings and
+ * additions, and inversions, and makes them available through p256_get_stats() and p256_reset_stats().
+ * The counters are also split up per phase (table creation, main loop, conversion to affine coordinates) of the
+ * scalar multiplications and signature verification. This adds a few instructions to every counted operation, so
+ * only enable this for measurements. When disabled, no code is added.
+ */
+#ifndef p256_enable_stats
+#define p256_enable_stats 0
+#endif
+
 
 // Target settings
 
@@ -100,9 +193,58 @@
  * have any data cache.
  *
  * 1 is suited for Cortex-A processors.
+ *
+ * The default is 0 when compiling for 32-bit ARM, otherwise 1 (e.g. when the portable C backend is used on x86-64).
  */
 #ifndef has_d_cache
+#ifdef __arm__
 #define has_d_cache 0
+#else
+#define has_d_cache 1
+#endif
+#endif
+
+/**
+ * Enables the use of Helium (M-Profile Vector Extension) instructions, available on e.g. Cortex-M55 and Cortex-M85.
+ * If enabled, P256_select_point (used when has_d_cache is enabled) is vectorized, and use_mve_mulmod can be enabled.
+ * The default is to use the __ARM_FEATURE_MVE macro that the compiler defines (integer MVE is sufficient).
+ */
+#ifndef has_mve
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#define has_mve 1
+#else
+#define has_mve 0
+#endif
+#endif
+
+/**
+ * Only used by the portable C backend (p256-cortex-m4-portable.c).
+ * If enabled, the field arithmetic and the table lookups are done by the AArch64 assembler code in
+ * p256-aarch64-asm.S, which must then be compiled and linked as well.
+ * The default is to use the __aarch64__ macro that the compiler defines.
+ */
+#ifndef use_aarch64_asm
+#ifdef __aarch64__
+#define use_aarch64_asm 1
+#else
+#define use_aarch64_asm 0
+#endif
+#endif
+
+/**
+ * Only used by the portable C backend (p256-cortex-m4-portable.c).
+ * If enabled, the field arithmetic is done by the ARMv6-M assembler code in p256-armv6m-asm.S, which must then be
+ * compiled and linked as well. Use this together with the portable C backend on CPUs without the umull/umaal
+ * instructions that p256-cortex-m4-asm-gcc.S relies on, such as Cortex-M0, Cortex-M0+ and Cortex-M23.
+ * The default is to enable it when the compiler targets an M-profile CPU with only the Thumb-1 instruction set
+ * (__ARM_ARCH_PROFILE == 'M' and __ARM_ARCH_ISA_THUMB == 1, i.e. ARMv6-M and ARMv8-M Baseline).
+ */
+#ifndef use_armv6m_asm
+#if defined(__ARM_ARCH_PROFILE) && defined(__ARM_ARCH_ISA_THUMB) && __ARM_ARCH_PROFILE == 'M' && __ARM_ARCH_ISA_THUMB == 1
+#define use_armv6m_asm 1
+#else
+#define use_armv6m_asm 0
+#endif
 #endif
 
 // Optimization settings
@@ -116,6 +258,43 @@
 #define use_fast_p256_basemult 1
 #endif
 
+/**
+ * Only used when use_fast_p256_basemult is enabled.
+ * The layout of the precomputed comb table of the base point. The scalar is split into fast_basemult_comb_teeth
+ * parts of 256 / fast_basemult_comb_teeth bits each, and fast_basemult_comb_tables tables of
+ * 2^(fast_basemult_comb_teeth-1) points (64 bytes each) are used. A scalar multiplication by the base point then
+ * performs 256 / fast_basemult_comb_teeth / fast_basemult_comb_tables - 1 point doublings and
+ * 256 / fast_basemult_comb_teeth - 1 point additions. Some examples:
+ *
+ * teeth | tables | table size | doublings | additions
+ * ----- | ------ | ---------- | --------- | ---------
+ *     4 |      1 |     512 B  |        63 |        63
+ *     4 |      2 |       1 kB |        31 |        63 (default)
+ *     4 |      8 |       4 kB |         7 |        63
+ *     4 |     64 |      32 kB |         0 |        63
+ *     8 |      1 |       8 kB |        31 |        31
+ *     8 |      4 |      32 kB |         7 |        31
+ *
+ * fast_basemult_comb_teeth must be 4 or 8, and fast_basemult_comb_tables must be a power of two that is at most
+ * 256 / fast_basemult_comb_teeth. The table for the default layout is included in p256-cortex-m4.c. For any
+ * other layout, generate the table with "node tablegen.js comb <teeth> <tables> > p256-cortex-m4-comb-table.h"
+ * and place it next to p256-cortex-m4.c or in the include path (the header is not part of the repository, and the
+ * compilation stops with an #error naming this command if it is missing).
+ * When has_d_cache is enabled, every table lookup reads the whole table of 2^(fast_basemult_comb_teeth-1) points,
+ * which makes 8 teeth considerably slower in that case.
+ * When has_d_cache is disabled, the lookups use secret indices, so they must not be made from memory that can be
+ * observed, such as external memory mapped flash. Tables of at most 1 kB are copied to the stack on every call for
+ * that reason. Larger tables would need too much stack, so they instead require use_persistent_basepoint_table_ram
+ * (a permanent RAM copy of the table size, made by p256_init) or place_tables_in_ram.
+ */
+#ifndef fast_basemult_comb_teeth
+#define fast_basemult_comb_teeth 4
+#endif
+
+#ifndef fast_basemult_comb_tables
+#define fast_basemult_comb_tables 2
+#endif
+
 /**
  * Enable this to save some code space, at expense of performance.
  * When disabled, a specialized field squaring routine will be used rather
@@ -125,10 +304,204 @@
 #define use_mul_for_sqr 0
 #endif
 
+/**
+ * Only used when has_mve is enabled.
+ * If enabled, the field multiplication computes the 512-bit product with vmlaldav dot products over 16-bit limbs
+ * instead of umull/umaal, and the field squaring re-uses the multiplication routine (as with use_mul_for_sqr).
+ * This executes more instructions than the scalar code (see README.md), so only enable it after measuring that it
+ * is faster on the actual CPU.
+ */
+#ifndef use_mve_mulmod
+#define use_mve_mulmod 0
+#endif
+
+/**
+ * If enabled, field inversions (the conversions from jacobian to affine coordinates at the end of keygen, sign,
+ * ECDH and the other scalar multiplications) use the same safegcd (Bernstein-Yang) algorithm as the inversion
+ * mod n in sign, instead of an exponentiation by p-2 (Fermat's little theorem). Inversions of public values (in
+ * p256_verify_precompute_public_key, p256_fixed_point_precompute and use_affine_verify_pk_table) also stop as soon
+ * as the algorithm has converged. The square roots used by point decompression still need the exponentiation.
+ */
+#ifndef use_safegcd_mod_p_inv
+#define use_safegcd_mod_p_inv 1
+#endif
+
+/**
+ * If enabled, verification uses a larger precomputed table of the base point: 64 points (4 kB) instead of
+ * 8 points (512 bytes). This reduces the number of point additions for the base point part of the verification
+ * by around a third, at the expense of using more code space.
+ */
+#ifndef use_large_verify_basepoint_table
+#define use_large_verify_basepoint_table 0
+#endif
+
+/**
+ * If enabled, p256_verify converts the public key table (P, 3P, ..., 15P) to affine coordinates using a single
+ * field inversion (Montgomery's simultaneous inversion trick), so that every public key addition in the main loop
+ * is a mixed addition, which is around 28% cheaper than a jacobian addition. This costs one field inversion and
+ * 46 field multiplications per signature. With the variable time safegcd inversion (use_safegcd_mod_p_inv), that is
+ * an estimated 42k cycles against around 54k saved by the around 47 mixed additions, so the setting is enabled
+ * together with use_safegcd_mod_p_inv. With the exponentiation, the conversion costs around 60k cycles, which is
+ * more than it saves. p256_verify uses 224 more bytes of stack.
+ */
+#ifndef use_affine_verify_pk_table
+#define use_affine_verify_pk_table use_safegcd_mod_p_inv
+#endif
+
+/**
+ * The maximum number of signatures p256_verify_batch combines into one multi-scalar multiplication.
+ * A larger value shares the point doublings between more signatures and therefore improves performance,
+ * but every signature in a chunk needs around 2 kB of stack.
+ */
+#ifndef verify_batch_chunk_size
+#define verify_batch_chunk_size 4
+#endif
+
+/**
+ * The window size, in bits, of the public key table in struct PublicKeyPrecomp, used by p256_verify_precomp.
+ * The table contains 2^(verify_precomp_window_bits-1) points of 64 bytes each, i.e. 1 kB for the default value 5.
+ * Each increment doubles the size of the table and the number of point additions needed to create it (all points
+ * share one field inversion, which dominates the creation time for the smaller values), but makes p256_verify_precomp
+ * faster. Creating the table needs 2^verify_precomp_window_bits field elements (32 bytes each) of temporary stack.
+ * Valid values are 4 to 7.
+ */
+#ifndef verify_precomp_window_bits
+#define verify_precomp_window_bits 5
+#endif
+
+/**
+ * The maximum number of scalar multiplications p256_keygen_batch, p256_scalarmult_base_batch and
+ * p256_sign_step1_batch process together, sharing one field inversion (and one inversion mod n for
+ * p256_sign_step1_batch). Every scalar multiplication in a chunk needs 132 bytes of stack.
+ */
+#ifndef basemult_batch_chunk_size
+#define basemult_batch_chunk_size 8
+#endif
+
+/**
+ * Only used when include_p256_sign_pool is enabled.
+ * The number of precomputed signing states (64 bytes each) that the library keeps in a static buffer, see
+ * p256_sign_fast.
+ */
+#ifndef sign_pool_size
+#define sign_pool_size 4
+#endif
+
+/**
+ * If enabled, the ECDH functions use an x-only co-Z Montgomery ladder instead of the generic variable base
+ * scalar multiplication routine. The ladder only needs the x coordinate of the other party's public key, so
+ * p256_ecdh_calc_shared_secret_compressed does not need to decompress the public key (which costs a square root),
+ * and it uses less stack since no precomputed table is needed. It is slower than the generic routine when
+ * the public key is given uncompressed.
+ */
+#ifndef use_coz_ladder_ecdh
+#define use_coz_ladder_ecdh 0
+#endif
+
+/**
+ * Only used when has_d_cache is disabled and use_fast_p256_basemult is enabled.
+ * By default, keygen and sign copy the 1 kB base point table from flash to a stack buffer on every call, so that
+ * the secret dependent table lookups are made from RAM (external memory mapped flash can easily be intercepted).
+ * If enabled, the table is instead copied only once, by p256_init, to a static RAM buffer. This removes the copy
+ * and 1 kB of stack usage from every call, at the expense of 1 kB of permanently used RAM.
+ * Comb tables larger than 1 kB (see fast_basemult_comb_tables) are never copied to the stack, so such a table
+ * requires either this setting or place_tables_in_ram. The RAM buffer then has the size of the table.
+ */
+#ifndef use_persistent_basepoint_table_ram
+#define use_persistent_basepoint_table_ram 0
+#endif
+
+/**
+ * Only used by the Cortex-M4 assembler code.
+ * If enabled, the routines that dominate the running time (P256_mulmod, P256_sqrmod, P256_addmod, P256_submod,
+ * P256_times2, the inversion chain, P256_double_j and P256_add_sub_j, around 2.6 kB) are placed in the section
+ * ".ramfunc" instead of ".text", so that they can execute from SRAM. This helps on MCUs without an instruction
+ * cache or flash accelerator, where every instruction fetch from flash stalls on wait states at high clock frequencies.
+ * The linker script must place ".ramfunc" in RAM with a load address in flash, and the startup code must copy it
+ * before the library is used (see README.md). Calls between flash and RAM go through linker generated veneers.
+ */
+#ifndef place_hot_code_in_ram
+#define place_hot_code_in_ram 0
+#endif
+
+/**
+ * If enabled, the precomputed base point tables used by verify, keygen and sign are placed in the section
+ * ".ramdata" instead of read-only data, with the same linker script and startup code requirements as
+ * place_hot_code_in_ram. Since the comb table of keygen and sign then already lies in RAM, it is never copied to
+ * the stack, and use_persistent_basepoint_table_ram has no effect.
+ */
+#ifndef place_tables_in_ram
+#define place_tables_in_ram 0
+#endif
+
 // Derived settings (do not modify)
-#define include_p256_basemult (include_p256_keygen || include_p256_sign || include_p256_raw_scalarmult_base)
+#define include_p256_basemult_batch (include_p256_keygen_batch || include_p256_raw_scalarmult_base_batch)
+#define include_p256_basemult (include_p256_keygen || include_p256_sign || include_p256_raw_scalarmult_base || include_p256_basemult_batch)
 #define include_fast_p256_basemult (use_fast_p256_basemult && include_p256_basemult)
-#define include_p256_varmult (include_p256_ecdh || include_p256_raw_scalarmult_generic)
-#define include_p256_mult (include_p256_verify || include_p256_basemult || include_p256_varmult)
+#define include_p256_basepoint_table_ram (use_persistent_basepoint_table_ram && include_fast_p256_basemult && !has_d_cache && !place_tables_in_ram)
+#define include_p256_comb (include_fast_p256_basemult || include_p256_ecdh_precomp)
+#define fast_basemult_comb_table_bytes (fast_basemult_comb_tables << (fast_basemult_comb_teeth + 5))
+#define include_p256_xycz_ladder (include_p256_ecdh && use_coz_ladder_ecdh)
+#define include_p256_varmult ((include_p256_ecdh && (!use_coz_ladder_ecdh || include_p256_resumable)) || include_p256_raw_scalarmult_generic)
+#define include_p256_varmult_blocking ((include_p256_ecdh && !use_coz_ladder_ecdh) || include_p256_raw_scalarmult_generic)
+#define include_p256_mult (include_p256_verify || include_p256_basemult || include_p256_varmult || include_p256_xycz_ladder)
+#define include_p256_point_decompression (include_p256_decompress_point || include_p256_verify_batch || (include_p256_ecdh && !use_coz_ladder_ecdh))
+#define verify_basepoint_window_bits (use_large_verify_basepoint_table ? 7 : 4)
+#define include_p256_batch_inversion (include_p256_basemult_batch || include_p256_sign_batch || (include_p256_verify && use_affine_verify_pk_table) || include_p256_verify_precomp || include_p256_ecdh_precomp)
+#define include_p256_sha256 (include_p256_sign_deterministic || include_p256_verify_stream)
+#define include_p256_jacobian_to_affine (include_p256_basemult || include_p256_varmult || include_p256_ecdh_precomp)
+#define include_p256_safegcd_mod_p (use_safegcd_mod_p_inv && (include_p256_jacobian_to_affine || include_p256_batch_inversion))
+
+#if include_p256_verify_batch && !include_p256_verify
+#error "include_p256_verify_batch requires include_p256_verify"
+#endif
+
+#if include_p256_verify_stream && !include_p256_verify
+#error "include_p256_verify_stream requires include_p256_verify"
+#endif
+
+#if include_p256_sign_batch && !include_p256_sign
+#error "include_p256_sign_batch requires include_p256_sign"
+#endif
+
+#if include_p256_sign_deterministic && !include_p256_sign
+#error "include_p256_sign_deterministic requires include_p256_sign"
+#endif
+
+#if include_p256_sign_pool && !include_p256_sign
+#error "include_p256_sign_pool requires include_p256_sign"
+#endif
+
+#if include_p256_sign_pool && sign_pool_size < 1
+#error "sign_pool_size must be at least 1"
+#endif
+
+#if include_p256_verify_precomp && !include_p256_verify
+#error "include_p256_verify_precomp requires include_p256_verify"
+#endif
+
+#if include_p256_ecdh_precomp && !include_p256_ecdh
+#error "include_p256_ecdh_precomp requires include_p256_ecdh"
+#endif
+
+#if include_p256_bench_internals && !include_p256_mult
+#error "include_p256_bench_internals requires an algorithm that uses point multiplication"
+#endif
+
+#if fast_basemult_comb_teeth != 4 && fast_basemult_comb_teeth != 8
+#error "fast_basemult_comb_teeth must be 4 or 8"
+#endif
+
+#if fast_basemult_comb_tables < 1 || fast_basemult_comb_tables > 256 / fast_basemult_comb_teeth || (fast_basemult_comb_tables & (fast_basemult_comb_tables - 1)) != 0
+#error "fast_basemult_comb_tables must be a power of two that is at most 256 / fast_basemult_comb_teeth"
+#endif
+
+#if include_fast_p256_basemult && !has_d_cache && fast_basemult_comb_table_bytes > 1024 && !use_persistent_basepoint_table_ram && !place_tables_in_ram
+#error "Comb tables larger than 1 kB are not copied to the stack, enable use_persistent_basepoint_table_ram or place_tables_in_ram so that the lookups are made from RAM"
+#endif
+
+#if verify_precomp_window_bits < 4 || verify_precomp_window_bits > 7
+#error "verify_precomp_window_bits must be between 4 and 7"
+#endif
 
 #endif
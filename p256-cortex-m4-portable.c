@@ -0,0 +1,1066 @@
+/*
+ * Copyright (c) 2017-2021 Emil Lenngren
+ * Copyright (c) 2021 Shortcut Labs AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Portable C implementation of the internal primitives that p256-cortex-m4.c builds upon.
+//
+// This file is a drop-in replacement for p256-cortex-m4-asm-gcc.S / p256-cortex-m4-asm-keil.s
+// and is intended for hosts where the Thumb-2 assembler code cannot be used, such as x86-64 Linux servers.
+// It exports exactly the same symbols with exactly the same semantics, so that p256-cortex-m4.c builds unchanged.
+//
+// Field elements are internally stored as four 64-bit limbs. A 64x64 -> 128 bit multiplication is done using
+// unsigned __int128 when the compiler supports it, otherwise it is emulated using 32-bit multiplications.
+// On AArch64, the field arithmetic mod p and P256_select_point are instead implemented in p256-aarch64-asm.S
+// (see use_aarch64_asm in p256-cortex-m4-config.h), which must then be linked as well.
+// Likewise, on ARMv6-M (e.g. Cortex-M0+), the field arithmetic mod p is implemented in p256-armv6m-asm.S
+// (see use_armv6m_asm).
+//
+// When secret data is processed, the implementation runs in constant time,
+// and no conditional branches or memory accesses depend on secret data
+// (assuming the compiler does not turn the mask-based code below into branches).
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "p256-cortex-m4-config.h"
+
+#if p256_enable_stats
+#include "p256-cortex-m4.h"
+
+// Defined in p256-cortex-m4.c
+extern struct P256OpCounts p256_op_counts;
+#define STATS_COUNT(op) (p256_op_counts.op++)
+#else
+#define STATS_COUNT(op)
+#endif
+
+struct FGInteger {
+    int flip_sign;
+    uint32_t signed_value[9];
+};
+
+struct XYInteger {
+    int flip_sign;
+    uint32_t value[8];
+};
+
+uint32_t P256_order[9] = {0xFC632551, 0xF3B9CAC2, 0xA7179E84, 0xBCE6FAAD, 0xFFFFFFFF, 0xFFFFFFFF, 0, 0xFFFFFFFF, 0};
+static const uint32_t P256_p[9] = {0xffffffff, 0xffffffff, 0xffffffff, 0, 0, 0, 1, 0xffffffff, 0};
+
+// p = 2^256 - 2^224 + 2^192 + 2^96 - 1
+static const uint64_t P256_p64[4] = {0xffffffffffffffff, 0x00000000ffffffff, 0, 0xffffffff00000001};
+static const uint64_t P256_n64[4] = {0xf3b9cac2fc632551, 0xbce6faada7179e84, 0xffffffffffffffff, 0xffffffff00000000};
+
+// -m^-1 mod 2^64 for the two moduli (p is -1 mod 2^64)
+#define P256_p64_inv 1
+#define P256_n64_inv 0xccd1c8aaee00bc4f
+
+// (2^256)^2 mod p and (2^256)^2 mod n
+static const uint64_t R2_mod_p64[4] = {0x0000000000000003, 0xfffffffbffffffff, 0xfffffffffffffffe, 0x00000004fffffffd};
+static const uint64_t R2_mod_n64[4] = {0x83244c95be79eea2, 0x4699799c49bd6fa6, 0x2845b2392b6bec59, 0x66e12d94f3d95620};
+
+// 1, 3 and b in Montgomery form
+static const uint64_t one_mont64[4] = {0x0000000000000001, 0xffffffff00000000, 0xffffffffffffffff, 0x00000000fffffffe};
+static const uint64_t three_mont64[4] = {0x0000000000000003, 0xfffffffd00000000, 0xffffffffffffffff, 0x00000002fffffffc};
+static const uint64_t b_mont64[4] = {0xd89cdf6229c4bddf, 0xacf005cd78843090, 0xe5a220abf7212ed6, 0xdc30061d04874834};
+
+static inline uint64_t mul_64x64(uint64_t a, uint64_t b, uint64_t* hi) {
+    #ifdef __SIZEOF_INT128__
+    unsigned __int128 t = (unsigned __int128)a * b;
+    *hi = (uint64_t)(t >> 64);
+    return (uint64_t)t;
+    #else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32, b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+    uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+    *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    return (mid << 32) | (uint32_t)ll;
+    #endif
+}
+
+// Returns the low 64 bits of a * b + c + d and stores the high 64 bits in *hi (the result always fits in 128 bits)
+static inline uint64_t mul_add_add(uint64_t a, uint64_t b, uint64_t c, uint64_t d, uint64_t* hi) {
+    uint64_t h;
+    uint64_t l = mul_64x64(a, b, &h);
+    l += c;
+    h += l < c;
+    l += d;
+    h += l < d;
+    *hi = h;
+    return l;
+}
+
+static inline uint64_t add_carry(uint64_t a, uint64_t b, uint64_t* carry) {
+    uint64_t t = a + *carry;
+    uint64_t c = t < a;
+    t += b;
+    *carry = c + (t < b);
+    return t;
+}
+
+static inline uint64_t sub_borrow(uint64_t a, uint64_t b, uint64_t* borrow) {
+    uint64_t t = a - b;
+    uint64_t c = a < b;
+    uint64_t res = t - *borrow;
+    *borrow = c | (t < *borrow);
+    return res;
+}
+
+static void load64(uint64_t r[4], const uint32_t a[8]) {
+    for (int i = 0; i < 4; i++) {
+        r[i] = a[2 * i] | ((uint64_t)a[2 * i + 1] << 32);
+    }
+}
+
+static void store64(uint32_t r[8], const uint64_t a[4]) {
+    for (int i = 0; i < 4; i++) {
+        r[2 * i] = (uint32_t)a[i];
+        r[2 * i + 1] = (uint32_t)(a[i] >> 32);
+    }
+}
+
+// r = (hi:a) - m if that is non-negative, else a, where hi is 0 or 1 (the 257th bit of the value)
+static void reduce_once(uint64_t r[4], const uint64_t a[4], uint64_t hi, const uint64_t m[4]) {
+    uint64_t t[4], borrow = 0;
+    for (int i = 0; i < 4; i++) {
+        t[i] = sub_borrow(a[i], m[i], &borrow);
+    }
+    borrow = sub_borrow(hi, 0, &borrow) >> 63; // 1 if the subtraction went negative
+    uint64_t mask = 0 - borrow;
+    for (int i = 0; i < 4; i++) {
+        r[i] = (a[i] & mask) | (t[i] & ~mask);
+    }
+}
+
+// Montgomery multiplication, R = 2^256
+// If a, b < m, computes a*b*R^-1 mod m, fully reduced
+static void mont_mul(uint64_t r[4], const uint64_t a[4], const uint64_t b[4], const uint64_t m[4], uint64_t m_inv) {
+    uint64_t t[6] = {0};
+    for (int i = 0; i < 4; i++) {
+        uint64_t c = 0, carry;
+        for (int j = 0; j < 4; j++) {
+            t[j] = mul_add_add(a[j], b[i], t[j], c, &c);
+        }
+        carry = 0;
+        t[4] = add_carry(t[4], c, &carry);
+        t[5] = carry;
+
+        uint64_t u = t[0] * m_inv;
+        mul_add_add(u, m[0], t[0], 0, &c);
+        for (int j = 1; j < 4; j++) {
+            t[j - 1] = mul_add_add(u, m[j], t[j], c, &c);
+        }
+        carry = 0;
+        t[3] = add_carry(t[4], c, &carry);
+        t[4] = t[5] + carry;
+    }
+    reduce_once(r, t, t[4], m);
+}
+
+// Field arithmetics for the prime field where p = 2^256 - 2^224 + 2^192 + 2^96 - 1
+// Multiplication and Squaring use Montgomery Modular Multiplication where R = 2^256
+
+#if use_aarch64_asm
+
+// Implemented in p256-aarch64-asm.S
+void P256_aarch64_mulmod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]);
+void P256_aarch64_sqrmod(uint64_t r[4], const uint64_t a[4]);
+void P256_aarch64_addmod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]);
+void P256_aarch64_submod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]);
+
+static void P256_mulmod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]) {
+    STATS_COUNT(mulmod);
+    P256_aarch64_mulmod(r, a, b);
+}
+
+static void P256_sqrmod(uint64_t r[4], const uint64_t a[4]) {
+    STATS_COUNT(sqrmod);
+    P256_aarch64_sqrmod(r, a);
+}
+
+static void P256_addmod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]) {
+    STATS_COUNT(addmod);
+    P256_aarch64_addmod(r, a, b);
+}
+
+static void P256_submod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]) {
+    STATS_COUNT(submod);
+    P256_aarch64_submod(r, a, b);
+}
+
+#elif use_armv6m_asm
+
+// Implemented in p256-armv6m-asm.S
+void P256_armv6m_mulmod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]);
+void P256_armv6m_sqrmod(uint64_t r[4], const uint64_t a[4]);
+void P256_armv6m_addmod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]);
+void P256_armv6m_submod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]);
+
+static void P256_mulmod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]) {
+    STATS_COUNT(mulmod);
+    P256_armv6m_mulmod(r, a, b);
+}
+
+static void P256_sqrmod(uint64_t r[4], const uint64_t a[4]) {
+    STATS_COUNT(sqrmod);
+    P256_armv6m_sqrmod(r, a);
+}
+
+static void P256_addmod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]) {
+    STATS_COUNT(addmod);
+    P256_armv6m_addmod(r, a, b);
+}
+
+static void P256_submod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]) {
+    STATS_COUNT(submod);
+    P256_armv6m_submod(r, a, b);
+}
+
+#else
+
+static void P256_mulmod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]) {
+    STATS_COUNT(mulmod);
+    mont_mul(r, a, b, P256_p64, P256_p64_inv);
+}
+
+static void P256_sqrmod(uint64_t r[4], const uint64_t a[4]) {
+    STATS_COUNT(sqrmod);
+    mont_mul(r, a, a, P256_p64, P256_p64_inv);
+}
+
+// Computes A + B mod p, assumes A, B < p
+static void P256_addmod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]) {
+    STATS_COUNT(addmod);
+    uint64_t t[4], carry = 0;
+    for (int i = 0; i < 4; i++) {
+        t[i] = add_carry(a[i], b[i], &carry);
+    }
+    reduce_once(r, t, carry, P256_p64);
+}
+
+// Computes A - B mod p, assumes A, B < p
+static void P256_submod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]) {
+    STATS_COUNT(submod);
+    uint64_t t[4], borrow = 0, carry = 0;
+    for (int i = 0; i < 4; i++) {
+        t[i] = sub_borrow(a[i], b[i], &borrow);
+    }
+    uint64_t mask = 0 - borrow;
+    for (int i = 0; i < 4; i++) {
+        r[i] = add_carry(t[i], P256_p64[i] & mask, &carry);
+    }
+}
+
+#endif
+
+static void P256_times2(uint64_t r[4], const uint64_t a[4]) {
+    P256_addmod(r, a, a);
+}
+
+static void P256_div2(uint64_t r[4], const uint64_t a[4]) {
+    uint64_t t[4], carry = 0;
+    uint64_t mask = 0 - (a[0] & 1);
+    for (int i = 0; i < 4; i++) {
+        t[i] = add_carry(a[i], P256_p64[i] & mask, &carry);
+    }
+    for (int i = 0; i < 3; i++) {
+        r[i] = (t[i] >> 1) | (t[i + 1] << 63);
+    }
+    r[3] = (t[3] >> 1) | (carry << 63);
+}
+
+static void P256_sqrmod_many(uint64_t r[4], const uint64_t a[4], int count) {
+    memcpy(r, a, 32);
+    while (count-- > 0) {
+        P256_sqrmod(r, r);
+    }
+}
+
+static void P256_sqrmod_many_and_mulmod(uint64_t r[4], int count, const uint64_t b[4]) {
+    P256_sqrmod_many(r, r, count);
+    P256_mulmod(r, r, b);
+}
+
+#define MODINV 0
+#define SQRT 1
+#define POW_P_MINUS_3_DIV_4 2
+
+// for modinv, call input a, then if a = A * R % p, then it calculates A^-1 * R % p = (a/R)^-1 * R % p = R^2 / a % p
+// for sqrt, call input a, then if a = A * R % p, then it calculates sqrt(A) * R % p
+// for pow_p_minus_3_div_4, call input a, then if a = A * R % p, then it calculates A^((p-3)/4) * R % p
+// Uses the same addition chains as the assembler implementation.
+static void P256_modinv_sqrt(uint64_t r[4], const uint64_t a[4], int mode) {
+    STATS_COUNT(modinv_sqrt);
+    uint64_t a2_0[4], a4_2[4], a4_0[4], a8_0[4], a16_0[4], a32_0[4], t[4];
+
+    memcpy(a2_0, a, 32);
+    P256_sqrmod_many_and_mulmod(a2_0, 1, a);
+    P256_sqrmod_many(a4_2, a2_0, 2);
+    P256_mulmod(a4_0, a4_2, a2_0);
+    memcpy(a8_0, a4_0, 32);
+    P256_sqrmod_many_and_mulmod(a8_0, 8 - 4, a4_0);
+    memcpy(a16_0, a8_0, 32);
+    P256_sqrmod_many_and_mulmod(a16_0, 16 - 8, a8_0);
+    memcpy(a32_0, a16_0, 32);
+    P256_sqrmod_many_and_mulmod(a32_0, 32 - 16, a16_0);
+    memcpy(t, a32_0, 32);
+    P256_sqrmod_many_and_mulmod(t, 64 - 32, a);
+
+    if (mode == MODINV || mode == POW_P_MINUS_3_DIV_4) {
+        P256_sqrmod_many_and_mulmod(t, 192 - 64, a32_0);
+        P256_sqrmod_many_and_mulmod(t, 224 - 192, a32_0);
+        P256_sqrmod_many_and_mulmod(t, 240 - 224, a16_0);
+        P256_sqrmod_many_and_mulmod(t, 248 - 240, a8_0);
+        P256_sqrmod_many_and_mulmod(t, 252 - 248, a4_0);
+        if (mode == POW_P_MINUS_3_DIV_4) {
+            // t = A^((p-2) >> 4) and (p-3)/4 = 4 * ((p-2) >> 4) + 3
+            P256_sqrmod_many_and_mulmod(t, 1, a);
+            P256_sqrmod_many_and_mulmod(t, 1, a);
+            memcpy(r, t, 32);
+            return;
+        }
+        P256_sqrmod_many_and_mulmod(t, 256 - 252, a4_2);
+        P256_mulmod(r, t, a);
+    } else {
+        P256_sqrmod_many_and_mulmod(t, 160 - 64, a);
+        P256_sqrmod_many(r, t, 254 - 160);
+    }
+}
+
+static bool is_zero64(const uint64_t a[4]) {
+    return (a[0] | a[1] | a[2] | a[3]) == 0;
+}
+
+static bool equal64(const uint64_t a[4], const uint64_t b[4]) {
+    return ((a[0] ^ b[0]) | (a[1] ^ b[1]) | (a[2] ^ b[2]) | (a[3] ^ b[3])) == 0;
+}
+
+// Checks whether the input number is within [0,p-1]
+bool P256_check_range_p(const uint32_t a[8]) {
+    uint64_t t[4], borrow = 0;
+    load64(t, a);
+    for (int i = 0; i < 4; i++) {
+        sub_borrow(t[i], P256_p64[i], &borrow);
+    }
+    return borrow;
+}
+
+// Checks whether the input number is within [1,n-1]
+bool P256_check_range_n(const uint32_t a[8]) {
+    uint64_t t[4], borrow = 0;
+    load64(t, a);
+    for (int i = 0; i < 4; i++) {
+        sub_borrow(t[i], P256_n64[i], &borrow);
+    }
+    return !is_zero64(t) && borrow;
+}
+
+void P256_to_montgomery(uint32_t aR[8], const uint32_t a[8]) {
+    uint64_t t[4];
+    load64(t, a);
+    P256_mulmod(t, t, R2_mod_p64);
+    store64(aR, t);
+}
+
+void P256_from_montgomery(uint32_t a[8], const uint32_t aR[8]) {
+    static const uint64_t one[4] = {1, 0, 0, 0};
+    uint64_t t[4];
+    load64(t, aR);
+    P256_mulmod(t, t, one);
+    store64(a, t);
+}
+
+
+// Arithmetics for the group order n =
+// 0xffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632551
+
+// in: any 256-bit number, out: the number mod n
+static void load64_mod_n(uint64_t r[4], const uint32_t a[8]) {
+    load64(r, a);
+    reduce_once(r, r, 0, P256_n64);
+}
+
+// in: *in, out: *out, in < 2^256
+void P256_reduce_mod_n_32bytes(uint32_t out[8], const uint32_t in[8]) {
+    uint64_t t[4];
+    load64_mod_n(t, in);
+    store64(out, t);
+}
+
+// Adds two numbers mod n, both inputs can be any 256-bit numbers
+void P256_add_mod_n(uint32_t res[8], const uint32_t a[8], const uint32_t b[8]) {
+    uint64_t x[4], y[4], t[4], carry = 0;
+    load64_mod_n(x, a);
+    load64_mod_n(y, b);
+    for (int i = 0; i < 4; i++) {
+        t[i] = add_carry(x[i], y[i], &carry);
+    }
+    reduce_once(t, t, carry, P256_n64);
+    store64(res, t);
+}
+
+static void mul_mod_n64(uint64_t r[4], const uint64_t a[4], const uint64_t b[4]) {
+    mont_mul(r, a, b, P256_n64, P256_n64_inv);
+    mont_mul(r, r, R2_mod_n64, P256_n64, P256_n64_inv);
+}
+
+// Multiplies two numbers in the range [0,2^256-1] mod n
+void P256_mul_mod_n(uint32_t res[8], const uint32_t a[8], const uint32_t b[8]) {
+    uint64_t x[4], y[4];
+    load64_mod_n(x, a);
+    load64_mod_n(y, b);
+    mul_mod_n64(x, x, y);
+    store64(res, x);
+}
+
+// Computes a^-1 mod n as a^(n-2) mod n. Despite the name (inherited from the asm version), this runs in constant time.
+void P256_mod_n_inv_vartime(uint32_t res[8], const uint32_t a[8]) {
+    STATS_COUNT(inv_mod_n);
+    uint64_t base[4], acc[4] = {1, 0, 0, 0}, e[4], borrow = 0;
+    static const uint64_t two[4] = {2, 0, 0, 0};
+    load64_mod_n(base, a);
+    for (int i = 0; i < 4; i++) {
+        e[i] = sub_borrow(P256_n64[i], two[i], &borrow);
+    }
+    for (int i = 255; i >= 0; i--) {
+        mul_mod_n64(acc, acc, acc);
+        if ((e[i / 64] >> (i % 64)) & 1) {
+            mul_mod_n64(acc, acc, base);
+        }
+    }
+    store64(res, acc);
+}
+
+// See P256_mod_n_inv in p256-cortex-m4.c for how the following three functions are used.
+
+// Performs 31 iterations of divstep2 on the lowest 32 bits of f and g, see https://gcd.cr.yp.to/safegcd-20190413.pdf.
+// The resulting transition matrix [u, v, q, r] (scaled by 2^31) is stored in res_matrix.
+int P256_divsteps2_31(int delta, uint32_t f, uint32_t g, uint32_t res_matrix[4]) {
+    uint32_t u = 1, v = 0, q = 0, r = 1;
+    for (int i = 0; i < 31; i++) {
+        uint32_t mask = (uint32_t)((int32_t)((g << 31) & ~(uint32_t)(delta - 1)) >> 31);
+        uint32_t t;
+
+        delta = (int)(((uint32_t)delta ^ mask) - mask);
+
+        // if mask: (f, g) = (g, -f)
+        t = (f ^ g) & mask;
+        f ^= t;
+        g ^= t;
+        g = (g ^ mask) - mask;
+
+        t = (u ^ q) & mask;
+        u ^= t;
+        q ^= t;
+        q = (q ^ mask) - mask;
+
+        t = (v ^ r) & mask;
+        v ^= t;
+        r ^= t;
+        r = (r ^ mask) - mask;
+
+        uint32_t g0 = 0 - (g & 1);
+        delta++;
+        g = (g + (f & g0)) >> 1;
+        q += u & g0;
+        r += v & g0;
+        u += u;
+        v += v;
+    }
+    res_matrix[0] = u;
+    res_matrix[1] = v;
+    res_matrix[2] = q;
+    res_matrix[3] = r;
+    return delta;
+}
+
+// The matrix elements are in the range [-2^30, 2^31], so if negative, the top 2 bits are both 1s.
+static inline int64_t decode_matrix_element(uint32_t a) {
+    return (a >> 30) == 3 ? (int64_t)(int32_t)a : (int64_t)a;
+}
+
+// acc += a * v (mod 2^320), where v is a signed 288-bit two's complement value
+static void mul_add_320(uint32_t acc[10], int64_t a, const uint32_t v[9], uint32_t negate_v) {
+    uint32_t v_ext[10];
+    uint32_t a_ext[2] = {(uint32_t)(uint64_t)a, (uint32_t)((uint64_t)a >> 32)};
+    uint64_t borrow = negate_v & 1;
+    for (int i = 0; i < 9; i++) {
+        // conditionally negate: (v ^ mask) + 1
+        uint64_t t = (uint64_t)(v[i] ^ negate_v) + borrow;
+        v_ext[i] = (uint32_t)t;
+        borrow = t >> 32;
+    }
+    v_ext[9] = (uint32_t)((int32_t)v_ext[8] >> 31);
+
+    for (int i = 0; i < 2; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; i + j < 10; j++) {
+            uint64_t t = (uint64_t)a_ext[i] * v_ext[j] + acc[i + j] + carry;
+            acc[i + j] = (uint32_t)t;
+            carry = t >> 32;
+        }
+    }
+    // Higher sign extension words of a only affect bits >= 2^320 except through v * 0xffffffff...,
+    // which is handled by treating a_ext as a 320-bit sign extended value below.
+    if (a < 0) {
+        // a_ext words 2..9 are all 0xffffffff, so add (2^320 - 2^64) * v = -2^64 * v (mod 2^320)
+        uint64_t b = 0;
+        for (int j = 0; j + 2 < 10; j++) {
+            uint64_t t = (uint64_t)acc[j + 2] - v_ext[j] - b;
+            acc[j + 2] = (uint32_t)t;
+            b = (t >> 32) & 1;
+        }
+    }
+}
+
+// Calculates (a * f + b * g) / 2^31, which shall be an integer
+void P256_matrix_mul_fg_9(uint32_t a, uint32_t b, const struct FGInteger fg[2], struct FGInteger *res) {
+    uint32_t acc[10] = {0};
+    mul_add_320(acc, decode_matrix_element(a), fg[0].signed_value, (uint32_t)fg[0].flip_sign);
+    mul_add_320(acc, decode_matrix_element(b), fg[1].signed_value, (uint32_t)fg[1].flip_sign);
+    res->flip_sign = 0;
+    for (int i = 0; i < 9; i++) {
+        res->signed_value[i] = (acc[i] >> 31) | (acc[i + 1] << 1);
+    }
+}
+
+// Calculates a * x + b * y mod m, multiplied by an extra factor 2^-32 (a single Montgomery reduction step),
+// where m_inv32 = -m^-1 mod 2^32
+static void matrix_mul_mod_m(uint32_t a, uint32_t b, const struct XYInteger xy[2], struct XYInteger *res, const uint32_t m[9], uint32_t m_inv32, const uint64_t m64[4]) {
+    int64_t coeffs[2] = {decode_matrix_element(a), decode_matrix_element(b)};
+    uint32_t acc[10] = {0};
+    for (int k = 0; k < 2; k++) {
+        // Fold the signs of the coefficient and the value into the value, which is then in the range [0,m]
+        uint32_t negate = (uint32_t)xy[k].flip_sign ^ (uint32_t)(coeffs[k] >> 63);
+        uint64_t abs_coeff = (uint64_t)(coeffs[k] < 0 ? -coeffs[k] : coeffs[k]);
+        uint32_t v[8];
+        uint64_t borrow = 0;
+        for (int i = 0; i < 8; i++) {
+            uint64_t t = (uint64_t)m[i] - xy[k].value[i] - borrow;
+            v[i] = (xy[k].value[i] & ~negate) | ((uint32_t)t & negate);
+            borrow = (t >> 32) & 1;
+        }
+        uint64_t carry = 0;
+        for (int i = 0; i < 8; i++) {
+            uint64_t t = abs_coeff * v[i] + acc[i] + carry;
+            acc[i] = (uint32_t)t;
+            carry = t >> 32;
+        }
+        for (int i = 8; i < 10; i++) {
+            uint64_t t = (uint64_t)acc[i] + carry;
+            acc[i] = (uint32_t)t;
+            carry = t >> 32;
+        }
+    }
+
+    // Montgomery reduction by 2^32: (T + q * m) / 2^32, where q = T * (-m^-1) mod 2^32
+    uint32_t q = acc[0] * m_inv32;
+    uint64_t carry = 0;
+    for (int i = 0; i < 9; i++) {
+        uint64_t t = (uint64_t)q * m[i] + acc[i] + carry;
+        acc[i] = (uint32_t)t;
+        carry = t >> 32;
+    }
+    acc[9] += (uint32_t)carry;
+
+    // Now the value in acc[1..9] is less than 2^256 + m, so subtract m at most twice
+    uint64_t t64[4];
+    for (int i = 0; i < 4; i++) {
+        t64[i] = acc[1 + 2 * i] | ((uint64_t)acc[2 + 2 * i] << 32);
+    }
+    reduce_once(t64, t64, acc[9], m64);
+    reduce_once(t64, t64, 0, m64);
+    res->flip_sign = 0;
+    store64(res->value, t64);
+}
+
+void P256_matrix_mul_mod_n(uint32_t a, uint32_t b, const struct XYInteger xy[2], struct XYInteger *res) {
+    matrix_mul_mod_m(a, b, xy, res, P256_order, 0xee00bc4f, P256_n64);
+}
+
+void P256_matrix_mul_mod_p(uint32_t a, uint32_t b, const struct XYInteger xy[2], struct XYInteger *res) {
+    matrix_mul_mod_m(a, b, xy, res, P256_p, 1, P256_p64);
+}
+
+
+// Elliptic curve operations on the NIST curve P-256
+
+#if !use_aarch64_asm
+// Selects one of 8 values in constant time, without data-dependent memory accesses
+// (implemented using NEON in p256-aarch64-asm.S when use_aarch64_asm is enabled)
+void P256_select_point(uint32_t (*output)[8], uint32_t* table, uint32_t num_coordinates, uint32_t index) {
+    uint32_t words = num_coordinates * 8;
+    memset(output, 0, words * 4);
+    for (uint32_t i = 0; i < 8; i++) {
+        uint32_t mask = 0 - (((i ^ index) - 1) >> 31);
+        for (uint32_t j = 0; j < words; j++) {
+            ((uint32_t*)output)[j] |= table[i * words + j] & mask;
+        }
+    }
+}
+#endif
+
+// Checks if a point is on curve: y^2 - x(x^2 - 3) = b
+bool P256_point_is_on_curve(const uint32_t x_mont[8], const uint32_t y_mont[8]) {
+    uint64_t x[4], y[4], t[4];
+    load64(x, x_mont);
+    load64(y, y_mont);
+    P256_sqrmod(y, y);
+    P256_sqrmod(t, x);
+    P256_submod(t, t, three_mont64);
+    P256_mulmod(t, t, x);
+    P256_submod(t, y, t);
+    return equal64(t, b_mont64);
+}
+
+static void negate_mod_m_if(uint32_t out[8], const uint32_t in[8], uint32_t should_negate, const uint32_t m[8]) {
+    uint32_t mask = 0 - (should_negate & 1);
+    uint64_t borrow = 0;
+    for (int i = 0; i < 8; i++) {
+        uint64_t t = (uint64_t)m[i] - in[i] - borrow;
+        borrow = (t >> 32) & 1;
+        out[i] = (in[i] & ~mask) | ((uint32_t)t & mask);
+    }
+}
+
+void P256_negate_mod_p_if(uint32_t out[8], const uint32_t in[8], uint32_t should_negate) {
+    negate_mod_m_if(out, in, should_negate, P256_p);
+}
+
+void P256_negate_mod_n_if(uint32_t out[8], const uint32_t in[8], uint32_t should_negate) {
+    negate_mod_m_if(out, in, should_negate, P256_order);
+}
+
+// in: x (not in Montgomery form), parity bit for y
+// out: y (not in Montgomery form), returns false if x is not the x coordinate of a point on the curve
+bool P256_decompress_point(uint32_t y[8], const uint32_t x[8], uint32_t y_parity) {
+    uint32_t x_mont[8];
+    uint64_t t[4], a[4], s[4];
+    P256_to_montgomery(x_mont, x);
+    load64(t, x_mont);
+
+    // a = x^3 - 3x + b
+    P256_sqrmod(a, t);
+    P256_submod(a, a, three_mont64);
+    P256_mulmod(a, a, t);
+    P256_addmod(a, a, b_mont64);
+
+    P256_modinv_sqrt(s, a, SQRT);
+    P256_sqrmod(t, s);
+    if (!equal64(t, a)) {
+        return false;
+    }
+
+    uint32_t s32[8];
+    store64(s32, s);
+    P256_from_montgomery(y, s32);
+    P256_negate_mod_p_if(y, y, (y[0] & 1) ^ y_parity);
+    return true;
+}
+
+// Converts a Jacobian point (Montgomery form) to affine coordinates (Montgomery form)
+void P256_jacobian_to_affine(uint32_t affine_mont_x[8], uint32_t affine_mont_y[8], const uint32_t jacobian_mont[3][8]) {
+    uint64_t z_inv[4], z_inv2[4], t[4];
+    load64(t, jacobian_mont[2]);
+    P256_modinv_sqrt(z_inv, t, MODINV);
+    P256_sqrmod(z_inv2, z_inv);
+    P256_mulmod(z_inv, z_inv, z_inv2);
+    load64(t, jacobian_mont[0]);
+    P256_mulmod(t, t, z_inv2);
+    store64(affine_mont_x, t);
+    load64(t, jacobian_mont[1]);
+    P256_mulmod(t, t, z_inv);
+    store64(affine_mont_y, t);
+}
+
+// Doubles the point in Jacobian form (integers are in Montgomery form)
+// https://eprint.iacr.org/2014/130.pdf, algorithm 10
+void P256_double_j(uint32_t jacobian_point_out[3][8], const uint32_t jacobian_point_in[3][8]) {
+    STATS_COUNT(double_j);
+    uint64_t x[4], y[4], z[4], t1[4], t2[4], t3[4];
+    load64(x, jacobian_point_in[0]);
+    load64(y, jacobian_point_in[1]);
+    load64(z, jacobian_point_in[2]);
+
+    P256_sqrmod(t1, z);
+    P256_mulmod(z, y, z);
+    P256_addmod(t2, x, t1);
+    P256_submod(t1, x, t1);
+    P256_mulmod(t1, t1, t2);
+    P256_div2(t2, t1);
+    P256_addmod(t1, t1, t2);
+    P256_sqrmod(t2, t1);
+    P256_sqrmod(y, y);
+    P256_sqrmod(t3, y);
+    P256_mulmod(y, x, y);
+    P256_times2(x, y);
+    P256_submod(x, t2, x);
+    P256_submod(t2, y, x);
+    P256_mulmod(t1, t1, t2);
+    P256_submod(y, t1, t3);
+
+    store64(jacobian_point_out[0], x);
+    store64(jacobian_point_out[1], y);
+    store64(jacobian_point_out[2], z);
+}
+
+// Sets the jacobian point p1 to (-)p2, with Z = 1 if p2 is affine
+static void add_sub_helper(uint32_t p1[3][8], const uint32_t (*p2)[8], bool is_sub, bool p2_is_affine) {
+    memcpy(p1[0], p2[0], 32);
+    P256_negate_mod_p_if(p1[1], p2[1], is_sub);
+    if (p2_is_affine) {
+        store64(p1[2], one_mont64);
+    } else {
+        memcpy(p1[2], p2[2], 32);
+    }
+}
+
+// Adds or subtracts points in Jacobian form (integers are in Montgomery form)
+// The result is stored in jacobian_point1.
+//
+// This function assumes the second operand is not the point at infinity,
+// otherwise it handles all inputs.
+// The first operand is treated at the point at infinity as long as its Z coordinate is 0.
+void P256_add_sub_j(uint32_t jacobian_point1[3][8], const uint32_t (*point2)[8], bool is_sub, bool p2_is_affine) {
+    STATS_COUNT(add_sub_j);
+    uint64_t x2[4], y2[4], z2[4], x1[4], y1[4], z1[4];
+    uint64_t u1[4], u2[4], s1[4], s2[4], h[4], hh[4], hhh[4], r[4], v[4], t[4];
+
+    load64(z2, jacobian_point1[2]);
+    if (is_zero64(z2)) {
+        add_sub_helper(jacobian_point1, point2, is_sub, p2_is_affine);
+        return;
+    }
+    load64(x2, jacobian_point1[0]);
+    load64(y2, jacobian_point1[1]);
+    load64(x1, point2[0]);
+    load64(y1, point2[1]);
+
+    // https://www.hyperelliptic.org/EFD/g1p/auto-code/shortw/jacobian-3/addition/add-1998-cmo-2.op3
+    if (!p2_is_affine) {
+        load64(z1, point2[2]);
+        P256_sqrmod(t, z1);
+        P256_mulmod(u2, x2, t);
+        P256_mulmod(t, z1, t);
+        P256_mulmod(s2, y2, t);
+    } else {
+        memcpy(u2, x2, 32);
+        memcpy(s2, y2, 32);
+    }
+    P256_sqrmod(t, z2);
+    P256_mulmod(u1, x1, t);
+    P256_mulmod(t, z2, t);
+    P256_mulmod(s1, y1, t);
+    if (is_sub) {
+        static const uint64_t zero[4] = {0};
+        P256_submod(s1, zero, s1);
+    }
+
+    P256_submod(h, u2, u1);
+    P256_sqrmod(hh, h);
+    P256_mulmod(z2, z2, h);
+    if (!p2_is_affine) {
+        P256_mulmod(z2, z1, z2);
+    }
+    P256_mulmod(hhh, h, hh);
+    P256_submod(r, s2, s1);
+
+    if (is_zero64(hhh) && is_zero64(r)) {
+        // Points should be doubled since addition formula can't handle this case
+        add_sub_helper(jacobian_point1, point2, is_sub, p2_is_affine);
+        P256_double_j(jacobian_point1, (const uint32_t (*)[8])jacobian_point1);
+        return;
+    }
+
+    P256_mulmod(v, u1, hh);
+    P256_sqrmod(x2, r);
+    P256_submod(x2, x2, hhh);
+    P256_times2(t, v);
+    P256_submod(x2, x2, t);
+    P256_submod(t, v, x2);
+    P256_mulmod(t, r, t);
+    P256_mulmod(s1, s1, hhh);
+    P256_submod(y2, t, s1);
+
+    store64(jacobian_point1[0], x2);
+    store64(jacobian_point1[1], y2);
+    store64(jacobian_point1[2], z2);
+}
+
+// Determines whether r = x (mod n), where x is the affine x coordinate of the given Jacobian point
+// Checks r*Z^2 % p = X OR (r+n<p AND (r+n)*Z^2 % p = X), see the assembler implementation for a proof.
+bool P256_verify_last_step(const uint32_t r[8], const uint32_t jacobian_point[3][8]) {
+    uint64_t zz[4], x[4], t[4], rn[4], carry = 0;
+    uint32_t r_mont[8];
+
+    load64(zz, jacobian_point[2]);
+    P256_sqrmod(zz, zz);
+    if (is_zero64(zz)) {
+        return false;
+    }
+    load64(x, jacobian_point[0]);
+
+    P256_to_montgomery(r_mont, r);
+    load64(t, r_mont);
+    P256_mulmod(t, t, zz);
+    if (equal64(t, x)) {
+        return true;
+    }
+
+    load64(t, r);
+    for (int i = 0; i < 4; i++) {
+        rn[i] = add_carry(t[i], P256_n64[i], &carry);
+    }
+    uint32_t rn32[8];
+    store64(rn32, rn);
+    if (carry || !P256_check_range_p(rn32)) {
+        return false;
+    }
+    P256_to_montgomery(r_mont, rn32);
+    load64(t, r_mont);
+    P256_mulmod(t, t, zz);
+    return equal64(t, x);
+}
+
+void P256_mul_mod_p(uint32_t res[8], const uint32_t a[8], const uint32_t b[8]) {
+    uint64_t x[4], y[4], r[4];
+    load64(x, a); load64(y, b);
+    P256_mulmod(r, x, y);
+    store64(res, r);
+}
+
+void P256_sqr_mod_p(uint32_t res[8], const uint32_t a[8]) {
+    uint64_t x[4], r[4];
+    load64(x, a);
+    P256_sqrmod(r, x);
+    store64(res, r);
+}
+
+void P256_mod_p_inv(uint32_t res[8], const uint32_t a[8]) {
+    uint64_t x[4], r[4];
+    load64(x, a);
+    P256_modinv_sqrt(r, x, MODINV);
+    store64(res, r);
+}
+
+// x-only co-Z Montgomery ladder, see https://eprint.iacr.org/2011/338.pdf and P256_xycz_ladder_init in the assembler
+// implementation. The state consists of X0, Y0, X1, Y1, x, g (Montgomery form), where (X0, Y0) and (X1, Y1) share
+// the same Z coordinate.
+
+// (X1, Y1), (X2, Y2) = P + Q, P - Q, where (X1, Y1) = P and (X2, Y2) = Q
+static void xycz_addc(uint64_t x1[4], uint64_t y1[4], uint64_t x2[4], uint64_t y2[4]) {
+    uint64_t c[4], w1[4], w2[4], a1[4], u[4], v[4], t[4];
+    P256_submod(c, x1, x2);
+    P256_sqrmod(c, c);
+    P256_mulmod(w1, x1, c);
+    P256_mulmod(w2, x2, c);
+    P256_submod(t, w1, w2);
+    P256_mulmod(a1, y1, t);
+    P256_submod(u, y1, y2);
+    P256_addmod(v, y1, y2);
+
+    P256_sqrmod(x1, u);
+    P256_submod(x1, x1, w1);
+    P256_submod(x1, x1, w2);
+    P256_submod(t, w1, x1);
+    P256_mulmod(y1, u, t);
+    P256_submod(y1, y1, a1);
+
+    P256_sqrmod(x2, v);
+    P256_submod(x2, x2, w1);
+    P256_submod(x2, x2, w2);
+    P256_submod(t, w1, x2);
+    P256_mulmod(y2, v, t);
+    P256_submod(y2, y2, a1);
+}
+
+// (X1, Y1), (X2, Y2) = P + Q, P (with the new Z coordinate), where (X1, Y1) = P and (X2, Y2) = Q
+static void xycz_addu(uint64_t x1[4], uint64_t y1[4], uint64_t x2[4], uint64_t y2[4]) {
+    uint64_t c[4], w1[4], w2[4], a1[4], u[4], t[4];
+    P256_submod(c, x1, x2);
+    P256_sqrmod(c, c);
+    P256_mulmod(w1, x1, c);
+    P256_mulmod(w2, x2, c);
+    P256_submod(t, w1, w2);
+    P256_mulmod(a1, y1, t);
+    P256_submod(u, y1, y2);
+
+    P256_sqrmod(x1, u);
+    P256_submod(x1, x1, w1);
+    P256_submod(x1, x1, w2);
+    P256_submod(t, w1, x1);
+    P256_mulmod(y1, u, t);
+    P256_submod(y1, y1, a1);
+
+    memcpy(x2, w1, 32);
+    memcpy(y2, a1, 32);
+}
+
+static void xycz_cswap_load(uint64_t r[4][4], uint32_t state[6][8], uint32_t swap) {
+    uint32_t mask = 0 - swap;
+    uint32_t *r0 = state[0], *r1 = state[2];
+    for (int i = 0; i < 16; i++) {
+        uint32_t t = (r0[i] ^ r1[i]) & mask;
+        r0[i] ^= t;
+        r1[i] ^= t;
+    }
+    for (int i = 0; i < 4; i++) {
+        load64(r[i], state[i]);
+    }
+}
+
+void P256_xycz_ladder_init(uint32_t state[6][8]) {
+    uint64_t x[4], g[4], xp[4], yp[4], yy[4], s[4], l[4], m[4], t[4];
+    load64(x, state[4]);
+
+    // g = x^3 - 3x + b
+    P256_sqrmod(g, x);
+    P256_submod(g, g, three_mont64);
+    P256_mulmod(g, g, x);
+    P256_addmod(g, g, b_mont64);
+    store64(state[5], g);
+
+    // P' = (x*g, g^2) lies on y^2 = x^3 - 3g^2*x + b*g^3, so a = -3g^2
+    P256_mulmod(xp, x, g);
+    P256_sqrmod(yp, g);
+
+    // R0 = P' with Z = 2 * Y (S = 4XY^2, L = 8Y^4), R1 = 2P' with the same Z
+    P256_sqrmod(yy, yp);
+    P256_mulmod(s, xp, yy);
+    P256_times2(s, s);
+    P256_times2(s, s);
+    P256_sqrmod(l, yy);
+    P256_times2(l, l);
+    P256_times2(l, l);
+    P256_times2(l, l);
+    P256_submod(m, xp, g);
+    P256_addmod(t, xp, g);
+    P256_mulmod(m, m, t);
+    P256_times2(t, m);
+    P256_addmod(m, m, t);
+    store64(state[0], s);
+    store64(state[1], l);
+    P256_sqrmod(x, m);
+    P256_submod(x, x, s);
+    P256_submod(x, x, s);
+    P256_submod(t, s, x);
+    P256_mulmod(t, m, t);
+    P256_submod(t, t, l);
+    store64(state[2], x);
+    store64(state[3], t);
+}
+
+void P256_xycz_ladder_step(uint32_t state[6][8], uint32_t swap) {
+    uint64_t r[4][4];
+    xycz_cswap_load(r, state, swap);
+    xycz_addc(r[0], r[1], r[2], r[3]);
+    xycz_addu(r[0], r[1], r[2], r[3]);
+    for (int i = 0; i < 4; i++) {
+        store64(state[i], r[i]);
+    }
+}
+
+bool P256_xycz_ladder_final(uint32_t x_mont[8], uint32_t state[6][8], uint32_t swap, uint32_t last_bit) {
+    uint64_t r[4][4], den[4], w[4], t[4], x[4], g[4], res[4];
+    xycz_cswap_load(r, state, swap);
+    load64(x, state[4]);
+    load64(g, state[5]);
+
+    // After ADDC, the second point is R0 - R1 = +-P' in affine coordinates, scaled by the current Z
+    xycz_addc(r[0], r[1], r[2], r[3]);
+    P256_submod(den, r[0], r[2]);
+    P256_sqrmod(den, den);
+    P256_mulmod(den, den, r[2]);
+    xycz_addu(r[0], r[1], r[2], r[3]);
+
+    uint64_t mask = 0 - (uint64_t)(last_bit & 1);
+    for (int i = 0; i < 4; i++) {
+        res[i] = (r[0][i] & ~mask) | (r[2][i] & mask);
+    }
+
+    // w = g * den^2, t = (w^((p-3)/4))^2 = w^-1 if w is a square, otherwise -w^-1
+    P256_sqrmod(w, den);
+    P256_mulmod(w, w, g);
+    P256_modinv_sqrt(t, w, POW_P_MINUS_3_DIV_4);
+    P256_sqrmod(t, t);
+
+    P256_mulmod(res, res, x);
+    P256_mulmod(res, res, g);
+    P256_mulmod(res, res, den);
+    P256_mulmod(res, res, t);
+    store64(x_mont, res);
+
+    P256_mulmod(w, w, t);
+    return equal64(w, one_mont64);
+}
+
+#if include_p256_sha256
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ror32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+// Only a 16 word message schedule is kept, and the block is read with byte loads, so any alignment works here
+void P256_sha256_compress(uint32_t state[8], const uint8_t* blocks, uint32_t num_blocks) {
+    for (; num_blocks != 0; num_blocks--, blocks += 64) {
+        uint32_t w[16];
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4], f = state[5], g = state[6], h = state[7];
+        
+        for (int i = 0; i < 64; i++) {
+            if (i < 16) {
+                w[i] = ((uint32_t)blocks[4 * i] << 24) | ((uint32_t)blocks[4 * i + 1] << 16) | ((uint32_t)blocks[4 * i + 2] << 8) | blocks[4 * i + 3];
+            } else {
+                uint32_t w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+                w[i & 15] += (ror32(w15, 7) ^ ror32(w15, 18) ^ (w15 >> 3)) + w[(i - 7) & 15] + (ror32(w2, 17) ^ ror32(w2, 19) ^ (w2 >> 10));
+            }
+            uint32_t t1 = h + (ror32(e, 6) ^ ror32(e, 11) ^ ror32(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i & 15];
+            uint32_t t2 = (ror32(a, 2) ^ ror32(a, 13) ^ ror32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+#endif
@@ -49,10 +49,13 @@ struct XYInteger {
 int P256_divsteps2_31(int delta, uint32_t f, uint32_t g, uint32_t res_matrix[4]);
 void P256_matrix_mul_fg_9(uint32_t a, uint32_t b, const struct FGInteger fg[2], struct FGInteger *res);
 void P256_matrix_mul_mod_n(uint32_t a, uint32_t b, const struct XYInteger xy[2], struct XYInteger *res);
+void P256_matrix_mul_mod_p(uint32_t a, uint32_t b, const struct XYInteger xy[2], struct XYInteger *res);
 
 void P256_to_montgomery(uint32_t aR[8], const uint32_t a[8]);
 void P256_from_montgomery(uint32_t a[8], const uint32_t aR[8]);
 bool P256_check_range_p(const uint32_t a[8]);
+void P256_mul_mod_p(uint32_t res[8], const uint32_t a[8], const uint32_t b[8]);
+void P256_mod_p_inv(uint32_t res[8], const uint32_t a[8]);
 
 bool P256_check_range_n(const uint32_t a[8]);
 void P256_mul_mod_n(uint32_t res[8], const uint32_t a[8], const uint32_t b[8]);
@@ -72,15 +75,162 @@ bool P256_verify_last_step(const uint32_t r[8], const uint32_t jacobian_point[3]
 void P256_negate_mod_p_if(uint32_t out[8], const uint32_t in[8], uint32_t should_negate);
 void P256_negate_mod_n_if(uint32_t out[8], const uint32_t in[8], uint32_t should_negate);
 
+void P256_xycz_ladder_init(uint32_t state[6][8]);
+void P256_xycz_ladder_step(uint32_t state[6][8], uint32_t swap);
+bool P256_xycz_ladder_final(uint32_t x_mont[8], uint32_t state[6][8], uint32_t swap, uint32_t last_bit);
+
+void P256_sha256_compress(uint32_t state[8], const uint8_t* blocks, uint32_t num_blocks);
+
 extern uint32_t P256_order[9];
 
 #if include_p256_mult
 static const uint32_t one_montgomery[8] = {1, 0, 0, 0xffffffff, 0xffffffff, 0xffffffff, 0xfffffffe, 0};
 #endif
 
+// Section attribute of the precomputed base point tables (see place_tables_in_ram)
+#if place_tables_in_ram
+#define P256_TABLE_SECTION __attribute__((section(".ramdata")))
+#else
+#define P256_TABLE_SECTION
+#endif
+
 #if include_p256_verify
+// The tables below are generated by "node tablegen.js verify <window_bits>"
+#if use_large_verify_basepoint_table
+// This table contains 1G, 3G, 5G, ... 127G in affine coordinates in montgomery form
+static const uint32_t p256_basepoint_precomp[64][2][8] P256_TABLE_SECTION = {
+{{0x18a9143c, 0x79e730d4, 0x5fedb601, 0x75ba95fc, 0x77622510, 0x79fb732b, 0xa53755c6, 0x18905f76},
+{0xce95560a, 0xddf25357, 0xba19e45c, 0x8b4ab8e4, 0xdd21f325, 0xd2e88688, 0x25885d85, 0x8571ff18}},
+{{0x4eebc127, 0xffac3f90, 0x87d81fb, 0xb027f84a, 0x87cbbc98, 0x66ad77dd, 0xb6ff747e, 0x26936a3f},
+{0xc983a7eb, 0xb04c5c1f, 0x861fe1a, 0x583e47ad, 0x1a2ee98e, 0x78820831, 0xe587cc07, 0xd5f06a29}},
+{{0xc45c61f5, 0xbe1b8aae, 0x94b9537d, 0x90ec649a, 0xd076c20c, 0x941cb5aa, 0x890523c8, 0xc9079605},
+{0xe7ba4f10, 0xeb309b4a, 0xe5eb882b, 0x73c568ef, 0x7e7a1f68, 0x3540a987, 0x2dd1e916, 0x73a076bb}},
+{{0xa0173b4f, 0x746354e, 0xd23c00f7, 0x2bd20213, 0xc23bb08, 0xf43eaab5, 0xc3123e03, 0x13ba5119},
+{0x3f5b9d4d, 0x2847d030, 0x5da67bdd, 0x6742f2f2, 0x77c94195, 0xef933bdc, 0x6e240867, 0xeaedd915}},
+{{0x264e20e8, 0x75c96e8f, 0x59a7a841, 0xabe6bfed, 0x44c8eb00, 0x2cc09c04, 0xf0c4e16b, 0xe05b3080},
+{0xa45f3314, 0x1eb7777a, 0xce5d45e3, 0x56af7bed, 0x88b12f1a, 0x2b6e019a, 0xfd835f9b, 0x86659cd}},
+{{0x6245e404, 0xea7d260a, 0x6e7fdfe0, 0x9de40795, 0x8dac1ab5, 0x1ff3a415, 0x649c9073, 0x3e7090f1},
+{0x2b944e88, 0x1a768561, 0xe57f61c8, 0x250f939e, 0x1ead643d, 0xc0daa89, 0xe125b88e, 0x68930023}},
+{{0x4b2ed709, 0xccc42563, 0x856fd30d, 0xe356769, 0x559e9811, 0xbcbcd43f, 0x5395b759, 0x738477ac},
+{0xc00ee17f, 0x35752b90, 0x742ed2e3, 0x68748390, 0xbd1f5bc1, 0x7cd06422, 0xc9e7b797, 0xfbc08769}},
+{{0xbc60055b, 0x72bcd8b7, 0x56e27e4b, 0x3cc23ee, 0xe4819370, 0xee337424, 0xad3da09, 0xe2aa0e43},
+{0x6383c45d, 0x40b8524f, 0x42a41b25, 0xd7663554, 0x778a4797, 0x64efa6de, 0x7079adf4, 0x2042170a}},
+{{0xd53c5c9d, 0x97091dcb, 0xac0a177b, 0xf17624b6, 0x2cfe2dff, 0xb0f13975, 0x6c7a574e, 0xc1a35c0a},
+{0x93e79987, 0x227d3146, 0xe89cb80e, 0x575bf30, 0xd1883bb, 0x2f4e247f, 0x3274c3d0, 0xebd51226}},
+{{0xa5659ae8, 0xfea912ba, 0x25e1a16e, 0x68363aba, 0x752c41ac, 0xb8842277, 0x2897c3fc, 0xfe545c28},
+{0xdc4c696b, 0x2d36e9e7, 0xfba977c5, 0x5806244a, 0xe39508c1, 0x85665e9b, 0x6d12597b, 0xf720ee25}},
+{{0xc135b208, 0x562e4cec, 0x4783f47d, 0x74e1b265, 0x5a3f3b30, 0x6d2a506c, 0xc16762fc, 0xecead9f4},
+{0xe286e5b9, 0xf29dd4b2, 0x83bb3c61, 0x1b0fadc0, 0x7fac29a4, 0x7a75023e, 0xc9477fa3, 0xc086d5f1}},
+{{0x2de45068, 0xf4f87653, 0x9e2e1f6e, 0x37c7a7e8, 0xa3584069, 0xd0825fa2, 0x1727bf42, 0xaf2cea7c},
+{0x9e4785a9, 0x360a4fb, 0x27299f4a, 0xe5fda49c, 0x71ac2f71, 0x48068e13, 0x9077666f, 0x83d0687b}},
+{{0xd837879f, 0xa4a319ac, 0xed6b67b0, 0x6fc1b49e, 0x32f1f3af, 0xe3959933, 0x65432a2e, 0x966742eb},
+{0xb4966228, 0x4b8dc9fe, 0x43f43950, 0x96cc6312, 0xc9b731ee, 0x12068859, 0x56f79968, 0x7b948dc3}},
+{{0x97e2feb4, 0x42c2af4, 0xaebf7313, 0xd36a42d7, 0x84ffdd7, 0x49d2c9eb, 0x2ef7c76a, 0x9f8aa54b},
+{0x9895e70, 0x9200b7ba, 0xddb7fb58, 0x3bd0c66f, 0x78eb4cbb, 0x2d97d108, 0xd84bde31, 0x2d431068}},
+{{0xcb66e132, 0x5e5db46a, 0xd925880, 0xf1be963a, 0x317b9e2, 0x944a7027, 0x48603d48, 0xe266f959},
+{0x5c208899, 0x98db6673, 0xa2fb18a3, 0x90472447, 0x777c619f, 0x8a966939, 0x2a3be21b, 0x3798142a}},
+{{0x6755ff89, 0xe2f73c69, 0x473017e6, 0xdd3cf7e7, 0x3cf7600d, 0x8ef5689d, 0xb1fc87b4, 0x948dc4f8},
+{0x4ea53299, 0xd9e9fe81, 0x98eb6028, 0x2d921ca2, 0xc9803fc, 0xfaecedfd, 0x4d7b4745, 0xf38ae891}},
+{{0xf664534, 0x87151456, 0x4b68f103, 0x85ceae7c, 0x65578ab9, 0xac09c4ae, 0xf044b10c, 0x33ec6868},
+{0x3a8ec1f1, 0x6ac4832b, 0x5847d5ef, 0x5509d128, 0x763f1574, 0xf909604f, 0xc32f63c4, 0xb16c4303}},
+{{0xdec67ef5, 0xfd16847f, 0x233e76b7, 0x742ee464, 0xefc2b4c8, 0xb8e4134, 0x42a3e521, 0xca640b86},
+{0x8ceb6aa9, 0x653a0190, 0x547852d5, 0x313c300c, 0x6b237af7, 0x24e4ab12, 0x8bb47af8, 0x2ba90162}},
+{{0x8cce08b5, 0x467bc5, 0x7f178d55, 0xb636458c, 0xa677d806, 0xc5748bae, 0xdfa394eb, 0x2763a387},
+{0x7d3cebb6, 0xa12b448a, 0x6f20d850, 0xe7adda3e, 0x1558462c, 0xf63ebce5, 0x620088a8, 0x58b36143}},
+{{0xa059c142, 0xa9d89488, 0xff0b9346, 0x6f5ae714, 0x16fb3664, 0x68f237d, 0x363186ac, 0x5853e4c4},
+{0x63c52f98, 0xe2d87d23, 0x81828876, 0x2ec4a766, 0xe14e7b1c, 0x47b864fa, 0x69192408, 0xc0bc0e5}},
+{{0x2ed22e91, 0x624d6049, 0x6f072822, 0x6fdfe0b5, 0x39ce2271, 0xeeca1115, 0xdb01614f, 0x98100a4f},
+{0xa35c628f, 0xb6b0daa2, 0xc87e9a47, 0xb6f94d2e, 0x1d57d9ce, 0xc6773259, 0x3884a7b, 0xf70bfeec}},
+{{0x248a7d06, 0x4ff23ffd, 0x878873fa, 0x80c5bfb4, 0x5745981, 0xb7d9ad90, 0x3db01994, 0x179c85db},
+{0x61a6966c, 0xba41b062, 0xeadce5a8, 0x4d82d052, 0xa5e6a318, 0x9e91cd3b, 0x95b2dda0, 0x47795f4f}},
+{{0xd5cd79bf, 0x1ee426cc, 0x946c6e18, 0x32940b, 0x57477f58, 0x1b1e8ae0, 0x6d823278, 0xe94f7d34},
+{0x782ba21a, 0xc747cb96, 0xf72b33a5, 0xc5254469, 0xc7f80c81, 0x772ef6de, 0x2cd9e6b5, 0xd73acbfe}},
+{{0xcaa76097, 0x283c7513, 0x36c83906, 0xa624fa9, 0x715af2c7, 0x6b20afec, 0xeba78bfd, 0x4b969974},
+{0xd921d60e, 0x220755cc, 0x7baeca13, 0x9b944e10, 0x5ded93d4, 0x4819d51, 0x6dddfd27, 0x9bbff86e}},
+{{0x1ff6acd3, 0x21950b42, 0x53dc6909, 0xffe70484, 0x28766127, 0xff4cd0b2, 0x4fb7db2b, 0xabdbe608},
+{0x5e1109e8, 0x837c9228, 0xf4645b5a, 0x26147d27, 0xf7818ed8, 0x4d78f592, 0xf247fa36, 0xd394077e}},
+{{0x3b3f64c9, 0x508cec1c, 0x1e5edf3f, 0xe20bc0ba, 0x2f4318d4, 0xda1deb85, 0x5c3fa443, 0xd20ebe0d},
+{0x73241ea3, 0x370b4ea7, 0x5e1a5f65, 0x61f1511c, 0x82681c62, 0x99a5e23d, 0xa2f54c2d, 0xd731e383}},
+{{0x546c4d8d, 0x97359638, 0x92f24679, 0x5f9c3fc4, 0xa8c8acd9, 0x912e8bed, 0x306634b0, 0xec3a318d},
+{0xc31cb264, 0x80167f41, 0x522113f2, 0x3db82f6f, 0xdcafe197, 0xb155bcd2, 0x43465283, 0xfba1da59}},
+{{0xe7305683, 0x258bbbf9, 0x7ef5be6, 0x31eea5bf, 0x46c814c1, 0xdeb0e4a, 0xa7b730dd, 0x5cee8449},
+{0xa0182bde, 0xeab495c5, 0x9e27a6b4, 0xee759f87, 0x80e518ca, 0xc2cf6a68, 0xf14cf3f4, 0x25e8013f}},
+{{0x7acaca28, 0x3ec832e7, 0xc7385b29, 0x1bfeea57, 0xfd1eaf38, 0x68212e3, 0x6acf8ccc, 0xc1329830},
+{0x2aac9e59, 0xb909f2db, 0xb661782a, 0x5748060d, 0xc79b7a01, 0xc5ab2632, 0x17626, 0xda44c6c6}},
+{{0x5c46aa8e, 0x69d44ed6, 0xa8d063d1, 0x2100d5d3, 0xa2d17c36, 0xcb9727ea, 0x8add53b7, 0x4c2bab1b},
+{0x15426704, 0xa084e90c, 0xa837ebea, 0x778afcd3, 0x7ce477f8, 0x6651f701, 0x46fb7a8b, 0xa0624998}},
+{{0x7f4c04cc, 0x3667eb1a, 0xa9404f84, 0x59556621, 0x7eceb50a, 0x71cdf653, 0x9b8335fa, 0x994a44a6},
+{0xdbeb9b69, 0xd7faf819, 0xeed4350d, 0x473c5680, 0xda44bba2, 0xb6658466, 0x872bdbf3, 0xd1bc780}},
+{{0x9ff91fe5, 0xb8d3d931, 0xf0518eed, 0x39c4800, 0x9182cb26, 0x95c37632, 0x82fc568d, 0x763a434},
+{0x383e76ba, 0x707c04d5, 0x824e8197, 0xac98b930, 0x91230de0, 0x92bf7c8f, 0x40959b70, 0x90876a01}},
+{{0xfcdbb2b2, 0xdc2306eb, 0xba66f4b9, 0x79527db7, 0x7765765e, 0xbf639ed6, 0x6b6090a, 0x1628c47},
+{0xb957b4a1, 0x66eb62f1, 0xba659f46, 0x33cb7691, 0xf3e055d6, 0x2c90d98c, 0x2f174750, 0x7d096ac4}},
+{{0x51f9c391, 0x86f04d3b, 0xa48a4ddd, 0xc16d0c52, 0x891ea186, 0xfc88362a, 0x7de96a54, 0xe8218ad0},
+{0x2f33af7a, 0x2c735ac1, 0x6620ae8, 0x5af456a, 0xc30a96a0, 0xde3ec728, 0x9a8f62d9, 0xfd59d7eb}},
+{{0xc5e79347, 0x9e5da11c, 0x361bfe25, 0x87986a54, 0x91e9ae09, 0xc8568688, 0x548efa2a, 0x49d3ad05},
+{0xf4eb5cf6, 0x987b0687, 0x2655d14f, 0x9bea0d0f, 0x3a8dd126, 0x2126ac55, 0x546fbecc, 0x6d37b1fa}},
+{{0x92aa7864, 0xf19f382e, 0xfc05804b, 0x49c7cb94, 0x40750d01, 0xf94aa89b, 0x4a210364, 0xdd421b5d},
+{0x39df3672, 0x56cd001e, 0xdd4af1ec, 0x30a119f, 0x96cd0572, 0x11f947e6, 0x93786791, 0x574cc7b2}},
+{{0xeeb03d1a, 0xae8f8fe1, 0x96fb852, 0x2b34a7dc, 0x17e29b1a, 0x794922ef, 0x6ef82fce, 0xb2dacdf6},
+{0xf42911ee, 0xdb8dcc81, 0xe405ca09, 0xb871ba63, 0x5e82d5b3, 0xa66d9252, 0x1af82878, 0xc3972552}},
+{{0xfb760095, 0x616d2c02, 0x2a7aa6ab, 0xcfa8ca0e, 0x23af72e0, 0xf1237162, 0xa42fd1f6, 0xa22f8fbe},
+{0x78f3d040, 0x5072758b, 0xed4437a8, 0x7be19f0d, 0x70456a7e, 0xe79807a7, 0xd0c2302d, 0x24a1bde1}},
+{{0xc266f85c, 0xa2193bf, 0x5a0ec9ce, 0x719a87be, 0x2b2f9c49, 0x9c30c642, 0x3d5baeb1, 0xdb15e496},
+{0xe0d37321, 0x83c3139b, 0x2e9fdbb2, 0x4788522b, 0x77eb94ea, 0x2b4f0c78, 0x95105f9e, 0x854dc9d5}},
+{{0x30ff0e92, 0xa40206d3, 0x5176f8b, 0xdd306e2a, 0x65f89e14, 0x58f64281, 0xe89327fc, 0x5ed556aa},
+{0xf8321bb8, 0xc2b1870a, 0x99227b16, 0x97a54ff, 0x50128375, 0xd07370c4, 0x191a421f, 0xb75df5ec}},
+{{0xc63d5e79, 0xd3a5d81f, 0x2ba3183, 0x8e9d0af4, 0x165c6e4c, 0xb097c711, 0xebff18d3, 0xe0beeb1a},
+{0x801937b, 0xfe657f13, 0x6fe5b29d, 0xa02dbc42, 0xcf290d1f, 0xcbdbfdb9, 0xe85bc145, 0x7acf4419}},
+{{0xc3363a22, 0x2c9ee62d, 0xec67199a, 0x125d4714, 0x2ab80485, 0xf87abebf, 0x7a243ca4, 0xcf3086e8},
+{0xc64e09dd, 0x5c52b051, 0x5625aad7, 0x5e9b1612, 0xb19c6126, 0x536a39d, 0x47b64be5, 0x97f00132}},
+{{0x7e1ee314, 0x3646b0dd, 0x25af7677, 0xef617e00, 0xea65641a, 0x36bf2f65, 0xb5e11eff, 0xabfc8457},
+{0x8f1192b6, 0x998dfac1, 0x142811b, 0xce91ee27, 0x1f282369, 0xbb0066ae, 0xe1cbaebe, 0x159751e2}},
+{{0x7b4d8b2c, 0x516329ff, 0x2d4b409b, 0xb856664a, 0x7f6b0670, 0x4125299, 0x60826caa, 0x2bd02043},
+{0x61ddbcb1, 0x10e5226, 0xc235d56c, 0xcd07bc34, 0x6e58e3e, 0xa8f439ab, 0xd5cff157, 0xaf490825}},
+{{0xa7eabe67, 0xc1ee6264, 0xfd54487d, 0x62d51e29, 0x6310eb5a, 0x3ea12344, 0x4765b805, 0xbd88aca7},
+{0x14fb691a, 0xb7b284be, 0x3b9fffef, 0x640388f8, 0x9f98f9a, 0x7ab49dd2, 0x7211e445, 0x7150f87e}},
+{{0x6982f865, 0xd81ad938, 0xae6a94b8, 0x27113bb4, 0xbedd4f47, 0x4a39f02b, 0xd5692705, 0x211de8f},
+{0x63c92f69, 0xd587138c, 0x6237fc68, 0x2354719f, 0xb46a59f, 0xfa8a5b9b, 0x5c554ed3, 0x4a70abf7}},
+{{0xd9453d29, 0x64cfdc70, 0xfd36b1af, 0xaeaca9a, 0xe1639607, 0x4a278686, 0x1fdf2498, 0x581b471},
+{0x3d61f6d2, 0x82290e25, 0xdf219dc5, 0x20b021c3, 0xf9a2852f, 0xff6c1a78, 0x954ffbb3, 0x435ac466}},
+{{0xb308cc40, 0x263e039b, 0x2b346fd2, 0x6684ad76, 0xcaa12d0d, 0x9a127f2b, 0xa974291f, 0x76a8f9fe},
+{0x68aa19e4, 0xc802049b, 0xc5dbba0, 0x65499c99, 0x344455a1, 0xee1b1cb5, 0x2cd6f439, 0x3f293fda}},
+{{0xafceb64d, 0xdc90323b, 0x397e43f4, 0xda8cdb78, 0x2566805e, 0xee848e1d, 0x578181c7, 0xf1ae5380},
+{0x9c70c77c, 0x2dc7b8e6, 0x5b68b7e7, 0x85f4d9c4, 0x3260b767, 0x84577f1f, 0x53cf3e69, 0x1fbd470f}},
+{{0x3f9432b4, 0x2d037bf8, 0x6a7b4371, 0xb1f1abb6, 0x4a9a3b17, 0x650522fd, 0xa4e65b07, 0xbc438ae1},
+{0x84693c04, 0x31b57ea2, 0x75503e46, 0x7ab58a3f, 0xb98ff4b3, 0x3a3c2c7, 0x54fcd65a, 0x4a673fe0}},
+{{0x4ea6fdf7, 0xb7a96e0a, 0xb99cd026, 0xbbe914d3, 0xc569a602, 0x6a610374, 0x14da499e, 0xe9b1c239},
+{0xadc19a99, 0xb5f6f0fe, 0x6f21687c, 0x73125182, 0x4be77793, 0x5a8a1464, 0xdba8bfc7, 0x94ce9e0a}},
+{{0xc71f8d02, 0x564bdda6, 0x19f7f72c, 0xd0a875e9, 0xbf619241, 0x57670e41, 0x4c3c386f, 0xf51ec872},
+{0xe8bf7d17, 0xaec19e, 0x286166f3, 0x5df79360, 0x30a4f924, 0xa6fae609, 0xae1d3ed8, 0x1429b1f8}},
+{{0x7b371390, 0xde6ddcb7, 0x2a9ba44, 0xcb11125c, 0x2b1d28fd, 0xc08ec160, 0x65e03a86, 0x680d5abf},
+{0xf5327839, 0xd5ec7bbb, 0x3bce7fe5, 0xc87057ca, 0x71cbfc97, 0x4e346db0, 0xee9e512f, 0xd3d6d111}},
+{{0x3796f4c7, 0x2ca0ba9c, 0x592ce334, 0x3571e4d1, 0xe9f6e877, 0x28f9cdeb, 0xefce1a70, 0xee206023},
+{0xb76369dc, 0xb2159e08, 0xa7f687c, 0x2754e426, 0x2de2ff1, 0xe008039e, 0x8ea700c1, 0xccd7e941}},
+{{0xdd10edd0, 0xaec63acb, 0x91ae8d13, 0xfd4f61e4, 0x4df861f4, 0xe7b09217, 0x5548de20, 0x3720b247},
+{0xebf3df78, 0xaf419847, 0x56cd660d, 0xe7229d89, 0xeb879899, 0xcd622ba, 0x1cab12c7, 0x5fdaee39}},
+{{0x86653aa8, 0xd87f4ae0, 0x8072f08d, 0x327dac31, 0x832c416, 0x98f37bb, 0x7a9b6a20, 0xcf804d7},
+{0xa67e2173, 0x4b9c5438, 0xa23afa67, 0x1cc0d4ce, 0x7148b135, 0x270adcc5, 0x904d4731, 0xf9af0acd}},
+{{0xb7ebcb88, 0xa125e6c1, 0x10ec0d40, 0x3289e86e, 0x98353869, 0xcc3a5ecb, 0x8a2b0d3a, 0x734e0d07},
+{0x51933360, 0xe0d92e9a, 0x786076b9, 0xfa6bcdb1, 0x747f19ec, 0xd13cca90, 0x49f3a53d, 0x61d8209d}},
+{{0x119f6cab, 0xad19e039, 0xa8dfce56, 0xf15b920f, 0x851b5bc7, 0x8a2627c4, 0xd8ecca6e, 0x7c3ff661},
+{0xd5f5b5bf, 0xb9dd2bf2, 0xbaa43b27, 0x56b76c57, 0xfe2f4937, 0xdc8df855, 0x889821b2, 0xe95dd9d8}},
+{{0x1b620dc4, 0x8e4c490, 0xd9699e92, 0x55a3bb1a, 0x47968833, 0x7890e8d5, 0x79af29b1, 0xbbdbec7d},
+{0x3e51e1bc, 0x92750de7, 0xad91a350, 0x50cf6d11, 0xfa67285c, 0x9dc33392, 0x4480ffe3, 0x2cdf7f85}},
+{{0x6cc47305, 0x87af199e, 0x1e314dde, 0x62afb7c, 0xf3a49fb4, 0x2be22ba0, 0x157b7f56, 0x6ed0b988},
+{0x2d653fd9, 0x8162cf50, 0x877b7497, 0x17d29c64, 0xf67b514, 0xd7e81438, 0xfe6ee703, 0xfedf1014}},
+{{0x8c03e3f4, 0x14d7251a, 0xb0e5fe20, 0xd71602d5, 0x683b30d1, 0x27d2bf4f, 0xf77f10e1, 0xe1a8d418},
+{0x76a0ead7, 0xa4941a1e, 0xda0a4996, 0xff318484, 0x93394872, 0xaaf4d4e1, 0xe99505c, 0xae839cd8}},
+{{0x3b58b02, 0x62ea8598, 0x98a5ea8c, 0x5a714971, 0x917e4725, 0x1783d1b6, 0xf1e35487, 0x2d7ca4d8},
+{0x9b4d4324, 0x3f69b4d4, 0x8e17ff54, 0xda04cc89, 0x16e3e02a, 0x5870726c, 0x69e788c5, 0xaeb9041c}},
+{{0x93740130, 0xaab54cfc, 0x225733fa, 0xf72dab6d, 0x1ed32559, 0x4b76d2d, 0xbb85b9cb, 0xa9fe2396},
+{0xbf2219f0, 0x128b0d24, 0x579f3ce2, 0x2292393b, 0x145ff0d5, 0x51dc5fac, 0xc3febbc1, 0xb16d6af8}},
+{{0xdee35b41, 0x36e84bb6, 0xdddfd928, 0x70e9016c, 0xae619f28, 0x6072a061, 0x904a36cf, 0x15fe6a86},
+{0xf6005965, 0x9ab6968b, 0xad602d0, 0xfd1c4a97, 0x44f403f2, 0xd0a88792, 0xabe3c14b, 0x76759223}}
+};
+#else
 // This table contains 1G, 3G, 5G, ... 15G in affine coordinates in montgomery form
-static const uint32_t p256_basepoint_precomp[8][2][8] = {
+static const uint32_t p256_basepoint_precomp[8][2][8] P256_TABLE_SECTION = {
 {{0x18a9143c, 0x79e730d4, 0x5fedb601, 0x75ba95fc, 0x77622510, 0x79fb732b, 0xa53755c6, 0x18905f76},
 {0xce95560a, 0xddf25357, 0xba19e45c, 0x8b4ab8e4, 0xdd21f325, 0xd2e88688, 0x25885d85, 0x8571ff18}},
 {{0x4eebc127, 0xffac3f90, 0x87d81fb, 0xb027f84a, 0x87cbbc98, 0x66ad77dd, 0xb6ff747e, 0x26936a3f},
@@ -99,8 +249,10 @@ static const uint32_t p256_basepoint_precomp[8][2][8] = {
 {0x6383c45d, 0x40b8524f, 0x42a41b25, 0xd7663554, 0x778a4797, 0x64efa6de, 0x7079adf4, 0x2042170a}}
 };
 #endif
+#endif
 
 #if include_fast_p256_basemult
+#if fast_basemult_comb_teeth == 4 && fast_basemult_comb_tables == 2
 // This contains two tables, 8 points each in affine coordinates in montgomery form
 // The first table contains these points:
 // (2^192 - 2^128 - 2^64 - 1)G
@@ -112,7 +264,7 @@ static const uint32_t p256_basepoint_precomp[8][2][8] = {
 // (2^192 + 2^128 + 2^64 - 1)G
 // (2^192 + 2^128 + 2^64 + 1)G
 // The second table contains the same points multiplied by 2^32
-static const uint32_t p256_basepoint_precomp2[2][8][2][8] =
+static const uint32_t p256_basepoint_precomp2[2][8][2][8] P256_TABLE_SECTION =
 {
 {
 {{0x670844e0, 0x52d8a7c9, 0xef68a29d, 0xe33bdc, 0x4bdb7361, 0xf3d2848, 0x91c5304d, 0x5222c821},
@@ -151,6 +303,68 @@ static const uint32_t p256_basepoint_precomp2[2][8][2][8] =
 {0x15f39eb7, 0x81aa8814, 0xb98d976c, 0x6ee2fcf5, 0xcf2f717d, 0x5465475d, 0x6860bbd0, 0x8e24d3c4}}
 }
 };
+#elif defined(__has_include)
+// Generated by tablegen.js for the configured comb layout, see fast_basemult_comb_teeth
+#if __has_include("p256-cortex-m4-comb-table.h")
+#include "p256-cortex-m4-comb-table.h"
+#else
+#error "Non-default comb layout: generate the table with \"node tablegen.js comb <teeth> <tables> > p256-cortex-m4-comb-table.h\""
+#endif
+#else
+#include "p256-cortex-m4-comb-table.h"
+#endif
+#endif
+
+#if include_p256_basepoint_table_ram
+// RAM copy of p256_basepoint_precomp2, loaded by p256_init
+static uint32_t p256_basepoint_precomp2_ram[fast_basemult_comb_tables][1 << (fast_basemult_comb_teeth - 1)][2][8];
+static bool p256_basepoint_precomp2_ram_loaded;
+#endif
+
+void p256_init(void) {
+    #if include_p256_basepoint_table_ram
+    memcpy(p256_basepoint_precomp2_ram, p256_basepoint_precomp2, sizeof(p256_basepoint_precomp2));
+    p256_basepoint_precomp2_ram_loaded = true;
+    #endif
+}
+
+#if p256_enable_stats
+// Incremented by the assembler (or portable C) implementation of each counted operation
+struct P256OpCounts p256_op_counts;
+static struct P256OpCounts phase_counts[P256_STATS_NUM_PHASES];
+static struct P256OpCounts phase_start_counts;
+
+static inline void stats_begin_phase(void) {
+    phase_start_counts = p256_op_counts;
+}
+
+// Adds the operations executed since the last stats_begin_phase to the given phase
+static inline void stats_end_phase(enum P256StatsPhase phase) {
+    const uint32_t* now = (const uint32_t*)&p256_op_counts;
+    const uint32_t* start = (const uint32_t*)&phase_start_counts;
+    uint32_t* counts = (uint32_t*)&phase_counts[phase];
+    for (size_t i = 0; i < sizeof(struct P256OpCounts) / sizeof(uint32_t); i++) {
+        counts[i] += now[i] - start[i];
+    }
+}
+
+void p256_get_stats(struct P256Stats* stats) {
+    stats->total = p256_op_counts;
+    memcpy(stats->phase, phase_counts, sizeof(phase_counts));
+}
+
+void p256_reset_stats(void) {
+    memset(&p256_op_counts, 0, sizeof(p256_op_counts));
+    memset(phase_counts, 0, sizeof(phase_counts));
+}
+
+#define STATS_COUNT(op) (p256_op_counts.op++)
+#define STATS_BEGIN_PHASE() stats_begin_phase()
+#define STATS_END_PHASE(phase) stats_end_phase(phase)
+#else
+#define STATS_COUNT(op)
+#define STATS_BEGIN_PHASE()
+#define STATS_END_PHASE(phase)
 #endif
 
 #if include_p256_verify || include_p256_sign
@@ -172,9 +386,11 @@ static void hash_to_z(uint32_t z[8], const uint8_t* hash, uint32_t hashlen) {
 #if include_p256_verify
 // Creates a representation of a (little endian integer),
 // so that r[0] + 2*r[1] + 2^2*r[2] + 2^3*r[3] + ... = a,
-// where each r[i] is -15, -13, ..., 11, 13, 15 or 0.
-// Only around 1/5.5 of the r[i] will be non-zero.
-static void slide_257(signed char r[257], const uint8_t a[32]) {
+// where each r[i] is an odd integer v, so that -(2^window_bits-1) <= v <= 2^window_bits-1, or 0.
+// With window_bits = 4, each r[i] is -15, -13, ..., 11, 13, 15 or 0 and only around 1/5.5 of the r[i] will be non-zero.
+static void slide_257(signed char r[257], const uint8_t a[32], int window_bits) {
+    int max_value = (1 << window_bits) - 1;
+    
     for (int i = 0; i < 256; ++i) {
         r[i] = 1 & (a[i >> 3] >> (i & 7));
     }
@@ -182,11 +398,11 @@ static void slide_257(signed char r[257], const uint8_t a[32]) {
 
     for (int i = 0; i < 256; i++) {
         if (r[i] != 0) {
-            for (int b = 1; b <= 4 && i + b < 256; b++) {
+            for (int b = 1; b <= window_bits && i + b < 256; b++) {
                 if (r[i + b] != 0) {
-                    if (r[i] + (r[i + b] << b) <= 15) {
+                    if (r[i] + (r[i + b] << b) <= max_value) {
                         r[i] += r[i + b] << b; r[i + b] = 0;
-                    } else if (r[i] - (r[i + b] << b) >= -15) {
+                    } else if (r[i] - (r[i + b] << b) >= -max_value) {
                         r[i] -= r[i + b] << b;
                         for (;;) {
                             r[i + b] = 0;
@@ -207,12 +423,19 @@ static void slide_257(signed char r[257], const uint8_t a[32]) {
 }
 #endif
 
-#if include_p256_sign
-void P256_mod_n_inv(uint32_t out[8], const uint32_t in[8]) {
+#if include_p256_sign || include_p256_safegcd_mod_p
+typedef void (*matrix_mul_mod_m_fn)(uint32_t a, uint32_t b, const struct XYInteger xy[2], struct XYInteger *res);
+typedef void (*negate_mod_m_if_fn)(uint32_t out[8], const uint32_t in[8], uint32_t should_negate);
+
+// Computes in^-1 * scale * 2^-24 mod m, where m is the prime P256_order or p (given as 9 words, the last one 0),
+// using the matrix multiplication and negation functions for that modulus.
+// If var_time is set, the computation stops early as soon as g becomes 0, which leaks the time it took
+// and must only be used when the input is public.
+static void safegcd_inverse(uint32_t out[8], const uint32_t in[8], const uint32_t modulus[9], const uint32_t scale[8], matrix_mul_mod_m_fn matrix_mul_mod_m, negate_mod_m_if_fn negate_mod_m_if, bool var_time) {
     // This function follows the algorithm in section 12.1 of https://gcd.cr.yp.to/safegcd-20190413.pdf.
     // It has been altered in the following ways:
     //   1. Due to 32-bit cpu, we use 24 * 31 iterations instead of 12 * 62.
-    //   2. P-256 modulus instead of 2^255-19.
+    //   2. P-256 modulus (n or p) instead of 2^255-19.
     //      744 iterations are still enough and slightly more than the required 741 (floor((49*256+57)/17)).
     //   3. Step 5 has been corrected to go back to step 2 instead of step 3.
     //   4. The order of the matrix multiplications in step 6 has been changed to (T24*(T23*(T22*(...*(T1*[0, 1]))))),
@@ -225,19 +448,34 @@ void P256_mod_n_inv(uint32_t out[8], const uint32_t in[8]) {
     } state[2]; // "current" and "next"
     
     state[0].fg[0].flip_sign = 0; // non-negative f
-    memcpy(&state[0].fg[0].signed_value, P256_order, 36); // f
+    memcpy(&state[0].fg[0].signed_value, modulus, 36); // f
     state[0].fg[1].flip_sign = 0; // non-negative g
     memcpy(&state[0].fg[1].signed_value, in, 32); // g
     state[0].fg[1].signed_value[8] = 0; // upper bits of g are 0
     memset(&state[0].xy, 0, sizeof(state[0].xy));
-    // We later need a factor 2^-744. The montgomery multiplication gives 2^(24*-32)=2^-768, so multiply the init value (1) by 2^24 here.
-    state[0].xy[1].value[0] = 1U << 24;
+    // We later need a factor 2^-744. The montgomery multiplication gives 2^(24*-32)=2^-768, so starting with
+    // the value scale gives the result in^-1 * scale * 2^-24. Using scale = 2^24 gives the plain inverse.
+    memcpy(state[0].xy[1].value, scale, 32);
     
     int delta = 1;
     for (int i = 0; i < 24; i++) {
         // Scaled translation matrix Ti
         uint32_t matrix[4]; // element range: [-2^30, 2^31] (negative numbers are stored in two's complement form)
         
+        if (var_time) {
+            uint32_t g_nonzero = 0;
+            for (int j = 0; j < 9; j++) {
+                g_nonzero |= state[i % 2].fg[1].signed_value[j];
+            }
+            if (!g_nonzero) {
+                // Once g is 0, every remaining divstep only halves g (which stays 0), so f is unchanged,
+                // the matrix is [[2^31, 0], [0, 1]] and only x (halved with a montgomery step) is of interest.
+                memcpy(state[(i + 1) % 2].fg, state[i % 2].fg, sizeof(state[0].fg));
+                matrix_mul_mod_m(1U << 31, 0, state[i % 2].xy, &state[(i + 1) % 2].xy[0]);
+                continue;
+            }
+        }
+        
         // Decode f and g into two's complement representation and use the lowest 32 bits in the P256_divsteps2_31 calculation
         uint32_t negate_f = state[i % 2].fg[0].flip_sign;
         uint32_t negate_g = state[i % 2].fg[1].flip_sign;
@@ -249,12 +487,82 @@ void P256_mod_n_inv(uint32_t out[8], const uint32_t in[8]) {
         
         // Iterate the result vector
         // Due to montgomery multiplication inside this function, each step also adds a 2^-32 factor
-        P256_matrix_mul_mod_n(matrix[0], matrix[1], state[i % 2].xy, &state[(i + 1) % 2].xy[0]);
-        P256_matrix_mul_mod_n(matrix[2], matrix[3], state[i % 2].xy, &state[(i + 1) % 2].xy[1]);
+        matrix_mul_mod_m(matrix[0], matrix[1], state[i % 2].xy, &state[(i + 1) % 2].xy[0]);
+        matrix_mul_mod_m(matrix[2], matrix[3], state[i % 2].xy, &state[(i + 1) % 2].xy[1]);
     }
     // Calculates val^-1 = sgn(f) * v * 2^-744, where v is the "top-right corner" of the resulting T24*T23*...*T1 matrix.
-    // In this implementation, at this point x contains v * 2^-744.
-    P256_negate_mod_n_if(out, &state[0].xy[0].value[0], (state[0].xy[0].flip_sign ^ state[0].fg[0].flip_sign ^ state[0].fg[0].signed_value[8]) & 1);
+    // In this implementation, at this point x contains v * 2^-744 * scale * 2^-24.
+    negate_mod_m_if(out, &state[0].xy[0].value[0], (state[0].xy[0].flip_sign ^ state[0].fg[0].flip_sign ^ state[0].fg[0].signed_value[8]) & 1);
+}
+#endif
+
+#if include_p256_sign
+void P256_mod_n_inv(uint32_t out[8], const uint32_t in[8]) {
+    static const uint32_t scale[8] = {1U << 24};
+    STATS_COUNT(inv_mod_n);
+    safegcd_inverse(out, in, P256_order, scale, P256_matrix_mul_mod_n, P256_negate_mod_n_if, false);
+}
+#endif
+
+#if include_p256_batch_inversion || include_p256_safegcd_mod_p
+// If input is A*R mod p, computes A^-1 * R mod p.
+// The input is secret unless var_time is set.
+static void mod_p_inv(uint32_t out[8], const uint32_t in[8], bool var_time) {
+#if use_safegcd_mod_p_inv
+    // (A*R)^-1 * 2^536 * 2^-24 = A^-1 * R (with R = 2^256)
+    static const uint32_t p[9] = {0xffffffff, 0xffffffff, 0xffffffff, 0, 0, 0, 1, 0xffffffff, 0};
+    static const uint32_t scale[8] = {0x03000000, 0x00000000, 0xff000000, 0xfbffffff, 0xfeffffff, 0xffffffff, 0xfdffffff, 0x04ffffff}; // 2^536 mod p
+    STATS_COUNT(inv_mod_p);
+    safegcd_inverse(out, in, p, scale, P256_matrix_mul_mod_p, P256_negate_mod_p_if, var_time);
+#else
+    (void)var_time;
+    P256_mod_p_inv(out, in);
+#endif
+}
+#endif
+
+#if include_p256_bench_internals && include_p256_safegcd_mod_p
+// Exported for arm_bench_main.c
+void P256_mod_p_inv_safegcd(uint32_t out[8], const uint32_t in[8]) {
+    mod_p_inv(out, in, false);
+}
+
+void P256_mod_p_inv_safegcd_vartime(uint32_t out[8], const uint32_t in[8]) {
+    mod_p_inv(out, in, true);
+}
+#endif
+
+#if include_p256_jacobian_to_affine
+// Converts a point from jacobian to affine coordinates (all values in Montgomery form).
+// The output may overlap with the X and Y coordinates of the input.
+// The point is secret unless var_time is set.
+static void jacobian_to_affine(uint32_t x[8], uint32_t y[8], const uint32_t jacobian_point[3][8], bool var_time) {
+#if use_safegcd_mod_p_inv
+    uint32_t z_inv[8], z_inv2[8];
+    mod_p_inv(z_inv, jacobian_point[2], var_time);
+    
+    // x = X / Z^2, y = Y / Z^3
+    P256_mul_mod_p(z_inv2, z_inv, z_inv);
+    P256_mul_mod_p(x, jacobian_point[0], z_inv2);
+    P256_mul_mod_p(z_inv2, z_inv2, z_inv);
+    P256_mul_mod_p(y, jacobian_point[1], z_inv2);
+#else
+    (void)var_time;
+    P256_jacobian_to_affine(x, y, jacobian_point);
+#endif
+}
+#endif
+
+#if include_p256_varmult || (include_p256_basemult && !use_fast_p256_basemult) || (include_p256_verify && include_p256_resumable)
+// Performs step number "step" (0 <= step < 8) of the creation of a table of P, 3P, 5P, ..., 15P,
+// where P is located in table[0] (with Z set to 1 in Montgomery form).
+static void odd_multiples_table_step(uint32_t table[8][3][8], uint32_t step) {
+    if (step == 0) {
+        P256_double_j(table[7], (constarr)table[0]);
+    } else {
+        memcpy(table[step], table[7], 96);
+        P256_add_sub_j(table[step], (constarr)table[step - 1], 0, 0);
+    }
 }
 #endif
 
@@ -270,12 +578,16 @@ static inline uint32_t abs_int(int8_t a) {
     return result;
 }
 
-// Calculates scalar*P in constant time (except for the scalars 2 and n-2, for which the results take a few extra cycles to compute)
-static void scalarmult_variable_base(uint32_t output_mont_x[8], uint32_t output_mont_y[8], const uint32_t input_mont_x[8], const uint32_t input_mont_y[8], const uint32_t scalar[8]) {
+// The variable base scalar multiplication is split up into steps, so that it can also be run resumably:
+// 8 steps that create the table and 64 steps that each process one digit of the scalar.
+#define VARMULT_NUM_STEPS 72
+
+// Prepares a variable base scalar multiplication, by rewriting the scalar as signed digits in e and placing P in table[0].
+// Returns true if the scalar is even, in which case the result must be negated at the end.
+static bool varmult_init(int8_t e[64], uint32_t table[8][3][8], const uint32_t input_mont_x[8], const uint32_t input_mont_y[8], const uint32_t scalar[8]) {
     // Based on https://eprint.iacr.org/2014/130.pdf, Algorithm 1.
     
     uint32_t scalar2[8];
-    int8_t e[64];
     
     // The algorithm used requires the scalar to be odd. If even, negate the scalar modulo p to make it odd, and later negate the end result.
     bool even = (scalar[0] & 1) ^ 1;
@@ -291,139 +603,278 @@ static void scalarmult_variable_base(uint32_t output_mont_x[8], uint32_t output_
         e[i] |= 1;
     }
     
-    // Create a table of P, 3P, 5P, ... 15P.
-    uint32_t table[8][3][8];
     memcpy(table[0][0], input_mont_x, 32);
     memcpy(table[0][1], input_mont_y, 32);
     memcpy(table[0][2], one_montgomery, 32);
-    P256_double_j(table[7], (constarr)table[0]);
-    for (int i = 1; i < 8; i++) {
-        memcpy(table[i], table[7], 96);
-        P256_add_sub_j(table[i], (constarr)table[i - 1], 0, 0);
+    return even;
+}
+
+// Performs step number "step" (0 <= step < VARMULT_NUM_STEPS) of the variable base scalar multiplication.
+static void varmult_step(uint32_t current_point[3][8], uint32_t table[8][3][8], const int8_t e[64], uint32_t step) {
+    if (step < 8) {
+        // Create a table of P, 3P, 5P, ... 15P.
+        odd_multiples_table_step(table, step);
+        return;
     }
     
     // Calculate the result as (((((((((e[63]*G)*2^4)+e[62])*2^4)+e[61])*2^4)...)+e[1])*2^4)+e[0] = (2^252*e[63] + 2^248*e[62] + ... + e[0])*G.
+    uint32_t i = VARMULT_NUM_STEPS - 1 - step;
+    if (i == 63) {
+        // e[63] is never negative
+        #if has_d_cache
+        P256_select_point(current_point, (uint32_t*)table, 3, e[63] >> 1);
+        #else
+        memcpy(current_point, table[e[63] >> 1], 96);
+        #endif
+        return;
+    }
     
-    uint32_t current_point[3][8];
-    
-    // e[63] is never negative
+    for (int j = 3; j >= 0; j--) {
+        P256_double_j(current_point, (constarr)current_point);
+    }
+    uint32_t selected_point[3][8];
     #if has_d_cache
-    P256_select_point(current_point, (uint32_t*)table, 3, e[63] >> 1);
+    P256_select_point(selected_point, (uint32_t*)table, 3, abs_int(e[i]) >> 1);
     #else
-    memcpy(current_point, table[e[63] >> 1], 96);
+    memcpy(selected_point, table[abs_int(e[i]) >> 1], 96);
     #endif
+    P256_negate_mod_p_if(selected_point[1], selected_point[1], (uint8_t)e[i] >> 7);
     
-    for (uint32_t i = 63; i --> 0;) {
-        for (int j = 3; j >= 0; j--) {
-            P256_double_j(current_point, (constarr)current_point);
-        }
-        uint32_t selected_point[3][8];
-        #if has_d_cache
-        P256_select_point(selected_point, (uint32_t*)table, 3, abs_int(e[i]) >> 1);
-        #else
-        memcpy(selected_point, table[abs_int(e[i]) >> 1], 96);
-        #endif
-        P256_negate_mod_p_if(selected_point[1], selected_point[1], (uint8_t)e[i] >> 7);
-        
-        // There is (only) one odd input scalar that leads to an exception when i == 0: n-2,
-        // in that case current_point will be equal to selected_point and hence a doubling
-        // will occur instead. We don't bother fixing the same constant time for that case since
-        // the probability of that random value to be generated is around 1/2^255 and an
-        // attacker could easily test this case anyway.
-        P256_add_sub_j(current_point, (constarr)selected_point, false, false);
+    // There is (only) one odd input scalar that leads to an exception when i == 0: n-2,
+    // in that case current_point will be equal to selected_point and hence a doubling
+    // will occur instead. We don't bother fixing the same constant time for that case since
+    // the probability of that random value to be generated is around 1/2^255 and an
+    // attacker could easily test this case anyway.
+    P256_add_sub_j(current_point, (constarr)selected_point, false, false);
+}
+
+#if include_p256_varmult_blocking || (include_p256_basemult && !use_fast_p256_basemult)
+// Calculates scalar*P in constant time (except for the scalars 2 and n-2, for which the results take a few extra cycles to compute)
+// The result is in jacobian coordinates.
+static void scalarmult_variable_base_jacobian(uint32_t current_point[3][8], const uint32_t input_mont_x[8], const uint32_t input_mont_y[8], const uint32_t scalar[8]) {
+    uint32_t table[8][3][8];
+    int8_t e[64];
+    bool even = varmult_init(e, table, input_mont_x, input_mont_y, scalar);
+    
+    uint32_t step = 0;
+    STATS_BEGIN_PHASE();
+    for (; step < 8; step++) {
+        varmult_step(current_point, table, e, step);
+    }
+    STATS_END_PHASE(P256_STATS_PHASE_TABLE);
+    
+    STATS_BEGIN_PHASE();
+    for (; step < VARMULT_NUM_STEPS; step++) {
+        varmult_step(current_point, table, e, step);
     }
-    P256_jacobian_to_affine(output_mont_x, output_mont_y, (constarr)current_point);
+    STATS_END_PHASE(P256_STATS_PHASE_MAIN_LOOP);
     
     // If the scalar was initially even, we now negate the result to get the correct result, since -(scalar*G) = (-scalar*G).
     // This is done by negating y, since -(x,y) = (x,-y).
-    P256_negate_mod_p_if(output_mont_y, output_mont_y, even);
+    P256_negate_mod_p_if(current_point[1], current_point[1], even);
+}
+#endif
+
+#if include_p256_varmult_blocking
+static void scalarmult_variable_base(uint32_t output_mont_x[8], uint32_t output_mont_y[8], const uint32_t input_mont_x[8], const uint32_t input_mont_y[8], const uint32_t scalar[8]) {
+    uint32_t current_point[3][8];
+    scalarmult_variable_base_jacobian(current_point, input_mont_x, input_mont_y, scalar);
+    STATS_BEGIN_PHASE();
+    jacobian_to_affine(output_mont_x, output_mont_y, (constarr)current_point, false);
+    STATS_END_PHASE(P256_STATS_PHASE_TO_AFFINE);
 }
 #endif
+#endif
 
 #define get_bit(arr, i) ((arr[(i) / 32] >> ((i) % 32)) & 1)
 
-#if include_p256_basemult
-#if include_fast_p256_basemult
-// Calculates scalar*G in constant time
-static void scalarmult_fixed_base(uint32_t output_mont_x[8], uint32_t output_mont_y[8], const uint32_t scalar[8]) {
-    uint32_t scalar2[8];
-    
+#if include_p256_comb
+// The fixed base scalar multiplication is split up into steps, so that it can also be run resumably.
+// Each step processes the bits i, i + BASEMULT_NUM_STEPS, i + 2 * BASEMULT_NUM_STEPS, ... of each COMB_SPACING-bit
+// part of the scalar, for i = BASEMULT_NUM_STEPS - 1 - step (by default, the bits i and i + 32 of each 64-bit part).
+#define COMB_SPACING (256 / fast_basemult_comb_teeth)
+#define COMB_NUM_POINTS (1 << (fast_basemult_comb_teeth - 1))
+#define BASEMULT_NUM_STEPS (COMB_SPACING / fast_basemult_comb_tables)
+
+// Prepares a fixed base scalar multiplication.
+// Returns true if the scalar is even, in which case the result must be negated at the end.
+static bool basemult_init(uint32_t scalar2[8], const uint32_t scalar[8]) {
     // Just as with the algorithm used in variable base scalar multiplication, this algorithm requires the scalar to be odd.
     bool even = (scalar[0] & 1) ^ 1;
     P256_negate_mod_n_if(scalar2, scalar, even);
-    
+    return even;
+}
+
+// Loads the point with the secret index "index" from one comb table.
+static void comb_select(uint32_t (*output)[8], const uint32_t (*table)[2][8], uint32_t index) {
+    #if has_d_cache && COMB_NUM_POINTS == 8
+    P256_select_point(output, (uint32_t*)table, 2, index);
+    #elif has_d_cache
+    // P256_select_point handles 8 points at a time, so select from every group of 8 points and keep the right one
+    memset(output, 0, 64);
+    for (uint32_t group = 0; group < COMB_NUM_POINTS / 8; group++) {
+        uint32_t candidate[2][8];
+        P256_select_point(candidate, (uint32_t*)table[group * 8], 2, index & 7);
+        uint32_t mask = 0 - ((((index >> 3) ^ group) - 1) >> 31); // all ones if index >> 3 == group, otherwise 0
+        for (int i = 0; i < 16; i++) {
+            output[i / 8][i % 8] |= candidate[i / 8][i % 8] & mask;
+        }
+    }
+    #else
+    memcpy(output, table[index], 64);
+    #endif
+}
+
+// Performs step number "step" (0 <= step < BASEMULT_NUM_STEPS) of the fixed base scalar multiplication.
+// The precomp parameter points to p256_basepoint_precomp2, a RAM copy of it, or the table of a FixedPointPrecomp.
+static void basemult_step(uint32_t current_point[3][8], const uint32_t scalar2[8], const uint32_t (*precomp)[COMB_NUM_POINTS][2][8], uint32_t step) {
     // This algorithm conceptually rewrites the odd scalar as s[0] + 2^1*s[1] + 2^2*s[2] + ... + 2^255*s[255], where each s[i] is -1 or 1.
     // By initially setting s[i] to the corresponding bit S[i] in the original odd scalar S, we go from lsb to msb, and whenever a value s[i] is 0,
     // increase s[i] by 1 and decrease s[i-1] by 2.
     // This will result in that s[i] = S[i+1] == 1 ? 1 : -1 for i < 255, and s[255] = 1.
     
-    // We then form the scalars abs(s[j] + s[j+64]*2^64 + s[j+128]*2^128 + s[j+192]*2^192)*(2^32 * floor(j / 32)) for different 0 <= j < 64.
-    // Each scalar times G has already been precomputed in p256_basepoint_precomp2.
-    // That way we only need 31 point doublings and 63 point additions.
+    // With d = COMB_SPACING and T = fast_basemult_comb_teeth, we then form the scalars
+    // abs(s[j] + s[j+d]*2^d + ... + s[j+(T-1)*d]*2^((T-1)*d))*2^(BASEMULT_NUM_STEPS * floor(j / BASEMULT_NUM_STEPS)) for different 0 <= j < d.
+    // Each scalar times G has already been precomputed in p256_basepoint_precomp2, where table t contains the
+    // 2^(T-1) combinations of signs of the lower T-1 terms, multiplied by 2^(BASEMULT_NUM_STEPS * t).
+    // The same applies to a FixedPointPrecomp table, with G replaced by the fixed point.
+    // That way we only need BASEMULT_NUM_STEPS - 1 point doublings and d - 1 point additions
+    // (31 and 63 for the default layout).
     
-    uint32_t current_point[3][8];
     uint32_t selected_point[2][8];
-    
-    #if !has_d_cache
-    // Load table into RAM, for example if the the table lies on external memory mapped flash, which can easily be intercepted.
-    uint32_t precomp[2][8][2][8];
-    memcpy(precomp, p256_basepoint_precomp2, sizeof(p256_basepoint_precomp2));
-    #endif
-    
-    for (uint32_t i = 32; i --> 0;) {
-        {
-            uint32_t mask = get_bit(scalar2, i + 32 + 1) | (get_bit(scalar2, i + 64 + 32 + 1) << 1) | (get_bit(scalar2, i + 2 * 64 + 32 + 1) << 2);
-            if (i == 31) {
-                #if has_d_cache
-                P256_select_point(current_point, (uint32_t*)p256_basepoint_precomp2[1], 2, mask);
-                #else
-                memcpy(current_point, precomp[1][mask], 64);
-                #endif
-                memcpy(current_point[2], one_montgomery, 32);
-            } else {
-                P256_double_j(current_point, (constarr)current_point);
-                
-                uint32_t sign = get_bit(scalar2, i + 3 * 64 + 32 + 1) - 1; // positive: 0, negative: -1
-                mask = (mask ^ sign) & 7;
-                #if has_d_cache
-                P256_select_point(selected_point, (uint32_t*)p256_basepoint_precomp2[1], 2, mask);
-                #else
-                memcpy(selected_point, precomp[1][mask], 64);
-                #endif
-                P256_negate_mod_p_if(selected_point[1], selected_point[1], sign & 1);
-                P256_add_sub_j(current_point, (constarr)selected_point, false, true);
-            }
+    uint32_t i = BASEMULT_NUM_STEPS - 1 - step;
+    if (step != 0) {
+        P256_double_j(current_point, (constarr)current_point);
+    }
+    for (uint32_t t = fast_basemult_comb_tables; t --> 0;) {
+        uint32_t j = i + t * BASEMULT_NUM_STEPS;
+        uint32_t mask = 0;
+        for (uint32_t k = 0; k < fast_basemult_comb_teeth - 1; k++) {
+            mask |= get_bit(scalar2, j + k * COMB_SPACING + 1) << k;
         }
-        {
-            uint32_t mask = get_bit(scalar2, i + 1) | (get_bit(scalar2, i + 64 + 1) << 1) | (get_bit(scalar2, i + 2 * 64 + 1) << 2);
-            uint32_t sign = get_bit(scalar2, i + 3 * 64 + 1) - 1; // positive: 0, negative: -1
-            mask = (mask ^ sign) & 7;
-            #if has_d_cache
-            P256_select_point(selected_point, (uint32_t*)p256_basepoint_precomp2[0], 2, mask);
-            #else
-            memcpy(selected_point, precomp[0][mask], 64);
-            #endif
+        if (step == 0 && t == fast_basemult_comb_tables - 1) {
+            // The first point is never negated, since its top term is s[255] = 1
+            comb_select(current_point, precomp[t], mask);
+            memcpy(current_point[2], one_montgomery, 32);
+        } else {
+            uint32_t sign = get_bit(scalar2, j + (fast_basemult_comb_teeth - 1) * COMB_SPACING + 1) - 1; // positive: 0, negative: -1
+            mask = (mask ^ sign) & (COMB_NUM_POINTS - 1);
+            comb_select(selected_point, precomp[t], mask);
             P256_negate_mod_p_if(selected_point[1], selected_point[1], sign & 1);
             P256_add_sub_j(current_point, (constarr)selected_point, false, true);
         }
     }
-    P256_jacobian_to_affine(output_mont_x, output_mont_y, (constarr)current_point);
+}
+#endif
+
+#if include_p256_basemult
+#if include_fast_p256_basemult
+// Performs the steps from "step" up to but not including "end" of the fixed base scalar multiplication.
+static void basemult_run_steps(uint32_t current_point[3][8], const uint32_t scalar2[8], uint32_t step, uint32_t end) {
+    #if include_p256_basepoint_table_ram
+    // Use the RAM copy of the table, loaded once by p256_init (or here, if p256_init has not been called).
+    if (!p256_basepoint_precomp2_ram_loaded) {
+        p256_init();
+    }
+    const uint32_t (*precomp)[COMB_NUM_POINTS][2][8] = (const uint32_t (*)[COMB_NUM_POINTS][2][8])p256_basepoint_precomp2_ram;
+    #elif !has_d_cache && fast_basemult_comb_table_bytes <= 1024 && !place_tables_in_ram
+    // Load table into RAM, for example if the the table lies on external memory mapped flash, which can easily be intercepted.
+    uint32_t precomp[fast_basemult_comb_tables][COMB_NUM_POINTS][2][8];
+    memcpy(precomp, p256_basepoint_precomp2, sizeof(p256_basepoint_precomp2));
+    #else
+    // Tables already in RAM, or read through the data cache, are not copied. Larger tables without a cache are
+    // rejected in p256-cortex-m4-config.h unless they are placed in RAM.
+    const uint32_t (*precomp)[COMB_NUM_POINTS][2][8] = p256_basepoint_precomp2;
+    #endif
+    
+    for (; step < end; step++) {
+        basemult_step(current_point, scalar2, (const uint32_t (*)[COMB_NUM_POINTS][2][8])precomp, step);
+    }
+}
+
+// Calculates scalar*G in constant time, with the result in jacobian coordinates
+static void scalarmult_fixed_base_jacobian(uint32_t current_point[3][8], const uint32_t scalar[8]) {
+    uint32_t scalar2[8];
+    bool even = basemult_init(scalar2, scalar);
+    
+    STATS_BEGIN_PHASE();
+    basemult_run_steps(current_point, scalar2, 0, BASEMULT_NUM_STEPS);
+    STATS_END_PHASE(P256_STATS_PHASE_MAIN_LOOP);
     
     // Negate final result if the scalar was initially even.
-    P256_negate_mod_p_if(output_mont_y, output_mont_y, even);
+    P256_negate_mod_p_if(current_point[1], current_point[1], even);
 }
 #else
+// The base point G in Montgomery form
+#if !include_p256_verify
+static const uint32_t p256_basepoint_mont[2][8] =
+{{0x18a9143c, 0x79e730d4, 0x5fedb601, 0x75ba95fc, 0x77622510, 0x79fb732b, 0xa53755c6, 0x18905f76},
+{0xce95560a, 0xddf25357, 0xba19e45c, 0x8b4ab8e4, 0xdd21f325, 0xd2e88688, 0x25885d85, 0x8571ff18}};
+#else
+#define p256_basepoint_mont p256_basepoint_precomp[0]
+#endif
+
+static void scalarmult_fixed_base_jacobian(uint32_t current_point[3][8], const uint32_t scalar[8]) {
+    scalarmult_variable_base_jacobian(current_point, p256_basepoint_mont[0], p256_basepoint_mont[1], scalar);
+}
+#endif
+
+#if include_p256_keygen || include_p256_sign || include_p256_raw_scalarmult_base
 static void scalarmult_fixed_base(uint32_t output_mont_x[8], uint32_t output_mont_y[8], const uint32_t scalar[8]) {
-    #if !include_p256_verify
-    static const uint32_t p[2][8] =
-    {{0x18a9143c, 0x79e730d4, 0x5fedb601, 0x75ba95fc, 0x77622510, 0x79fb732b, 0xa53755c6, 0x18905f76},
-    {0xce95560a, 0xddf25357, 0xba19e45c, 0x8b4ab8e4, 0xdd21f325, 0xd2e88688, 0x25885d85, 0x8571ff18}};
-    scalarmult_variable_base(output_mont_x, output_mont_y, p[0], p[1], scalar);
-    #else
-    scalarmult_variable_base(output_mont_x, output_mont_y, p256_basepoint_precomp[0][0], p256_basepoint_precomp[0][1], scalar);
-    #endif
+    uint32_t current_point[3][8];
+    scalarmult_fixed_base_jacobian(current_point, scalar);
+    STATS_BEGIN_PHASE();
+    jacobian_to_affine(output_mont_x, output_mont_y, (constarr)current_point, false);
+    STATS_END_PHASE(P256_STATS_PHASE_TO_AFFINE);
+}
+#endif
+#endif
+
+#if include_p256_batch_inversion
+// Converts points from jacobian to affine coordinates (all values in Montgomery form), in place,
+// using only one field inversion in total (Montgomery's simultaneous inversion trick).
+// Point i has its X and Y coordinates at xy + i * xy_stride and its Z coordinate at z + i * z_stride (in words).
+// The affine x and y overwrite X and Y. No point may be the point at infinity.
+// The "scratch" parameter shall have room for num_points field elements.
+// The points are secret unless var_time is set.
+static void batch_to_affine(uint32_t* xy, uint32_t xy_stride, const uint32_t* z, uint32_t z_stride,
+                            uint32_t num_points, uint32_t (*scratch)[8], bool var_time) {
+    // scratch[i] = Z[0] * Z[1] * ... * Z[i]
+    memcpy(scratch[0], z, 32);
+    for (uint32_t i = 1; i < num_points; i++) {
+        P256_mul_mod_p(scratch[i], scratch[i - 1], z + i * z_stride);
+    }
+    
+    uint32_t inv[8];
+    mod_p_inv(inv, scratch[num_points - 1], var_time);
+    
+    for (uint32_t i = num_points; i --> 0;) {
+        // At this point, inv = (Z[0] * Z[1] * ... * Z[i])^-1
+        uint32_t z_inv[8], z_inv2[8];
+        uint32_t* x = xy + i * xy_stride;
+        uint32_t* y = x + 8;
+        if (i != 0) {
+            P256_mul_mod_p(z_inv, inv, scratch[i - 1]);
+            P256_mul_mod_p(inv, inv, z + i * z_stride);
+        } else {
+            memcpy(z_inv, inv, 32);
+        }
+        
+        // x = X / Z^2, y = Y / Z^3
+        P256_mul_mod_p(z_inv2, z_inv, z_inv);
+        P256_mul_mod_p(x, x, z_inv2);
+        P256_mul_mod_p(z_inv2, z_inv2, z_inv);
+        P256_mul_mod_p(y, y, z_inv2);
+    }
 }
+
 #endif
+
+#if include_p256_basemult_batch || include_p256_sign_batch || (include_p256_verify && use_affine_verify_pk_table) || include_p256_ecdh_precomp
+// Same as above, for points stored as [3][8] arrays. The affine x and y are stored in points[i][0] and points[i][1].
+static void jacobian_to_affine_batch(uint32_t (*points)[3][8], uint32_t num_points, uint32_t (*scratch)[8], bool var_time) {
+    batch_to_affine((uint32_t*)points, 24, (uint32_t*)points + 16, 24, num_points, scratch, var_time);
+}
 #endif
 
 void p256_convert_endianness(void* output, const void* input, size_t byte_len) {
@@ -434,33 +885,111 @@ void p256_convert_endianness(void* output, const void* input, size_t byte_len) {
     }
 }
 
-#if include_p256_verify
-bool p256_verify(const uint32_t public_key_x[8], const uint32_t public_key_y[8], const uint8_t* hash, uint32_t hashlen_in_bytes, const uint32_t r[8], const uint32_t s[8]) {
-    if (!P256_check_range_n(r) || !P256_check_range_n(s)) {
-        return false;
+#if include_p256_sha256
+// SHA-256, used by p256_verify_init/update/final and for the HMAC-SHA256 of RFC 6979.
+// The compression function is implemented by the backend (P256_sha256_compress).
+
+static void sha256_init(struct P256Sha256* state) {
+    static const uint32_t iv[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    memcpy(state->h, iv, 32);
+    state->total_len = 0;
+    state->buflen = 0;
+}
+
+static void sha256_update(struct P256Sha256* state, const uint8_t* data, uint32_t len) {
+    if (len == 0) {
+        return;
     }
-    
+    state->total_len += len;
+    if (state->buflen != 0) {
+        uint32_t n = 64 - state->buflen < len ? 64 - state->buflen : len;
+        memcpy(state->buf + state->buflen, data, n);
+        state->buflen += n;
+        data += n;
+        len -= n;
+        if (state->buflen != 64) {
+            return;
+        }
+        P256_sha256_compress(state->h, state->buf, 1);
+        state->buflen = 0;
+    }
+    if (len >= 64) {
+        if (((uintptr_t)data & 3) == 0) {
+            // Whole blocks are processed in place, so that e.g. memory mapped flash does not need to be copied
+            P256_sha256_compress(state->h, data, len / 64);
+            data += len & ~63;
+            len &= 63;
+        } else {
+            while (len >= 64) {
+                memcpy(state->buf, data, 64);
+                P256_sha256_compress(state->h, state->buf, 1);
+                data += 64;
+                len -= 64;
+            }
+        }
+    }
+    memcpy(state->buf, data, len);
+    state->buflen = len;
+}
+
+static void sha256_final(struct P256Sha256* state, uint8_t out[32]) {
+    // Append 0x80, zeros and the message length in bits as a 64-bit big endian integer
+    uint64_t bit_len = state->total_len << 3;
+    uint32_t pad_len = (state->buflen < 56 ? 56 : 120) - state->buflen;
+    uint8_t pad[72] = {0x80};
+    for (int i = 0; i < 8; i++) {
+        pad[pad_len + i] = (uint8_t)(bit_len >> (56 - 8 * i));
+    }
+    sha256_update(state, pad, pad_len + 8);
+    for (int i = 0; i < 8; i++) {
+        out[4 * i] = (uint8_t)(state->h[i] >> 24);
+        out[4 * i + 1] = (uint8_t)(state->h[i] >> 16);
+        out[4 * i + 2] = (uint8_t)(state->h[i] >> 8);
+        out[4 * i + 3] = (uint8_t)state->h[i];
+    }
+}
+#endif
+
+#if include_p256_verify || (include_p256_ecdh && include_p256_resumable)
+// Validates the public key and stores it in jacobian coordinates (with Z set to 1) in Montgomery form.
+static bool load_public_key(uint32_t pk[3][8], const uint32_t public_key_x[8], const uint32_t public_key_y[8]) {
     if (!P256_check_range_p(public_key_x) || !P256_check_range_p(public_key_y)) {
         return false;
     }
     
-    uint32_t pk_table[8][3][8];
-    P256_to_montgomery(pk_table[0][0], public_key_x);
-    P256_to_montgomery(pk_table[0][1], public_key_y);
-    memcpy(pk_table[0][2], one_montgomery, 32);
-    
-    if (!P256_point_is_on_curve(pk_table[0][0], pk_table[0][1])) {
-        return false;
-    }
+    P256_to_montgomery(pk[0], public_key_x);
+    P256_to_montgomery(pk[1], public_key_y);
+    memcpy(pk[2], one_montgomery, 32);
     
-    // Create a table of P, 3P, 5P, ..., 15P, where P is the public key.
-    P256_double_j(pk_table[7], (constarr)pk_table[0]);
+    return P256_point_is_on_curve(pk[0], pk[1]);
+}
+#endif
+
+#if include_p256_verify
+// Creates a table of P, 3P, 5P, ..., 15P, where P is located in table[0] (with Z set to 1 in Montgomery form).
+static void create_odd_multiples_table(uint32_t (*table)[3][8]) {
+    STATS_BEGIN_PHASE();
+    P256_double_j(table[7], (constarr)table[0]);
     for (int i = 1; i < 8; i++) {
-        memcpy(pk_table[i], pk_table[7], 96);
-        P256_add_sub_j(pk_table[i], (constarr)pk_table[i - 1], 0, 0);
+        memcpy(table[i], table[7], 96);
+        P256_add_sub_j(table[i], (constarr)table[i - 1], 0, 0);
+    }
+    STATS_END_PHASE(P256_STATS_PHASE_TABLE);
+}
+
+// Validates the public key and creates a table of P, 3P, 5P, ..., 15P, where P is the public key.
+static bool create_public_key_table(uint32_t pk_table[8][3][8], const uint32_t public_key_x[8], const uint32_t public_key_y[8]) {
+    if (!load_public_key(pk_table[0], public_key_x, public_key_y)) {
+        return false;
     }
     
-    uint32_t z[8], w[8], u1[8], u2[8];
+    create_odd_multiples_table(pk_table);
+    return true;
+}
+
+// Calculates u1 = z/s and u2 = r/s (mod n), where z is derived from the hash.
+static void calc_u1_u2(uint32_t u1[8], uint32_t u2[8], const uint8_t* hash, uint32_t hashlen_in_bytes, const uint32_t r[8], const uint32_t s[8]) {
+    uint32_t z[8], w[8];
     
     hash_to_z(z, hash, hashlen_in_bytes);
     
@@ -473,61 +1002,369 @@ bool p256_verify(const uint32_t public_key_x[8], const uint32_t public_key_y[8],
     
     P256_mul_mod_n(u1, z, w);
     P256_mul_mod_n(u2, r, w);
+}
+
+// Performs iteration i (256 >= i >= 0) of the calculation of u1*G + u2*P, given the sliding window representations of u1 and u2.
+static void verify_step(uint32_t cp[3][8], const signed char slide_bp[257], const signed char slide_pk[257], const uint32_t* pk_table, uint32_t pk_num_coordinates, int i) {
+    bool pk_is_affine = pk_num_coordinates == 2;
     
-    // Each value in these arrays will be an odd integer v, so that -15 <= v <= 15.
+    P256_double_j(cp, (constarr)cp);
+    if (slide_bp[i] > 0) {
+        P256_add_sub_j(cp, p256_basepoint_precomp[slide_bp[i]/2], 0, 1);
+    } else if (slide_bp[i] < 0) {
+        P256_add_sub_j(cp, p256_basepoint_precomp[(-slide_bp[i])/2], 1, 1);
+    }
+    if (slide_pk[i] > 0) {
+        P256_add_sub_j(cp, (constarr)(pk_table + (slide_pk[i]/2) * pk_num_coordinates * 8), 0, pk_is_affine);
+    } else if (slide_pk[i] < 0) {
+        P256_add_sub_j(cp, (constarr)(pk_table + ((-slide_pk[i])/2) * pk_num_coordinates * 8), 1, pk_is_affine);
+    }
+}
+
+// Calculates u1*G + u2*P and checks that the x coordinate of the result matches r.
+// The pk_table contains P, 3P, 5P, ..., (2^pk_window_bits-1)P, where each point has pk_num_coordinates coordinates
+// (2 if the points are in affine coordinates, 3 if they are in jacobian coordinates).
+static bool verify_with_public_key_table(const uint32_t r[8], const uint32_t u1[8], const uint32_t u2[8], const uint32_t* pk_table, uint32_t pk_num_coordinates, int pk_window_bits) {
+    // Each value in these arrays will be an odd integer v, so that -15 <= v <= 15 (for the default window size of 4).
     // Around 1/5.5 of them will be non-zero.
     signed char slide_bp[257], slide_pk[257];
-    slide_257(slide_bp, (uint8_t*)u1);
-    slide_257(slide_pk, (uint8_t*)u2);
+    slide_257(slide_bp, (uint8_t*)u1, verify_basepoint_window_bits);
+    slide_257(slide_pk, (uint8_t*)u2, pk_window_bits);
     
     uint32_t cp[3][8] = {0};
     
+    STATS_BEGIN_PHASE();
     for (int i = 256; i >= 0; i--) {
-        P256_double_j(cp, (constarr)cp);
-        if (slide_bp[i] > 0) {
-            P256_add_sub_j(cp, p256_basepoint_precomp[slide_bp[i]/2], 0, 1);
-        } else if (slide_bp[i] < 0) {
-            P256_add_sub_j(cp, p256_basepoint_precomp[(-slide_bp[i])/2], 1, 1);
-        }
-        if (slide_pk[i] > 0) {
-            P256_add_sub_j(cp, (constarr)pk_table[slide_pk[i]/2], 0, 0);
-        } else if (slide_pk[i] < 0) {
-            P256_add_sub_j(cp, (constarr)pk_table[(-slide_pk[i])/2], 1, 0);
-        }
+        verify_step(cp, slide_bp, slide_pk, pk_table, pk_num_coordinates, i);
     }
+    STATS_END_PHASE(P256_STATS_PHASE_MAIN_LOOP);
     
-    return P256_verify_last_step(r, (constarr)cp);
+    STATS_BEGIN_PHASE();
+    bool ok = P256_verify_last_step(r, (constarr)cp);
+    STATS_END_PHASE(P256_STATS_PHASE_TO_AFFINE);
+    return ok;
 }
-#endif
 
-#if include_p256_sign
-bool p256_sign_step1(struct SignPrecomp *result, const uint32_t k[8]) {
-    do {
-        uint32_t point_res[2][8];
-        if (!P256_check_range_n(k)) {
-            break;
-        }
-        scalarmult_fixed_base(point_res[0], point_res[1], k);
-        P256_mod_n_inv(result->k_inv, k);
-        P256_from_montgomery(result->r, point_res[0]);
-        P256_reduce_mod_n_32bytes(result->r, result->r);
-        
-        uint32_t r_sum = 0;
-        for (int i = 0; i < 8; i++) {
-            r_sum |= result->r[i];
-        }
-        if (r_sum == 0) {
-            break;
-        }
-        return true;
-    } while (false);
+bool p256_verify(const uint32_t public_key_x[8], const uint32_t public_key_y[8], const uint8_t* hash, uint32_t hashlen_in_bytes, const uint32_t r[8], const uint32_t s[8]) {
+    if (!P256_check_range_n(r) || !P256_check_range_n(s)) {
+        return false;
+    }
     
-    memset(result, 0, sizeof(struct SignPrecomp));
-    return false;
-}
-
-bool p256_sign_step2(uint32_t r[8], uint32_t s[8], const uint8_t* hash, uint32_t hashlen_in_bytes, const uint32_t private_key[8], struct SignPrecomp *sign_precomp) {
-    do {
+    uint32_t pk_table[8][3][8];
+    if (!create_public_key_table(pk_table, public_key_x, public_key_y)) {
+        return false;
+    }
+    
+    uint32_t u1[8], u2[8];
+    calc_u1_u2(u1, u2, hash, hashlen_in_bytes, r, s);
+    
+#if use_affine_verify_pk_table
+    // P already has Z = 1. Convert 3P, 5P, ..., 15P to affine coordinates and pack the table as [8][2][8].
+    uint32_t scratch[7][8];
+    jacobian_to_affine_batch(pk_table + 1, 7, scratch, true);
+    for (int i = 1; i < 8; i++) {
+        memmove((uint32_t*)pk_table + i * 16, pk_table[i], 64);
+    }
+    return verify_with_public_key_table(r, u1, u2, (uint32_t*)pk_table, 2, 4);
+#else
+    return verify_with_public_key_table(r, u1, u2, (uint32_t*)pk_table, 3, 4);
+#endif
+}
+#endif
+
+#if include_p256_verify_precomp
+bool p256_verify_precompute_public_key(struct PublicKeyPrecomp* result, const uint32_t public_key_x[8], const uint32_t public_key_y[8]) {
+    if (!P256_check_range_p(public_key_x) || !P256_check_range_p(public_key_y)) {
+        return false;
+    }
+    
+    P256_to_montgomery(result->table[0][0], public_key_x);
+    P256_to_montgomery(result->table[0][1], public_key_y);
+    
+    if (!P256_point_is_on_curve(result->table[0][0], result->table[0][1])) {
+        return false;
+    }
+    
+    // Calculate 2P, and then repeatedly add it to get 3P, 5P, 7P, ...
+    // Since the table is meant to be reused for many signatures, the points are converted to affine coordinates,
+    // which makes the additions during verification faster. The X and Y coordinates are placed directly in the table
+    // and the Z coordinates are kept aside, so that all points can share one field inversion.
+    uint32_t double_point[3][8], current_point[3][8];
+    uint32_t z[(1 << (verify_precomp_window_bits - 1)) - 1][8], scratch[(1 << (verify_precomp_window_bits - 1)) - 1][8];
+    memcpy(current_point, result->table[0], 64);
+    memcpy(current_point[2], one_montgomery, 32);
+    P256_double_j(double_point, (constarr)current_point);
+    
+    for (int i = 1; i < (1 << (verify_precomp_window_bits - 1)); i++) {
+        P256_add_sub_j(current_point, (constarr)double_point, 0, 0);
+        memcpy(result->table[i], current_point, 64);
+        memcpy(z[i - 1], current_point[2], 32);
+    }
+    batch_to_affine((uint32_t*)result->table + 16, 16, (uint32_t*)z, 8, (1 << (verify_precomp_window_bits - 1)) - 1, scratch, true);
+    
+    return true;
+}
+
+bool p256_verify_precomp(const struct PublicKeyPrecomp* public_key_precomp, const uint8_t* hash, uint32_t hashlen_in_bytes, const uint32_t r[8], const uint32_t s[8]) {
+    if (!P256_check_range_n(r) || !P256_check_range_n(s)) {
+        return false;
+    }
+    
+    uint32_t u1[8], u2[8];
+    calc_u1_u2(u1, u2, hash, hashlen_in_bytes, r, s);
+    
+    return verify_with_public_key_table(r, u1, u2, (const uint32_t*)public_key_precomp->table, 2, verify_precomp_window_bits);
+}
+#endif
+
+#if include_p256_verify_stream
+void p256_verify_init(struct P256VerifyStream* stream) {
+    sha256_init(&stream->sha256);
+}
+
+void p256_verify_update(struct P256VerifyStream* stream, const uint8_t* data, uint32_t len) {
+    sha256_update(&stream->sha256, data, len);
+}
+
+bool p256_verify_final(struct P256VerifyStream* stream, const uint32_t public_key_x[8], const uint32_t public_key_y[8], const uint32_t r[8], const uint32_t s[8]) {
+    uint8_t hash[32];
+    sha256_final(&stream->sha256, hash);
+    return p256_verify(public_key_x, public_key_y, hash, 32, r, s);
+}
+#endif
+
+#if include_p256_verify_batch
+struct VerifyBatchState {
+    uint32_t pk_table[8][3][8]; // P, 3P, 5P, ..., 15P
+    uint32_t R_table[8][3][8]; // R, 3R, 5R, ..., 15R
+    signed char slide_pk[257]; // a*u2
+    signed char slide_R[257]; // a
+};
+
+// Prepares a signature for being part of a combined check, and adds a*u1 to sum_a_u1, where a is the random coefficient.
+// Returns false if the signature must instead be verified individually,
+// i.e. when it is obviously invalid, the parity of R is unknown or R cannot be recovered from r.
+static bool verify_batch_prepare(struct VerifyBatchState* state, uint32_t sum_a_u1[8], const struct VerifyBatchItem* item, const uint32_t random[4]) {
+    if (item->r_y_parity > 1 || !P256_check_range_n(item->r) || !P256_check_range_n(item->s)) {
+        return false;
+    }
+    
+    // Recover R from its x coordinate. Since r < n < p, r is a valid field element.
+    // Note that the x coordinate could also be r+n in the unlikely case that r+n < p, which p256_verify handles.
+    uint32_t R_y[8];
+    if (!P256_decompress_point(R_y, item->r, item->r_y_parity)) {
+        return false;
+    }
+    
+    if (!create_public_key_table(state->pk_table, item->public_key_x, item->public_key_y)) {
+        return false;
+    }
+    
+    P256_to_montgomery(state->R_table[0][0], item->r);
+    P256_to_montgomery(state->R_table[0][1], R_y);
+    memcpy(state->R_table[0][2], one_montgomery, 32);
+    create_odd_multiples_table(state->R_table);
+    
+    // The top bit is set so that the coefficient is never 0.
+    uint32_t a[8] = {random[0], random[1], random[2], random[3] | 0x80000000, 0, 0, 0, 0};
+    
+    uint32_t u1[8], u2[8];
+    calc_u1_u2(u1, u2, item->hash, item->hashlen_in_bytes, item->r, item->s);
+    P256_mul_mod_n(u1, u1, a);
+    P256_add_mod_n(sum_a_u1, sum_a_u1, u1);
+    P256_mul_mod_n(u2, u2, a);
+    
+    slide_257(state->slide_pk, (uint8_t*)u2, 4);
+    slide_257(state->slide_R, (uint8_t*)a, 4);
+    return true;
+}
+
+// Calculates sum(a[i]*u1[i])*G + sum(a[i]*u2[i]*P[i]) - sum(a[i]*R[i]) using a single chain of doublings,
+// and returns true if the result is the point at infinity.
+static bool verify_batch_check(const struct VerifyBatchState* states, uint32_t count, const uint32_t sum_a_u1[8]) {
+    signed char slide_bp[257];
+    slide_257(slide_bp, (const uint8_t*)sum_a_u1, verify_basepoint_window_bits);
+    
+    uint32_t cp[3][8] = {0};
+    
+    for (int i = 256; i >= 0; i--) {
+        P256_double_j(cp, (constarr)cp);
+        if (slide_bp[i] > 0) {
+            P256_add_sub_j(cp, p256_basepoint_precomp[slide_bp[i]/2], 0, 1);
+        } else if (slide_bp[i] < 0) {
+            P256_add_sub_j(cp, p256_basepoint_precomp[(-slide_bp[i])/2], 1, 1);
+        }
+        for (uint32_t j = 0; j < count; j++) {
+            const struct VerifyBatchState* st = &states[j];
+            if (st->slide_pk[i] > 0) {
+                P256_add_sub_j(cp, (constarr)st->pk_table[st->slide_pk[i]/2], 0, 0);
+            } else if (st->slide_pk[i] < 0) {
+                P256_add_sub_j(cp, (constarr)st->pk_table[(-st->slide_pk[i])/2], 1, 0);
+            }
+            // The R terms are subtracted
+            if (st->slide_R[i] > 0) {
+                P256_add_sub_j(cp, (constarr)st->R_table[st->slide_R[i]/2], 1, 0);
+            } else if (st->slide_R[i] < 0) {
+                P256_add_sub_j(cp, (constarr)st->R_table[(-st->slide_R[i])/2], 0, 0);
+            }
+        }
+    }
+    
+    uint32_t z_sum = 0;
+    for (int i = 0; i < 8; i++) {
+        z_sum |= cp[2][i];
+    }
+    return z_sum == 0;
+}
+
+static bool verify_batch_item_individually(const struct VerifyBatchItem* item) {
+    return p256_verify(item->public_key_x, item->public_key_y, item->hash, item->hashlen_in_bytes, item->r, item->s);
+}
+
+bool p256_verify_batch(bool results[], const struct VerifyBatchItem items[], uint32_t num_items, const uint32_t random[][4]) {
+    bool all_valid = true;
+    uint32_t i = 0;
+    
+    while (i < num_items) {
+        if (num_items - i == 1) {
+            // A batch of one signature is slower than a plain verification
+            results[i] = verify_batch_item_individually(&items[i]);
+            all_valid &= results[i];
+            break;
+        }
+        
+        struct VerifyBatchState states[verify_batch_chunk_size];
+        uint32_t indices[verify_batch_chunk_size];
+        uint32_t sum_a_u1[8] = {0};
+        uint32_t count = 0;
+        
+        for (; i < num_items && count < verify_batch_chunk_size; i++) {
+            if (verify_batch_prepare(&states[count], sum_a_u1, &items[i], random[i])) {
+                indices[count++] = i;
+            } else {
+                results[i] = verify_batch_item_individually(&items[i]);
+                all_valid &= results[i];
+            }
+        }
+        
+        if (count != 0) {
+            bool chunk_valid = verify_batch_check(states, count, sum_a_u1);
+            for (uint32_t j = 0; j < count; j++) {
+                // If the combined check failed, find out which of the signatures are invalid
+                results[indices[j]] = chunk_valid || verify_batch_item_individually(&items[indices[j]]);
+                all_valid &= results[indices[j]];
+            }
+        }
+    }
+    
+    return all_valid;
+}
+#endif
+
+#if include_p256_sign
+// Calculates r = x mod n, where x is the affine x coordinate of k*G in Montgomery form.
+// Returns false if r is 0.
+static bool calc_r(uint32_t r[8], const uint32_t x_mont[8]) {
+    P256_from_montgomery(r, x_mont);
+    P256_reduce_mod_n_32bytes(r, r);
+    
+    uint32_t r_sum = 0;
+    for (int i = 0; i < 8; i++) {
+        r_sum |= r[i];
+    }
+    return r_sum != 0;
+}
+
+bool p256_sign_step1(struct SignPrecomp *result, const uint32_t k[8]) {
+    do {
+        uint32_t point_res[2][8];
+        if (!P256_check_range_n(k)) {
+            break;
+        }
+        scalarmult_fixed_base(point_res[0], point_res[1], k);
+        P256_mod_n_inv(result->k_inv, k);
+        if (!calc_r(result->r, point_res[0])) {
+            break;
+        }
+        return true;
+    } while (false);
+    
+    memset(result, 0, sizeof(struct SignPrecomp));
+    return false;
+}
+
+#if include_p256_sign_batch
+bool p256_sign_step1_batch(bool results[], struct SignPrecomp result[], const uint32_t k[][8], uint32_t num_k, const uint32_t random[8]) {
+    bool all_valid = true;
+    uint32_t i = 0;
+    
+    // The blinding factor must be non-zero mod n, which a random value only fails to be with negligible probability
+    uint32_t blinding[8], is_zero = 0;
+    P256_reduce_mod_n_32bytes(blinding, random);
+    for (int j = 0; j < 8; j++) {
+        is_zero |= blinding[j];
+    }
+    blinding[0] |= is_zero == 0;
+    
+    while (i < num_k) {
+        uint32_t points[basemult_batch_chunk_size][3][8];
+        uint32_t scratch[basemult_batch_chunk_size][8];
+        uint32_t indices[basemult_batch_chunk_size];
+        uint32_t count = 0;
+        
+        for (; i < num_k && count < basemult_batch_chunk_size; i++) {
+            if (P256_check_range_n(k[i])) {
+                scalarmult_fixed_base_jacobian(points[count], k[i]);
+                indices[count++] = i;
+            } else {
+                memset(&result[i], 0, sizeof(struct SignPrecomp));
+                results[i] = false;
+                all_valid = false;
+            }
+        }
+        
+        if (count == 0) {
+            continue;
+        }
+        
+        jacobian_to_affine_batch(points, count, scratch, false);
+        
+        // Invert all k values mod n using one inversion, in the same way as in jacobian_to_affine_batch.
+        // The k_inv fields first hold the running products k[0] * k[1] * ... * k[j].
+        // The product is multiplied by the blinding factor before it is inverted, and the inverse by the same factor
+        // afterwards, so that the value passed to the inversion does not depend on the k values alone.
+        memcpy(result[indices[0]].k_inv, k[indices[0]], 32);
+        for (uint32_t j = 1; j < count; j++) {
+            P256_mul_mod_n(result[indices[j]].k_inv, result[indices[j - 1]].k_inv, k[indices[j]]);
+        }
+        uint32_t inv[8], blinded[8];
+        P256_mul_mod_n(blinded, result[indices[count - 1]].k_inv, blinding);
+        P256_mod_n_inv(inv, blinded);
+        P256_mul_mod_n(inv, inv, blinding);
+        for (uint32_t j = count; j --> 1;) {
+            P256_mul_mod_n(result[indices[j]].k_inv, inv, result[indices[j - 1]].k_inv);
+            P256_mul_mod_n(inv, inv, k[indices[j]]);
+        }
+        memcpy(result[indices[0]].k_inv, inv, 32);
+        memset(inv, 0, sizeof(inv));
+        memset(blinded, 0, sizeof(blinded));
+        
+        for (uint32_t j = 0; j < count; j++) {
+            results[indices[j]] = calc_r(result[indices[j]].r, points[j][0]);
+            if (!results[indices[j]]) {
+                memset(&result[indices[j]], 0, sizeof(struct SignPrecomp));
+                all_valid = false;
+            }
+        }
+    }
+    
+    memset(blinding, 0, sizeof(blinding));
+    return all_valid;
+}
+#endif
+
+bool p256_sign_step2(uint32_t r[8], uint32_t s[8], const uint8_t* hash, uint32_t hashlen_in_bytes, const uint32_t private_key[8], struct SignPrecomp *sign_precomp) {
+    do {
         if (!P256_check_range_n(sign_precomp->k_inv) || !P256_check_range_n(sign_precomp->r)) { // just make sure user did not input an obviously invalid precomp
             break;
         }
@@ -564,6 +1401,220 @@ bool p256_sign(uint32_t r[8], uint32_t s[8], const uint8_t* hash, uint32_t hashl
     }
     return p256_sign_step2(r, s, hash, hashlen_in_bytes, private_key, &t);
 }
+
+#if include_p256_sign_deterministic
+// HMAC-SHA256 with a 32 byte key, with the inner and outer hash states precomputed after the padded key block
+struct HmacSha256Key {
+    struct P256Sha256 inner, outer;
+};
+
+static void hmac_sha256_set_key(struct HmacSha256Key* hmac_key, const uint8_t key[32]) {
+    uint8_t block[64];
+    for (int i = 0; i < 64; i++) {
+        block[i] = (i < 32 ? key[i] : 0) ^ 0x36;
+    }
+    sha256_init(&hmac_key->inner);
+    sha256_update(&hmac_key->inner, block, 64);
+    for (int i = 0; i < 64; i++) {
+        block[i] ^= 0x36 ^ 0x5c;
+    }
+    sha256_init(&hmac_key->outer);
+    sha256_update(&hmac_key->outer, block, 64);
+    memset(block, 0, sizeof(block));
+}
+
+// Calculates HMAC(key, v || suffix)
+static void hmac_sha256(uint8_t out[32], const struct HmacSha256Key* hmac_key, const uint8_t v[32], const uint8_t* suffix, uint32_t suffix_len) {
+    struct P256Sha256 state = hmac_key->inner;
+    uint8_t inner_hash[32];
+    sha256_update(&state, v, 32);
+    sha256_update(&state, suffix, suffix_len);
+    sha256_final(&state, inner_hash);
+    state = hmac_key->outer;
+    sha256_update(&state, inner_hash, 32);
+    sha256_final(&state, out);
+    memset(&state, 0, sizeof(state));
+    memset(inner_hash, 0, sizeof(inner_hash));
+}
+
+// Performs K = HMAC_K(V || sep || x || h) followed by V = HMAC_K(V), as in RFC 6979 section 3.2, steps d-g,
+// or K = HMAC_K(V || sep) followed by V = HMAC_K(V) if x is NULL, as in step h.3
+static void rfc6979_update(struct HmacSha256Key* hmac_key, uint8_t v[32], uint8_t sep, const uint8_t x[32], const uint8_t h[32]) {
+    uint8_t suffix[65], key[32];
+    suffix[0] = sep;
+    if (x != NULL) {
+        memcpy(suffix + 1, x, 32);
+        memcpy(suffix + 33, h, 32);
+    }
+    hmac_sha256(key, hmac_key, v, suffix, x != NULL ? 65 : 1);
+    hmac_sha256_set_key(hmac_key, key);
+    hmac_sha256(v, hmac_key, v, NULL, 0);
+    memset(suffix, 0, sizeof(suffix));
+    memset(key, 0, sizeof(key));
+}
+
+bool p256_sign_deterministic(uint32_t r[8], uint32_t s[8], const uint8_t* hash, uint32_t hashlen_in_bytes, const uint32_t private_key[8]) {
+    if (!P256_check_range_n(private_key)) {
+        memset(r, 0, 32);
+        memset(s, 0, 32);
+        return false;
+    }
+    
+    // int2octets(x) and bits2octets(h1), where the latter is the (truncated) hash reduced mod n
+    uint8_t x[32], h[32];
+    uint32_t z[8];
+    p256_convert_endianness(x, private_key, 32);
+    hash_to_z(z, hash, hashlen_in_bytes);
+    P256_reduce_mod_n_32bytes(z, z);
+    p256_convert_endianness(h, z, 32);
+    
+    struct HmacSha256Key hmac_key;
+    uint8_t v[32];
+    memset(v, 0, 32);
+    hmac_sha256_set_key(&hmac_key, v);
+    memset(v, 1, 32);
+    rfc6979_update(&hmac_key, v, 0, x, h);
+    rfc6979_update(&hmac_key, v, 1, x, h);
+    
+    bool ok;
+    for (;;) {
+        // Since qlen = hlen = 256, one HMAC output gives the candidate k directly
+        uint32_t k[8];
+        struct SignPrecomp t;
+        hmac_sha256(v, &hmac_key, v, NULL, 0);
+        p256_convert_endianness(k, v, 32);
+        ok = p256_sign_step1(&t, k) && p256_sign_step2(r, s, hash, hashlen_in_bytes, private_key, &t);
+        // p256_sign_step2 leaves the precomputed k^-1 and r in place when it fails
+        memset(k, 0, sizeof(k));
+        memset(&t, 0, sizeof(t));
+        if (ok) {
+            break;
+        }
+        // k was not in the range 1 to n-1, or r or s would be 0, so the next candidate is generated
+        rfc6979_update(&hmac_key, v, 0, NULL, NULL);
+    }
+    
+    memset(x, 0, sizeof(x));
+    memset(h, 0, sizeof(h));
+    memset(z, 0, sizeof(z));
+    memset(&hmac_key, 0, sizeof(hmac_key));
+    memset(v, 0, sizeof(v));
+    return ok;
+}
+#endif
+
+#if include_p256_sign_pool
+// Ring buffer of precomputed states, where the oldest state is located at index sign_pool_start
+static struct SignPrecomp sign_pool[sign_pool_size];
+static uint32_t sign_pool_start, sign_pool_count;
+static p256_random_bytes_fn sign_pool_random;
+static void* sign_pool_random_ctx;
+static uint32_t sign_pool_hits, sign_pool_misses;
+
+static bool sign_pool_random_k(uint32_t k[8]) {
+    return sign_pool_random != NULL && sign_pool_random(sign_pool_random_ctx, (uint8_t*)k, 32);
+}
+
+// Creates a state from a new random k, retrying with a new k in the unlikely case k is not usable.
+static bool sign_pool_precompute(struct SignPrecomp* result) {
+    uint32_t k[8];
+    bool ok;
+    do {
+        ok = sign_pool_random_k(k);
+    } while (ok && !p256_sign_step1(result, k));
+    memset(k, 0, sizeof(k));
+    return ok;
+}
+
+void p256_sign_pool_init(p256_random_bytes_fn random, void* random_ctx) {
+    memset(sign_pool, 0, sizeof(sign_pool));
+    sign_pool_start = 0;
+    sign_pool_count = 0;
+    sign_pool_random = random;
+    sign_pool_random_ctx = random_ctx;
+    sign_pool_hits = 0;
+    sign_pool_misses = 0;
+}
+
+uint32_t p256_sign_pool_refill(uint32_t max_entries) {
+    while (max_entries != 0 && sign_pool_count < sign_pool_size) {
+        uint32_t n = sign_pool_size - sign_pool_count;
+        if (n > max_entries) {
+            n = max_entries;
+        }
+        #if include_p256_sign_batch
+        // Create the states in batches, so that the inversions are shared
+        if (n > basemult_batch_chunk_size) {
+            n = basemult_batch_chunk_size;
+        }
+        uint32_t k[basemult_batch_chunk_size][8], blinding[8] = {1};
+        struct SignPrecomp precomp[basemult_batch_chunk_size];
+        bool results[basemult_batch_chunk_size];
+        uint32_t num_k = 0;
+        // A single k is inverted on its own, as in p256_sign_step1, so the blinding factor is only needed for more
+        if (n > 1 && !sign_pool_random_k(blinding)) {
+            break;
+        }
+        while (num_k < n && sign_pool_random_k(k[num_k])) {
+            num_k++;
+        }
+        // States whose k was not usable are skipped, the pool is then refilled with fewer entries
+        bool all_created = p256_sign_step1_batch(results, precomp, k, num_k, blinding);
+        for (uint32_t i = 0; i < num_k; i++) {
+            if (all_created || results[i]) {
+                sign_pool[(sign_pool_start + sign_pool_count) % sign_pool_size] = precomp[i];
+                sign_pool_count++;
+                max_entries--;
+            }
+        }
+        memset(k, 0, sizeof(k));
+        memset(blinding, 0, sizeof(blinding));
+        memset(precomp, 0, sizeof(precomp));
+        if (num_k < n) {
+            break;
+        }
+        #else
+        (void)n;
+        if (!sign_pool_precompute(&sign_pool[(sign_pool_start + sign_pool_count) % sign_pool_size])) {
+            break;
+        }
+        sign_pool_count++;
+        max_entries--;
+        #endif
+    }
+    return sign_pool_count;
+}
+
+bool p256_sign_fast(uint32_t r[8], uint32_t s[8], const uint8_t* hash, uint32_t hashlen_in_bytes, const uint32_t private_key[8]) {
+    for (;;) {
+        struct SignPrecomp t;
+        struct SignPrecomp* precomp = &t;
+        if (sign_pool_count != 0) {
+            // p256_sign_step2 zeroes out the state in the pool
+            precomp = &sign_pool[sign_pool_start];
+            sign_pool_start = (sign_pool_start + 1) % sign_pool_size;
+            sign_pool_count--;
+            sign_pool_hits++;
+        } else {
+            sign_pool_misses++;
+            if (!sign_pool_precompute(&t)) {
+                memset(r, 0, 32);
+                memset(s, 0, 32);
+                return false;
+            }
+        }
+        if (p256_sign_step2(r, s, hash, hashlen_in_bytes, private_key, precomp)) {
+            return true;
+        }
+    }
+}
+
+void p256_sign_pool_get_stats(struct P256SignPoolStats* stats) {
+    stats->hits = sign_pool_hits;
+    stats->misses = sign_pool_misses;
+    stats->available = sign_pool_count;
+}
+#endif
 #endif
 
 #if include_p256_keygen || include_p256_raw_scalarmult_base
@@ -585,8 +1636,47 @@ bool p256_keygen(uint32_t public_key_x[8], uint32_t public_key_y[8], const uint3
 #endif
 #endif
 
+#if include_p256_basemult_batch
+bool p256_scalarmult_base_batch(bool results[], uint32_t result_x[][8], uint32_t result_y[][8], const uint32_t scalars[][8], uint32_t num_scalars) {
+    bool all_valid = true;
+    uint32_t i = 0;
+    
+    while (i < num_scalars) {
+        uint32_t points[basemult_batch_chunk_size][3][8];
+        uint32_t scratch[basemult_batch_chunk_size][8];
+        uint32_t indices[basemult_batch_chunk_size];
+        uint32_t count = 0;
+        
+        for (; i < num_scalars && count < basemult_batch_chunk_size; i++) {
+            results[i] = P256_check_range_n(scalars[i]);
+            all_valid &= results[i];
+            if (results[i]) {
+                scalarmult_fixed_base_jacobian(points[count], scalars[i]);
+                indices[count++] = i;
+            }
+        }
+        
+        if (count != 0) {
+            jacobian_to_affine_batch(points, count, scratch, false);
+            for (uint32_t j = 0; j < count; j++) {
+                P256_from_montgomery(result_x[indices[j]], points[j][0]);
+                P256_from_montgomery(result_y[indices[j]], points[j][1]);
+            }
+        }
+    }
+    
+    return all_valid;
+}
 
-#if include_p256_varmult
+#if include_p256_keygen_batch
+bool p256_keygen_batch(bool results[], uint32_t public_keys_x[][8], uint32_t public_keys_y[][8], const uint32_t private_keys[][8], uint32_t num_keys) {
+    return p256_scalarmult_base_batch(results, public_keys_x, public_keys_y, private_keys, num_keys);
+}
+#endif
+#endif
+
+
+#if include_p256_varmult_blocking
 static bool p256_scalarmult_generic_no_scalar_check(uint32_t output_mont_x[8], uint32_t output_mont_y[8], const uint32_t scalar[8], const uint32_t in_x[8], const uint32_t in_y[8]) {
     if (!P256_check_range_p(in_x) || !P256_check_range_p(in_y)) {
         return false;
@@ -614,16 +1704,331 @@ bool p256_scalarmult_generic(uint32_t result_x[8], uint32_t result_y[8], const u
 }
 #endif
 
+#endif
+
+#if include_p256_xycz_ladder
+// (n-1)/2
+static const uint32_t p256_half_order[8] = {0x7e3192a8, 0x79dce561, 0xd38bcf42, 0xde737d56, 0xffffffff, 0x7fffffff, 0x80000000, 0x7fffffff};
+
+// 3*n
+static const uint32_t p256_three_times_order[9] = {0xf5296ff3, 0xdb2d6048, 0xf546db8e, 0x36b4f008, 0xffffffff, 0xffffffff, 0x00000002, 0xfffffffd, 0x00000002};
+
+// Calculates the x coordinate of scalar*P in constant time, where P is a point with the given x coordinate.
+// Returns false if the x coordinate does not belong to a point on the curve (but on the twist).
+static bool scalarmult_xonly(uint32_t output_mont_x[8], const uint32_t scalar[8], const uint32_t input_mont_x[8]) {
+    uint32_t scalar2[9];
+    uint32_t state[6][8];
+    
+    // Since x(k*P) = x(-k*P) = x((n-k)*P), the scalar can first be replaced by n-k if k > (n-1)/2.
+    // Adding 3*n then makes the scalar exactly 258 bits long, with the top bit set, without changing the result.
+    // This way the ladder always starts with (P, 2P) and never hits any exceptional case of the co-Z formulas.
+    uint32_t borrow = 0;
+    for (int i = 0; i < 8; i++) {
+        uint64_t diff = (uint64_t)p256_half_order[i] - scalar[i] - borrow;
+        borrow = diff >> 63;
+    }
+    P256_negate_mod_n_if(scalar2, scalar, borrow);
+    uint64_t carry = 0;
+    for (int i = 0; i < 8; i++) {
+        uint64_t sum = (uint64_t)scalar2[i] + p256_three_times_order[i] + carry;
+        scalar2[i] = (uint32_t)sum;
+        carry = sum >> 32;
+    }
+    scalar2[8] = p256_three_times_order[8] + (uint32_t)carry;
+    
+    memcpy(state[4], input_mont_x, 32);
+    P256_xycz_ladder_init(state);
+    
+    // R0 = P and R1 = 2P. In each step, the slots are swapped if the bit is 1, so that R1 = R0 + R1 and R0 = 2R0 is
+    // always computed. Instead of swapping back afterwards, the next swap is merged with the previous one.
+    uint32_t swapped = 0;
+    for (int i = 256; i >= 1; i--) {
+        uint32_t bit = get_bit(scalar2, i);
+        P256_xycz_ladder_step(state, bit ^ swapped);
+        swapped = bit;
+    }
+    uint32_t last_bit = get_bit(scalar2, 0);
+    return P256_xycz_ladder_final(output_mont_x, state, last_bit ^ swapped, last_bit);
+}
+#endif
+
 #if include_p256_ecdh
 bool p256_ecdh_calc_shared_secret(uint8_t shared_secret[32], const uint32_t private_key[8], const uint32_t others_public_key_x[8], const uint32_t others_public_key_y[8]) {
     uint32_t result_x[8], result_y[8];
+#if use_coz_ladder_ecdh
+    if (!P256_check_range_p(others_public_key_x) || !P256_check_range_p(others_public_key_y)) {
+        return false;
+    }
+    
+    P256_to_montgomery(result_x, others_public_key_x);
+    P256_to_montgomery(result_y, others_public_key_y);
+    
+    if (!P256_point_is_on_curve(result_x, result_y) || !scalarmult_xonly(result_x, private_key, result_x)) {
+        return false;
+    }
+#else
     if (!p256_scalarmult_generic_no_scalar_check(result_x, result_y, private_key, others_public_key_x, others_public_key_y)) {
         return false;
     }
+#endif
     P256_from_montgomery(result_x, result_x);
     p256_convert_endianness(shared_secret, result_x, 32);
     return true;
 }
+
+bool p256_ecdh_calc_shared_secret_compressed(uint8_t shared_secret[32], const uint32_t private_key[8], const uint8_t others_public_key[33]) {
+    uint32_t x[8];
+    if ((others_public_key[0] >> 1) != 1) {
+        return false;
+    }
+    p256_convert_endianness(x, others_public_key + 1, 32);
+    if (!P256_check_range_p(x)) {
+        return false;
+    }
+#if use_coz_ladder_ecdh
+    // The ladder itself rejects x coordinates of points on the twist, so no square root is needed here
+    P256_to_montgomery(x, x);
+    if (!scalarmult_xonly(x, private_key, x)) {
+        return false;
+    }
+    P256_from_montgomery(x, x);
+    p256_convert_endianness(shared_secret, x, 32);
+    return true;
+#else
+    uint32_t y[8];
+    if (!P256_decompress_point(y, x, others_public_key[0] & 1)) {
+        return false;
+    }
+    return p256_ecdh_calc_shared_secret(shared_secret, private_key, x, y);
+#endif
+}
+#endif
+
+#if include_p256_ecdh_precomp
+bool p256_fixed_point_precompute(struct FixedPointPrecomp* result, const uint32_t x[8], const uint32_t y[8]) {
+    // Table t contains the same combinations as p256_basepoint_precomp2, but of the point
+    // base = 2^(BASEMULT_NUM_STEPS * t) * P instead of the base point, where P is the input point.
+    uint32_t base[3][8];
+    if (!P256_check_range_p(x) || !P256_check_range_p(y)) {
+        return false;
+    }
+    P256_to_montgomery(base[0], x);
+    P256_to_montgomery(base[1], y);
+    memcpy(base[2], one_montgomery, 32);
+    if (!P256_point_is_on_curve(base[0], base[1])) {
+        return false;
+    }
+    
+    for (uint32_t t = 0; t < fast_basemult_comb_tables; t++) {
+        // terms[k] = 2^(k * COMB_SPACING) * base
+        uint32_t terms[fast_basemult_comb_teeth][3][8];
+        memcpy(terms[0], base, sizeof(base));
+        for (uint32_t k = 1; k < fast_basemult_comb_teeth; k++) {
+            P256_double_j(terms[k], (constarr)terms[k - 1]);
+            for (uint32_t i = 1; i < COMB_SPACING; i++) {
+                P256_double_j(terms[k], (constarr)terms[k]);
+            }
+        }
+        if (t != fast_basemult_comb_tables - 1) {
+            for (uint32_t i = 0; i < BASEMULT_NUM_STEPS; i++) {
+                P256_double_j(base, (constarr)base);
+            }
+        }
+        
+        // Entry m is the sum of all terms, where term k < T-1 is negated if bit k of m is 0.
+        // The entries are created in groups of 8, each of which is converted to affine coordinates using one inversion.
+        for (uint32_t group = 0; group < COMB_NUM_POINTS; group += 8) {
+            uint32_t points[8][3][8], scratch[8][8];
+            for (uint32_t i = 0; i < 8; i++) {
+                uint32_t m = group + i;
+                if (m == 0) {
+                    memcpy(points[0], terms[fast_basemult_comb_teeth - 1], sizeof(points[0]));
+                    for (uint32_t k = 0; k < fast_basemult_comb_teeth - 1; k++) {
+                        P256_add_sub_j(points[0], (constarr)terms[k], true, false);
+                    }
+                } else {
+                    // Entry m = entry (m with its top bit k cleared) + 2 * terms[k]
+                    uint32_t k = 0;
+                    while ((m >> (k + 1)) != 0) {
+                        k++;
+                    }
+                    uint32_t prev = m ^ (1 << k);
+                    P256_double_j(points[i], (constarr)terms[k]);
+                    if (prev >= group) {
+                        P256_add_sub_j(points[i], (constarr)points[prev - group], false, false);
+                    } else {
+                        P256_add_sub_j(points[i], (constarr)result->table[t][prev], false, true);
+                    }
+                }
+            }
+            jacobian_to_affine_batch(points, 8, scratch, true);
+            for (uint32_t i = 0; i < 8; i++) {
+                memcpy(result->table[t][group + i], points[i], sizeof(result->table[t][group + i]));
+            }
+        }
+    }
+    return true;
+}
+
+void p256_ecdh_with_precomp(uint8_t shared_secret[32], const uint32_t private_key[8], const struct FixedPointPrecomp* precomp) {
+    uint32_t current_point[3][8], scalar2[8];
+    // Since x(k*P) = x(-k*P), the result does not need to be negated if the private key was even.
+    basemult_init(scalar2, private_key);
+    for (uint32_t step = 0; step < BASEMULT_NUM_STEPS; step++) {
+        basemult_step(current_point, scalar2, precomp->table, step);
+    }
+    
+    jacobian_to_affine(current_point[0], current_point[1], (constarr)current_point, false);
+    P256_from_montgomery(current_point[0], current_point[0]);
+    p256_convert_endianness(shared_secret, current_point[0], 32);
+}
+#endif
+
+#if include_p256_resumable
+// The number of steps of the verification: 8 steps that create the public key table and 257 steps of the main loop
+#define VERIFY_NUM_STEPS 265
+
+enum {
+    P256_OP_NONE,
+    P256_OP_ECDH,
+    P256_OP_KEYGEN,
+    P256_OP_VERIFY
+};
+
+#if include_p256_varmult
+static void op_varmult_steps(struct P256Op* op, uint32_t end) {
+    for (; op->step < end; op->step++) {
+        varmult_step(op->current_point, op->u.varmult.table, op->u.varmult.e, op->step);
+    }
+}
+#endif
+
+bool p256_op_step(struct P256Op* op, uint32_t budget) {
+    uint32_t end = op->num_steps - op->step < budget ? op->num_steps : op->step + budget;
+    
+    switch (op->type) {
+    #if include_p256_ecdh
+    case P256_OP_ECDH:
+        op_varmult_steps(op, end);
+        break;
+    #endif
+    #if include_p256_keygen
+    case P256_OP_KEYGEN:
+        #if include_fast_p256_basemult
+        // The scalar is addressed through the union, since GCC otherwise merges this address with the one of
+        // op->u.varmult.table in the ECDH case and then warns that the table does not fit (-Wstringop-overflow)
+        basemult_run_steps(op->current_point, (const uint32_t*)&op->u, op->step, end);
+        op->step = end;
+        #else
+        op_varmult_steps(op, end);
+        #endif
+        break;
+    #endif
+    #if include_p256_verify
+    case P256_OP_VERIFY:
+        for (; op->step < end; op->step++) {
+            if (op->step < 8) {
+                odd_multiples_table_step(op->u.verify.pk_table, op->step);
+            } else {
+                verify_step(op->current_point, op->u.verify.slide_bp, op->u.verify.slide_pk, (uint32_t*)op->u.verify.pk_table, 3, VERIFY_NUM_STEPS - 1 - op->step);
+            }
+        }
+        break;
+    #endif
+    }
+    
+    return op->step == op->num_steps;
+}
+
+// Runs all remaining steps and returns true if the operation was successfully started as the given type.
+static bool op_complete(struct P256Op* op, uint32_t type) {
+    p256_op_step(op, UINT32_MAX);
+    return op->type == type;
+}
+
+#if include_p256_ecdh
+bool p256_ecdh_start(struct P256Op* op, const uint32_t private_key[8], const uint32_t others_public_key_x[8], const uint32_t others_public_key_y[8]) {
+    uint32_t pk[3][8];
+    
+    memset(op, 0, sizeof(*op));
+    if (!load_public_key(pk, others_public_key_x, others_public_key_y)) {
+        return false;
+    }
+    
+    // The negation of the result can be skipped since it does not affect the x coordinate
+    varmult_init(op->u.varmult.e, op->u.varmult.table, pk[0], pk[1], private_key);
+    op->type = P256_OP_ECDH;
+    op->num_steps = VARMULT_NUM_STEPS;
+    return true;
+}
+
+bool p256_ecdh_finish(struct P256Op* op, uint8_t shared_secret[32]) {
+    bool ok = op_complete(op, P256_OP_ECDH);
+    if (ok) {
+        uint32_t x[8], y[8];
+        jacobian_to_affine(x, y, (constarr)op->current_point, false);
+        P256_from_montgomery(x, x);
+        p256_convert_endianness(shared_secret, x, 32);
+    }
+    memset(op, 0, sizeof(*op));
+    return ok;
+}
+#endif
+
+#if include_p256_keygen
+bool p256_keygen_start(struct P256Op* op, const uint32_t private_key[8]) {
+    memset(op, 0, sizeof(*op));
+    if (!P256_check_range_n(private_key)) {
+        return false;
+    }
+    
+    #if include_fast_p256_basemult
+    op->negate = basemult_init(op->u.basemult.scalar, private_key);
+    op->num_steps = BASEMULT_NUM_STEPS;
+    #else
+    op->negate = varmult_init(op->u.varmult.e, op->u.varmult.table, p256_basepoint_mont[0], p256_basepoint_mont[1], private_key);
+    op->num_steps = VARMULT_NUM_STEPS;
+    #endif
+    op->type = P256_OP_KEYGEN;
+    return true;
+}
+
+bool p256_keygen_finish(struct P256Op* op, uint32_t public_key_x[8], uint32_t public_key_y[8]) {
+    bool ok = op_complete(op, P256_OP_KEYGEN);
+    if (ok) {
+        P256_negate_mod_p_if(op->current_point[1], op->current_point[1], op->negate);
+        jacobian_to_affine(public_key_x, public_key_y, (constarr)op->current_point, false);
+        P256_from_montgomery(public_key_x, public_key_x);
+        P256_from_montgomery(public_key_y, public_key_y);
+    }
+    memset(op, 0, sizeof(*op));
+    return ok;
+}
+#endif
+
+#if include_p256_verify
+bool p256_verify_start(struct P256Op* op, const uint32_t public_key_x[8], const uint32_t public_key_y[8], const uint8_t* hash, uint32_t hashlen_in_bytes, const uint32_t r[8], const uint32_t s[8]) {
+    memset(op, 0, sizeof(*op));
+    if (!P256_check_range_n(r) || !P256_check_range_n(s) || !load_public_key(op->u.verify.pk_table[0], public_key_x, public_key_y)) {
+        return false;
+    }
+    
+    uint32_t u1[8], u2[8];
+    calc_u1_u2(u1, u2, hash, hashlen_in_bytes, r, s);
+    slide_257(op->u.verify.slide_bp, (uint8_t*)u1, verify_basepoint_window_bits);
+    slide_257(op->u.verify.slide_pk, (uint8_t*)u2, 4);
+    memcpy(op->u.verify.r, r, 32);
+    
+    op->type = P256_OP_VERIFY;
+    op->num_steps = VERIFY_NUM_STEPS;
+    return true;
+}
+
+bool p256_verify_finish(struct P256Op* op) {
+    bool ok = op_complete(op, P256_OP_VERIFY) && P256_verify_last_step(op->u.verify.r, (constarr)op->current_point);
+    memset(op, 0, sizeof(*op));
+    return ok;
+}
 #endif
 #endif
 
@@ -680,3 +2085,104 @@ bool p256_octet_string_to_point(uint32_t x[8], uint32_t y[8], const uint8_t* inp
     return false;
 }
 #endif
+
+#if include_p256_der
+// The DER encoding of the AlgorithmIdentifier { id-ecPublicKey, prime256v1 } surrounded by the SEQUENCE and BIT STRING
+// headers of a SubjectPublicKeyInfo with an uncompressed point. Only the lengths differ for the other point encodings.
+static const uint8_t p256_spki_prefix[26] = {
+    0x30, 0x59,
+    0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07,
+    0x03, 0x42, 0x00
+};
+
+// Parses one INTEGER at *pos and advances *pos past it. The big endian bytes are placed directly into the words.
+static bool der_parse_integer(uint32_t out[8], const uint8_t** pos, const uint8_t* end) {
+    const uint8_t* p = *pos;
+    if (end - p < 3 || p[0] != 0x02) {
+        return false;
+    }
+    uint32_t len = p[1];
+    p += 2;
+    // This also rejects the long form, since a value of at most 32 bytes never needs it
+    if (len == 0 || len > 33 || len > (uint32_t)(end - p)) {
+        return false;
+    }
+    if (p[0] & 0x80) {
+        // Negative
+        return false;
+    }
+    if (p[0] == 0 && len > 1) {
+        if (!(p[1] & 0x80)) {
+            // Unnecessary leading zero
+            return false;
+        }
+        p++;
+        len--;
+    }
+    if (len > 32) {
+        return false;
+    }
+    memset(out, 0, 32);
+    for (uint32_t i = 0; i < len; i++) {
+        uint32_t bit_pos = 8 * (len - 1 - i);
+        out[bit_pos / 32] |= (uint32_t)p[i] << (bit_pos % 32);
+    }
+    *pos = p + len;
+    return true;
+}
+
+bool p256_signature_from_der(uint32_t r[8], uint32_t s[8], const uint8_t* der, uint32_t der_len_in_bytes) {
+    if (der_len_in_bytes < 8 || der_len_in_bytes > 72 || der[0] != 0x30 || der[1] != der_len_in_bytes - 2) {
+        return false;
+    }
+    const uint8_t* pos = der + 2;
+    const uint8_t* end = der + der_len_in_bytes;
+    return der_parse_integer(r, &pos, end) && der_parse_integer(s, &pos, end) && pos == end;
+}
+
+// Writes the minimal INTEGER encoding of a non-negative 256-bit value and returns the number of bytes written.
+static uint32_t der_write_integer(uint8_t* out, const uint32_t in[8]) {
+    uint8_t be[33];
+    be[0] = 0;
+    p256_convert_endianness(be + 1, in, 32);
+    uint32_t start = 0;
+    while (start < 32 && be[start] == 0 && !(be[start + 1] & 0x80)) {
+        start++;
+    }
+    uint32_t len = 33 - start;
+    out[0] = 0x02;
+    out[1] = (uint8_t)len;
+    memcpy(out + 2, be + start, len);
+    return 2 + len;
+}
+
+uint32_t p256_signature_to_der(uint8_t out[72], const uint32_t r[8], const uint32_t s[8]) {
+    uint32_t len = der_write_integer(out + 2, r);
+    len += der_write_integer(out + 2 + len, s);
+    out[0] = 0x30;
+    out[1] = (uint8_t)len;
+    return 2 + len;
+}
+
+#if include_p256_decode_point || include_p256_decompress_point
+bool p256_public_key_from_spki(uint32_t x[8], uint32_t y[8], const uint8_t* spki, uint32_t spki_len_in_bytes) {
+    // The point is 33 or 65 bytes, so all lengths fit in the short form
+    if (spki_len_in_bytes != 26 + 33 && spki_len_in_bytes != 26 + 65) {
+        return false;
+    }
+    if (spki[0] != 0x30 || spki[1] != spki_len_in_bytes - 2 ||
+        memcmp(spki + 2, p256_spki_prefix + 2, 22) != 0 ||
+        spki[24] != spki_len_in_bytes - 25 || spki[25] != 0) {
+        return false;
+    }
+    return p256_octet_string_to_point(x, y, spki + 26, spki_len_in_bytes - 26);
+}
+#endif
+
+void p256_public_key_to_spki(uint8_t out[91], const uint32_t x[8], const uint32_t y[8]) {
+    memcpy(out, p256_spki_prefix, sizeof(p256_spki_prefix));
+    out[26] = 4;
+    p256_convert_endianness(out + 27, x, 32);
+    p256_convert_endianness(out + 59, y, 32);
+}
+#endif
@@ -51,6 +51,19 @@ Note: code that processes secret data runs in constant time, in order to mitigat
 
 */
 
+/**
+ * Initializes the library.
+ *
+ * If use_persistent_basepoint_table_ram is enabled, this copies the base point table used by keygen and sign (1 kB
+ * by default, see fast_basemult_comb_tables) into a static RAM buffer, which all later calls then use. Tables larger
+ * than 1 kB always need this RAM copy when has_d_cache is disabled, unless place_tables_in_ram is enabled. It should
+ * be called once at startup, before any other thread or interrupt handler can call keygen or sign. If it has not been
+ * called, the first keygen or sign call loads the table instead.
+ *
+ * Otherwise this function does nothing, so it can always be called.
+ */
+void p256_init(void);
+
 /**
  * Converts endianness by reversing the input value.
  *
@@ -58,6 +71,57 @@ Note: code that processes secret data runs in constant time, in order to mitigat
  */
 void p256_convert_endianness(void* output, const void* input, size_t byte_len);
 
+#if p256_enable_stats
+/**
+ * Number of executed operations, see p256_get_stats.
+ *
+ * In the assembler backend, when use_mul_for_sqr is enabled (or the MVE multiplication is used), squarings are
+ * performed as multiplications and are hence counted as such. The portable C backend instead counts doublings mod p
+ * as additions. The field operations that a point operation or inversion consists of are included in the field
+ * operation counts.
+ */
+struct P256OpCounts {
+    uint32_t mulmod;      // Field multiplications (mod p)
+    uint32_t sqrmod;      // Field squarings (mod p)
+    uint32_t addmod;      // Field additions (mod p)
+    uint32_t submod;      // Field subtractions (mod p)
+    uint32_t double_j;    // Point doublings
+    uint32_t add_sub_j;   // Point additions and subtractions
+    uint32_t modinv_sqrt; // Field inversions and square roots by exponentiation (mod p)
+    uint32_t inv_mod_n;   // Inversions mod n
+    uint32_t inv_mod_p;   // Field inversions by safegcd (mod p), see use_safegcd_mod_p_inv
+};
+
+/**
+ * Phases of the scalar multiplications and of the signature verification.
+ */
+enum P256StatsPhase {
+    P256_STATS_PHASE_TABLE,     // Creation of the table with multiples of the input point
+    P256_STATS_PHASE_MAIN_LOOP, // The doublings and additions that process the scalar(s)
+    P256_STATS_PHASE_TO_AFFINE, // Conversion of the result to affine coordinates, or the final check in verify
+    P256_STATS_NUM_PHASES
+};
+
+struct P256Stats {
+    struct P256OpCounts total;
+    struct P256OpCounts phase[P256_STATS_NUM_PHASES];
+};
+
+/**
+ * Retrieves the number of operations executed since the last call to p256_reset_stats (or since startup).
+ *
+ * "total" counts every operation, while "phase" only counts the operations within each phase. Operations outside
+ * the phases, such as point validation and the scalar inversion in sign and verify, are only counted in "total".
+ * The counters are global and not thread safe.
+ */
+void p256_get_stats(struct P256Stats* stats);
+
+/**
+ * Sets all counters to zero.
+ */
+void p256_reset_stats(void);
+#endif
+
 #if include_p256_verify
 /**
  * Verifies an ECDSA signature.
@@ -70,6 +134,135 @@ bool p256_verify(const uint32_t public_key_x[8], const uint32_t public_key_y[8],
                  __attribute__((warn_unused_result));
 #endif
 
+#if include_p256_verify_batch
+/**
+ * One signature to be verified by p256_verify_batch. The parameters have the same meaning as for p256_verify.
+ *
+ * A plain ECDSA signature (r, s) only determines the x coordinate of the point R = u1*G + u2*P that the verifier
+ * computes, but a batch verification needs the full point. The "r_y_parity" field shall therefore be set to the
+ * parity (0 or 1) of the y coordinate of R, if that is known, e.g. when the signature is transmitted together with
+ * a recovery bit. If it is not known, the field shall be set to any other value, such as 0xff. Such signatures are
+ * still verified, but individually, and will hence not benefit from the batch verification speedup.
+ *
+ * An incorrect "r_y_parity" never changes the outcome of the verification, only the performance.
+ */
+struct VerifyBatchItem {
+    const uint32_t* public_key_x;
+    const uint32_t* public_key_y;
+    const uint8_t* hash;
+    uint32_t hashlen_in_bytes;
+    const uint32_t* r;
+    const uint32_t* s;
+    uint32_t r_y_parity;
+};
+
+/**
+ * Verifies multiple ECDSA signatures at once.
+ *
+ * Up to verify_batch_chunk_size signatures (see p256-cortex-m4-config.h) are checked together by verifying a
+ * random linear combination of the signature equations using one multi-scalar multiplication, in which all point
+ * doublings are shared. If a combined check fails, every signature of that chunk is verified individually in order
+ * to find out which signatures are invalid.
+ *
+ * The parameter "random" shall contain 128 random bits per signature. These values MUST be generated from a
+ * cryptographically secure random number generator and MUST be unpredictable to whoever created the signatures,
+ * since otherwise invalid signatures could be constructed that cancel out each other in the combined check.
+ *
+ * For each signature, results[i] is set to true if the signature is valid, otherwise false.
+ * Returns true if all signatures are valid, otherwise false.
+ */
+bool p256_verify_batch(bool results[], const struct VerifyBatchItem items[], uint32_t num_items,
+                       const uint32_t random[][4]);
+#endif
+
+#if include_p256_verify_precomp
+/**
+ * Precomputed data for a public key, used by p256_verify_precomp.
+ *
+ * Contains the odd multiples P, 3P, 5P, ... of the public key P in affine coordinates (Montgomery form).
+ * The number of points depends on the verify_precomp_window_bits setting in p256-cortex-m4-config.h.
+ *
+ * The struct contains no pointers and may therefore be copied, or stored in e.g. flash memory and later used
+ * directly from there. Note that the layout depends on the endianness of the CPU and the configuration.
+ * The content is not validated again when a signature is verified, so it MUST be protected against modification
+ * in the same way as the public key itself would be. Other than that, the content shall be treated as opaque to
+ * the API user.
+ */
+struct PublicKeyPrecomp {
+    uint32_t table[1 << (verify_precomp_window_bits - 1)][2][8];
+};
+
+/**
+ * Validates a public key and creates the precomputed data used by p256_verify_precomp.
+ *
+ * This is worth doing when multiple signatures are to be verified using the same public key, since the validation
+ * and table creation otherwise take place for every call to p256_verify.
+ * Creating the table costs one point doubling, 2^(verify_precomp_window_bits-1)-1 point additions and one field
+ * inversion, which is shared by all points of the table.
+ *
+ * Returns true if the public key is valid, otherwise false.
+ */
+bool p256_verify_precompute_public_key(struct PublicKeyPrecomp* result,
+                                       const uint32_t public_key_x[8], const uint32_t public_key_y[8])
+                                       __attribute__((warn_unused_result));
+
+/**
+ * Verifies an ECDSA signature, using a public key that has been precomputed by p256_verify_precompute_public_key.
+ *
+ * Returns true if the signature is valid for the given input, otherwise false.
+ */
+bool p256_verify_precomp(const struct PublicKeyPrecomp* public_key_precomp,
+                         const uint8_t* hash, uint32_t hashlen_in_bytes,
+                         const uint32_t r[8], const uint32_t s[8])
+                         __attribute__((warn_unused_result));
+#endif
+
+#if include_p256_sha256
+/**
+ * SHA-256 state, used by struct P256VerifyStream. The content shall be treated as opaque to the API user.
+ */
+struct P256Sha256 {
+    uint32_t h[8];
+    uint64_t total_len;
+    uint32_t buflen;
+    uint8_t buf[64];
+};
+#endif
+
+#if include_p256_verify_stream
+/**
+ * State of a streaming signature verification, see p256_verify_init.
+ *
+ * The content is opaque and must only be accessed through the functions below. It only contains public data.
+ */
+struct P256VerifyStream {
+    struct P256Sha256 sha256;
+};
+
+/**
+ * Verifies an ECDSA signature over a message that is hashed with SHA-256 while it is being streamed in.
+ *
+ * This is intended for large messages, such as firmware images, that are not available in RAM all at once.
+ * The verification is performed by first calling p256_verify_init, then p256_verify_update for every part of the
+ * message, in order, and finally p256_verify_final. The result is the same as calling p256_verify with the SHA-256
+ * hash of the whole message.
+ *
+ * The parts may have any length. When a part starts at a 4-byte aligned address (which is the case for every part
+ * if their lengths are multiples of 64 bytes and the first one is aligned), every whole 64-byte block is hashed
+ * directly from the input, without copying it, so it may e.g. point directly into memory mapped flash. Otherwise
+ * the data is copied into the state, one block at a time.
+ *
+ * p256_verify_final returns true if the signature is valid for the message, otherwise false. The state may be
+ * reused by calling p256_verify_init again.
+ */
+void p256_verify_init(struct P256VerifyStream* stream);
+void p256_verify_update(struct P256VerifyStream* stream, const uint8_t* data, uint32_t len);
+bool p256_verify_final(struct P256VerifyStream* stream,
+                       const uint32_t public_key_x[8], const uint32_t public_key_y[8],
+                       const uint32_t r[8], const uint32_t s[8])
+                       __attribute__((warn_unused_result));
+#endif
+
 #if include_p256_sign
 /**
  * Creates an ECDSA signature.
@@ -127,6 +320,30 @@ struct SignPrecomp {
  */
 bool p256_sign_step1(struct SignPrecomp *result, const uint32_t k[8]) __attribute__((warn_unused_result));
 
+#if include_p256_sign_batch
+/**
+ * Performs p256_sign_step1 for multiple values of "k" at once.
+ *
+ * This is faster than calling p256_sign_step1 for each "k", since the conversions of the points k*G to affine
+ * coordinates share one field inversion and the inversions of the "k" values share one inversion mod n, for up
+ * to basemult_batch_chunk_size values at a time (see p256-cortex-m4-config.h). The computation is still constant
+ * time with respect to each "k".
+ *
+ * The parameter "random" shall contain 256 bits from a cryptographically secure random number generator. The
+ * product of the "k" values is multiplied by this value (reduced mod n) before the shared inversion and the result
+ * is multiplied by it again afterwards, so that the inverted value is masked and a single power trace of the
+ * inversion does not reveal the product of the nonces. A new value MUST be used for every call.
+ *
+ * The same requirements as for p256_sign_step1 apply to each "k" and each resulting state. For each "k",
+ * results[i] is set to true if the state in result[i] was successfully created, otherwise false, in which case
+ * a new random value for that "k" MUST be generated. Returns true if all states were created successfully,
+ * otherwise false.
+ */
+bool p256_sign_step1_batch(bool results[], struct SignPrecomp result[], const uint32_t k[][8], uint32_t num_k,
+                           const uint32_t random[8])
+                           __attribute__((warn_unused_result));
+#endif
+
 /**
  * Second step of creating an ECDSA signature, using a two-step procedure.
  *
@@ -147,6 +364,87 @@ bool p256_sign_step2(uint32_t r[8], uint32_t s[8], const uint8_t* hash, uint32_t
                      __attribute__((warn_unused_result));
 #endif
 
+#if include_p256_sign_deterministic
+/**
+ * Creates an ECDSA signature, with "k" derived deterministically from the private key and the hash according to
+ * RFC 6979, using HMAC-SHA256.
+ *
+ * No random number generator is needed, and the same private key and hash always give the same signature. The
+ * signature is a regular ECDSA signature, so the verifier does not need to know how "k" was generated. The rare
+ * cases where a candidate "k" cannot be used are handled internally, by generating the next candidate as
+ * specified by RFC 6979.
+ *
+ * The hash is processed in the same way as by p256_sign and should be the output of SHA-256 to match the test
+ * vectors in RFC 6979, since HMAC-SHA256 is always used for the derivation of "k".
+ *
+ * Returns false only if the private key is not in the range 1 to n-1.
+ */
+bool p256_sign_deterministic(uint32_t r[8], uint32_t s[8], const uint8_t* hash, uint32_t hashlen_in_bytes,
+                             const uint32_t private_key[8])
+                             __attribute__((warn_unused_result));
+#endif
+
+#if include_p256_sign_pool
+/**
+ * Random source for the sign pool.
+ *
+ * Shall fill "out" with "len" bytes from a cryptographically secure random number generator and return true,
+ * or return false if no random data is available.
+ */
+typedef bool (*p256_random_bytes_fn)(void* ctx, uint8_t* out, uint32_t len);
+
+/**
+ * Statistics of the sign pool, see p256_sign_pool_get_stats.
+ */
+struct P256SignPoolStats {
+    uint32_t hits;      // Number of signatures created from a precomputed state
+    uint32_t misses;    // Number of signatures for which the pool was empty, so that the full path was used
+    uint32_t available; // Number of precomputed states currently in the pool
+};
+
+/**
+ * Initializes the sign pool, which is a library managed ring of up to sign_pool_size states created by
+ * p256_sign_step1 (see p256-cortex-m4-config.h).
+ *
+ * The random source is used to generate the "k" values, both when refilling the pool and when p256_sign_fast
+ * finds the pool empty. Any states already in the pool are zeroed out and the statistics are reset.
+ *
+ * The pool functions use static data and are not reentrant: they MUST NOT be called concurrently from
+ * different threads or interrupt handlers.
+ */
+void p256_sign_pool_init(p256_random_bytes_fn random, void* random_ctx);
+
+/**
+ * Precomputes up to "max_entries" new states into the sign pool, until it is full, and returns the number of
+ * states in the pool afterwards.
+ *
+ * Each state costs around as much as a p256_sign_step1 call (less when include_p256_sign_batch is enabled, since
+ * the states are then created in batches), so this is intended to be called when the device is otherwise idle,
+ * e.g. with "max_entries" set to 1 to bound the time per call. Stops early if the random source fails.
+ */
+uint32_t p256_sign_pool_refill(uint32_t max_entries);
+
+/**
+ * Creates an ECDSA signature, in the same way as p256_sign, but with "k" taken from the sign pool.
+ *
+ * If the pool contains a precomputed state, it is removed from the pool and zeroed out after use, and the
+ * signature is created in around the time of p256_sign_step2 (a few multiplications mod n). Otherwise the
+ * full signing procedure is used, with a fresh "k" from the random source.
+ *
+ * Returns false only if the random source fails while the pool is empty. Any retries with a new "k" required
+ * by the ECDSA standard are performed internally.
+ */
+bool p256_sign_fast(uint32_t r[8], uint32_t s[8], const uint8_t* hash, uint32_t hashlen_in_bytes,
+                    const uint32_t private_key[8])
+                    __attribute__((warn_unused_result));
+
+/**
+ * Retrieves the number of pool hits and misses of p256_sign_fast since p256_sign_pool_init, and the current
+ * number of precomputed states in the pool.
+ */
+void p256_sign_pool_get_stats(struct P256SignPoolStats* stats);
+#endif
+
 #if include_p256_keygen
 /**
  * Calculates the public key from a given private key for use by either ECDSA or ECDH.
@@ -167,6 +465,23 @@ bool p256_keygen(uint32_t public_key_x[8], uint32_t public_key_y[8],
                  __attribute__((warn_unused_result));
 #endif
 
+#if include_p256_keygen_batch
+/**
+ * Calculates the public keys for multiple private keys at once, in the same way as p256_keygen.
+ *
+ * This is faster than calling p256_keygen for each private key, since the conversions of the public keys to
+ * affine coordinates share one field inversion, for up to basemult_batch_chunk_size keys at a time (see
+ * p256-cortex-m4-config.h). Each key is still processed in constant time.
+ *
+ * For each private key, results[i] is set to true if the private key is valid, otherwise false. Each private
+ * key for which false is returned MUST be replaced by a new random value, and the public key calculated again.
+ * Returns true if all private keys are valid, otherwise false.
+ */
+bool p256_keygen_batch(bool results[], uint32_t public_keys_x[][8], uint32_t public_keys_y[][8],
+                       const uint32_t private_keys[][8], uint32_t num_keys)
+                       __attribute__((warn_unused_result));
+#endif
+
 #if include_p256_ecdh
 /**
  * Generates the shared secret according to the ECDH standard.
@@ -182,6 +497,65 @@ bool p256_keygen(uint32_t public_key_x[8], uint32_t public_key_y[8],
 bool p256_ecdh_calc_shared_secret(uint8_t shared_secret[32], const uint32_t private_key[8],
                                   const uint32_t others_public_key_x[8], const uint32_t others_public_key_y[8])
                                   __attribute__((warn_unused_result));
+
+/**
+ * Same as p256_ecdh_calc_shared_secret, but the other's public key is given as a 33 bytes compressed octet string
+ * (first byte is "02" or "03", followed by the big endian encoding of the x coordinate).
+ *
+ * If use_coz_ladder_ecdh is enabled, the y coordinate is never computed, so no square root is needed.
+ * Since x(k*P) = x(k*(-P)), the parity of y does not affect the result, but the first byte is still validated.
+ *
+ * If the input is not a valid encoding of a point on the curve, this function fails and false is returned.
+ * Otherwise, shared secret is calculated and true is returned.
+ *
+ * NOTE: The return value MUST be checked since the other's public key point cannot generally be trusted.
+ */
+bool p256_ecdh_calc_shared_secret_compressed(uint8_t shared_secret[32], const uint32_t private_key[8],
+                                             const uint8_t others_public_key[33])
+                                             __attribute__((warn_unused_result));
+#endif
+
+#if include_p256_ecdh_precomp
+/**
+ * Precomputed data for a fixed point, used by p256_ecdh_with_precomp.
+ *
+ * Contains the same kind of comb table as is used for the base point in the fixed base scalar multiplication,
+ * in affine coordinates (Montgomery form). The size is given by the fast_basemult_comb_teeth and
+ * fast_basemult_comb_tables settings in p256-cortex-m4-config.h (1 kB by default).
+ *
+ * The struct contains no pointers and may therefore be copied, or stored in e.g. flash memory or retained RAM and
+ * later used directly from there. Note that the layout depends on the endianness of the CPU and the configuration.
+ * The content is not validated again when it is used, so it MUST be protected against modification in the same
+ * way as the point itself would be. Other than that, the content shall be treated as opaque to the API user.
+ *
+ * If has_d_cache is disabled, the table entries are read directly using secret dependent indices, so the table
+ * should then be placed in memory that cannot easily be intercepted, such as internal RAM or flash.
+ */
+struct FixedPointPrecomp {
+    uint32_t table[fast_basemult_comb_tables][1 << (fast_basemult_comb_teeth - 1)][2][8];
+};
+
+/**
+ * Validates a point, e.g. a static public key of a peer, and creates the precomputed data used by
+ * p256_ecdh_with_precomp.
+ *
+ * This is worth doing when ECDH is to be performed many times against the same public key, since the scalar
+ * multiplication can then run at the speed of the fixed base scalar multiplication used by p256_keygen.
+ * The table creation costs somewhat more than one call to p256_ecdh_calc_shared_secret.
+ *
+ * Returns true if the point is valid, otherwise false.
+ */
+bool p256_fixed_point_precompute(struct FixedPointPrecomp* result, const uint32_t x[8], const uint32_t y[8])
+                                 __attribute__((warn_unused_result));
+
+/**
+ * Same as p256_ecdh_calc_shared_secret, but the other's public key is given as data precomputed by
+ * p256_fixed_point_precompute. Runs in constant time with respect to the private key.
+ *
+ * The private key must be in the range [1, n-1], e.g. as accepted by p256_keygen.
+ */
+void p256_ecdh_with_precomp(uint8_t shared_secret[32], const uint32_t private_key[8],
+                            const struct FixedPointPrecomp* precomp);
 #endif
 
 #if include_p256_raw_scalarmult_base
@@ -196,6 +570,21 @@ bool p256_ecdh_calc_shared_secret(uint8_t shared_secret[32], const uint32_t priv
 bool p256_scalarmult_base(uint32_t result_x[8], uint32_t result_y[8], const uint32_t scalar[8]);
 #endif
 
+#if include_p256_raw_scalarmult_base_batch
+/**
+ * Raw scalar multiplication by the base point of the elliptic curve, for multiple scalars at once.
+ *
+ * Gives the same result as calling p256_scalarmult_base for each scalar, but is faster since the conversions of
+ * the results to affine coordinates share one field inversion, for up to basemult_batch_chunk_size scalars at a
+ * time (see p256-cortex-m4-config.h). Each scalar multiplication still runs in constant time.
+ *
+ * For each scalar, results[i] is set to true if the scalar lies in the accepted range 1 to n-1, otherwise false,
+ * in which case the corresponding result is undefined. Returns true if all scalars are valid, otherwise false.
+ */
+bool p256_scalarmult_base_batch(bool results[], uint32_t result_x[][8], uint32_t result_y[][8],
+                                const uint32_t scalars[][8], uint32_t num_scalars);
+#endif
+
 #if include_p256_raw_scalarmult_generic
 /**
  * Raw scalar multiplication by any point on the elliptic curve.
@@ -210,6 +599,104 @@ bool p256_scalarmult_generic(uint32_t result_x[8], uint32_t result_y[8],
 						     const uint32_t scalar[8], const uint32_t in_x[8], const uint32_t in_y[8]);
 #endif
 
+#if include_p256_resumable
+/**
+ * State of a resumable operation, see p256_op_step.
+ *
+ * The content is opaque and must only be accessed through the functions below. It is owned by the caller, who may
+ * place it anywhere (e.g. in a static buffer instead of on the stack, which saves around 1.3 kB of stack compared to
+ * the blocking functions). It contains secret data between the start and finish calls, and is zeroed out by the
+ * finish functions.
+ */
+struct P256Op {
+    uint32_t type;
+    uint32_t step;
+    uint32_t num_steps;
+    uint32_t negate;
+    uint32_t current_point[3][8];
+    union {
+        struct {
+            uint32_t table[8][3][8];
+            int8_t e[64];
+        } varmult;
+        struct {
+            uint32_t scalar[8];
+        } basemult;
+        struct {
+            uint32_t pk_table[8][3][8];
+            uint32_t r[8];
+            signed char slide_bp[257];
+            signed char slide_pk[257];
+        } verify;
+    } u;
+};
+
+/**
+ * Resumable variants of keygen, ECDH and verify.
+ *
+ * Each operation is performed by first calling the start function, then calling p256_op_step until it returns true,
+ * and finally calling the finish function, which gives the same result as the corresponding blocking function.
+ * This way the work can be spread out over time, e.g. in a cooperative scheduler or between radio events.
+ *
+ * Each call to p256_op_step performs at most "budget" steps and returns true when no steps remain. The worst case
+ * amount of work per step is:
+ * - keygen: 1 point doubling and fast_basemult_comb_tables point additions (use_fast_p256_basemult), otherwise as ECDH,
+ * - ECDH: 1 point doubling or addition for the first 8 steps (table creation), then 4 doublings and 1 addition,
+ * - verify: 1 point doubling or addition for the first 8 steps, then 1 doubling and at most 2 additions.
+ * Keygen has 256 / fast_basemult_comb_teeth / fast_basemult_comb_tables steps (32 by default, or 72 without
+ * use_fast_p256_basemult), ECDH 72 and verify 265. When use_fast_p256_basemult is enabled and has_d_cache is
+ * disabled, each p256_op_step call of a keygen operation also copies the 1 kB base point table to the stack (unless
+ * use_persistent_basepoint_table_ram or place_tables_in_ram is enabled), so a larger budget is more efficient.
+ *
+ * The start functions validate the input in the same way as the blocking functions and return false if validation
+ * fails (for verify, this includes the range checks of r and s, and ECDH also performs the public key
+ * validation here). Each start function performs at most one field inversion (mod n for verify). The finish
+ * functions run any remaining steps, and perform the conversion to affine coordinates, which costs a field
+ * inversion. If the start function failed, or the operation was started by a different start function, the
+ * finish function returns false.
+ */
+bool p256_op_step(struct P256Op* op, uint32_t budget);
+
+#if include_p256_keygen
+/**
+ * Starts the calculation of the public key for a given private key, see p256_keygen.
+ */
+bool p256_keygen_start(struct P256Op* op, const uint32_t private_key[8])
+                       __attribute__((warn_unused_result));
+
+bool p256_keygen_finish(struct P256Op* op, uint32_t public_key_x[8], uint32_t public_key_y[8])
+                        __attribute__((warn_unused_result));
+#endif
+
+#if include_p256_ecdh
+/**
+ * Starts the calculation of an ECDH shared secret, see p256_ecdh_calc_shared_secret.
+ *
+ * NOTE: The return values of both the start and finish functions MUST be checked.
+ */
+bool p256_ecdh_start(struct P256Op* op, const uint32_t private_key[8],
+                     const uint32_t others_public_key_x[8], const uint32_t others_public_key_y[8])
+                     __attribute__((warn_unused_result));
+
+bool p256_ecdh_finish(struct P256Op* op, uint8_t shared_secret[32])
+                      __attribute__((warn_unused_result));
+#endif
+
+#if include_p256_verify
+/**
+ * Starts the verification of an ECDSA signature, see p256_verify.
+ *
+ * The signature is valid only if both the start and finish functions return true.
+ */
+bool p256_verify_start(struct P256Op* op, const uint32_t public_key_x[8], const uint32_t public_key_y[8],
+                       const uint8_t* hash, uint32_t hashlen_in_bytes, const uint32_t r[8], const uint32_t s[8])
+                       __attribute__((warn_unused_result));
+
+bool p256_verify_finish(struct P256Op* op)
+                        __attribute__((warn_unused_result));
+#endif
+#endif
+
 // These functions create a big endian octet string representation of a point according to the X.92 standard.
 
 #if include_p256_to_octet_string_uncompressed
@@ -251,4 +738,48 @@ bool p256_octet_string_to_point(uint32_t x[8], uint32_t y[8],
                                 __attribute__((warn_unused_result));
 #endif
 
+#if include_p256_der
+// These functions convert between the DER encodings used by X.509, TLS, PKCS#11 etc. and the word arrays used above.
+
+/**
+ * Parses a DER encoded ECDSA signature "SEQUENCE { INTEGER r, INTEGER s }" (the ECDSA-Sig-Value structure of RFC 3279).
+ *
+ * The input is validated in place and the integers are written directly into r and s. Only strict DER is accepted:
+ * definite short form lengths that match the input exactly, no trailing data, no negative integers and no
+ * unnecessary leading zero bytes. Integers larger than 32 bytes are rejected.
+ *
+ * Returns true if the input is a valid encoding, otherwise false. Whether r and s are in the range [1, n-1] is not
+ * checked here, since p256_verify does that.
+ */
+bool p256_signature_from_der(uint32_t r[8], uint32_t s[8], const uint8_t* der, uint32_t der_len_in_bytes)
+                             __attribute__((warn_unused_result));
+
+/**
+ * Creates the DER encoding of the signature (r, s), e.g. as returned by p256_sign.
+ *
+ * Returns the number of bytes written to out, which is between 8 and 72.
+ */
+uint32_t p256_signature_to_der(uint8_t out[72], const uint32_t r[8], const uint32_t s[8]);
+
+#if include_p256_decode_point || include_p256_decompress_point
+/**
+ * Parses a DER encoded SubjectPublicKeyInfo structure (RFC 5480) holding a P-256 public key, i.e.
+ * "SEQUENCE { SEQUENCE { OID id-ecPublicKey, OID prime256v1 }, BIT STRING point }".
+ *
+ * The algorithm identifier must match exactly and the point is decoded with p256_octet_string_to_point, so the
+ * same encodings are accepted. The key is read directly from the input buffer.
+ *
+ * Returns true if the input is a valid encoding and the point lies on the curve, otherwise false.
+ */
+bool p256_public_key_from_spki(uint32_t x[8], uint32_t y[8], const uint8_t* spki, uint32_t spki_len_in_bytes)
+                               __attribute__((warn_unused_result));
+#endif
+
+/**
+ * Creates the DER encoded SubjectPublicKeyInfo structure (RFC 5480) for the public key (x, y), using the
+ * uncompressed point encoding. The output is always 91 bytes.
+ */
+void p256_public_key_to_spki(uint8_t out[91], const uint32_t x[8], const uint32_t y[8]);
+#endif
+
 #endif
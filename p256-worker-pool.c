@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2017-2021 Emil Lenngren
+ * Copyright (c) 2021 Shortcut Labs AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Worker pool for Linux hosts, see p256-worker-pool.h.
+//
+// The queue is a singly linked list of the submitted jobs, protected by a mutex. Workers sleep on a condition
+// variable while the queue is empty. The lock is only held while jobs are linked in or taken out, never while a job
+// runs, so with jobs that take hundreds of microseconds each the lock is essentially uncontended.
+//
+// Completion uses the "state" word of each job: JOB_PENDING, JOB_PENDING_WAITED (someone sleeps in p256_job_wait)
+// or JOB_DONE. The worker atomically exchanges it for JOB_DONE and only makes a futex wake system call if a waiter
+// has announced itself, so jobs that are polled or use a callback complete with a single atomic operation.
+
+#if !defined(__linux__)
+#error "p256-worker-pool.c requires Linux (futex)"
+#endif
+
+#define _GNU_SOURCE // for syscall
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "p256-worker-pool.h"
+
+// The stack size of every worker thread. The API functions use at most a few kB of stack, but the C library and
+// a callback also need some.
+#ifndef P256_WORKER_STACK_SIZE
+#define P256_WORKER_STACK_SIZE (64 * 1024)
+#endif
+
+#define JOB_PENDING 0
+#define JOB_PENDING_WAITED 1
+#define JOB_DONE 2
+
+static void futex_wait(uint32_t* addr, uint32_t expected) {
+    syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static void futex_wake_all(uint32_t* addr) {
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+static bool run_job(struct P256Job* job) {
+    switch (job->type) {
+#if include_p256_verify
+        case P256_JOB_VERIFY:
+            return p256_verify(job->args.verify.public_key_x, job->args.verify.public_key_y,
+                               job->args.verify.hash, job->args.verify.hashlen_in_bytes,
+                               job->args.verify.r, job->args.verify.s);
+#endif
+#if include_p256_sign
+        case P256_JOB_SIGN:
+            return p256_sign(job->args.sign.r, job->args.sign.s,
+                             job->args.sign.hash, job->args.sign.hashlen_in_bytes,
+                             job->args.sign.private_key, job->args.sign.k);
+#endif
+#if include_p256_ecdh
+        case P256_JOB_ECDH:
+            return p256_ecdh_calc_shared_secret(job->args.ecdh.shared_secret, job->args.ecdh.private_key,
+                                                job->args.ecdh.others_public_key_x, job->args.ecdh.others_public_key_y);
+#endif
+#if include_p256_keygen
+        case P256_JOB_KEYGEN:
+            return p256_keygen(job->args.keygen.public_key_x, job->args.keygen.public_key_y, job->args.keygen.private_key);
+#endif
+        default:
+            return false;
+    }
+}
+
+static void* worker_main(void* arg) {
+    struct P256WorkerPool* pool = arg;
+    
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->head == NULL && !pool->stopping) {
+            pthread_cond_wait(&pool->cond, &pool->lock);
+        }
+        struct P256Job* job = pool->head;
+        if (job == NULL) {
+            // Stopping and the queue is empty
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        pool->head = job->next;
+        if (pool->head == NULL) {
+            pool->tail = &pool->head;
+        }
+        pthread_mutex_unlock(&pool->lock);
+        
+        job->result = run_job(job);
+        if (job->callback != NULL) {
+            job->callback(job, job->user_data);
+        }
+        // The release ordering makes the result (and the output buffers) visible to whoever observes JOB_DONE.
+        // The job may be reused as soon as the exchange has been made, but a futex wake only uses its address.
+        if (__atomic_exchange_n(&job->state, JOB_DONE, __ATOMIC_RELEASE) == JOB_PENDING_WAITED) {
+            futex_wake_all(&job->state);
+        }
+    }
+}
+
+bool p256_worker_pool_start(struct P256WorkerPool* pool, uint32_t num_threads) {
+    if (num_threads < 1 || num_threads > P256_WORKER_POOL_MAX_THREADS) {
+        return false;
+    }
+    
+    p256_init();
+    
+    pool->num_threads = 0;
+    pool->head = NULL;
+    pool->tail = &pool->head;
+    pool->stopping = false;
+    if (pthread_mutex_init(&pool->lock, NULL) != 0) {
+        return false;
+    }
+    if (pthread_cond_init(&pool->cond, NULL) != 0) {
+        pthread_mutex_destroy(&pool->lock);
+        return false;
+    }
+    
+    pthread_attr_t attr;
+    bool ok = pthread_attr_init(&attr) == 0;
+    if (ok) {
+        ok = pthread_attr_setstacksize(&attr, P256_WORKER_STACK_SIZE) == 0;
+        for (uint32_t i = 0; ok && i < num_threads; i++) {
+            ok = pthread_create(&pool->threads[i], &attr, worker_main, pool) == 0;
+            if (ok) {
+                pool->num_threads++;
+            }
+        }
+        pthread_attr_destroy(&attr);
+    }
+    if (!ok) {
+        p256_worker_pool_stop(pool);
+    }
+    return ok;
+}
+
+void p256_worker_pool_stop(struct P256WorkerPool* pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+    
+    for (uint32_t i = 0; i < pool->num_threads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pool->num_threads = 0;
+    pthread_cond_destroy(&pool->cond);
+    pthread_mutex_destroy(&pool->lock);
+}
+
+void p256_worker_pool_submit(struct P256WorkerPool* pool, struct P256Job jobs[], uint32_t num_jobs) {
+    if (num_jobs == 0) {
+        return;
+    }
+    
+    // Link the jobs together before taking the lock
+    for (uint32_t i = 0; i < num_jobs; i++) {
+        jobs[i].state = JOB_PENDING;
+        jobs[i].next = i + 1 < num_jobs ? &jobs[i + 1] : NULL;
+    }
+    
+    pthread_mutex_lock(&pool->lock);
+    *pool->tail = &jobs[0];
+    pool->tail = &jobs[num_jobs - 1].next;
+    if (num_jobs == 1) {
+        pthread_cond_signal(&pool->cond);
+    } else {
+        pthread_cond_broadcast(&pool->cond);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+bool p256_job_is_done(const struct P256Job* job) {
+    return __atomic_load_n(&job->state, __ATOMIC_ACQUIRE) == JOB_DONE;
+}
+
+bool p256_job_wait(struct P256Job* job) {
+    uint32_t state = __atomic_load_n(&job->state, __ATOMIC_ACQUIRE);
+    while (state != JOB_DONE) {
+        // Announce the waiter, so that the worker makes the wake system call
+        if (state == JOB_PENDING &&
+            !__atomic_compare_exchange_n(&job->state, &state, JOB_PENDING_WAITED, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            continue; // state now contains the current value
+        }
+        futex_wait(&job->state, JOB_PENDING_WAITED);
+        state = __atomic_load_n(&job->state, __ATOMIC_ACQUIRE);
+    }
+    return job->result;
+}
+
+bool p256_worker_pool_run(struct P256WorkerPool* pool, struct P256Job jobs[], uint32_t num_jobs) {
+    bool all_ok = true;
+    p256_worker_pool_submit(pool, jobs, num_jobs);
+    for (uint32_t i = 0; i < num_jobs; i++) {
+        all_ok &= p256_job_wait(&jobs[i]);
+    }
+    return all_ok;
+}
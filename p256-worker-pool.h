@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2017-2021 Emil Lenngren
+ * Copyright (c) 2021 Shortcut Labs AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef P256_WORKER_POOL_H
+#define P256_WORKER_POOL_H
+
+#include <pthread.h>
+#include "p256-cortex-m4.h"
+
+/*
+
+Worker pool for Linux hosts with multiple cores.
+
+This file is an addition to the library for Linux systems that process many independent operations, such as
+gateways that verify and sign messages for many devices. Jobs are submitted to a shared queue and executed by a
+fixed number of worker threads, each of which calls the ordinary single-call API functions (p256_verify,
+p256_sign, p256_ecdh_calc_shared_secret and p256_keygen) on its own stack. The library keeps no mutable global
+state in these functions, so no locks are taken while a job runs. Completion is signalled per job without locks:
+the caller can poll the job, block on it, or let the pool call a callback.
+
+p256-worker-pool.c must be linked together with p256-cortex-m4.c and one of the backends, and compiled with
+-pthread. On 32-bit ARM Linux (e.g. Cortex-A7/A9, armhf), the Cortex-M4 assembler code can be used as is, but
+has_d_cache should be enabled since these CPUs have a data cache. p256_enable_stats must be disabled, since its
+counters are global and not thread safe.
+
+*/
+
+#define P256_WORKER_POOL_MAX_THREADS 16
+
+enum P256JobType {
+    P256_JOB_VERIFY,
+    P256_JOB_SIGN,
+    P256_JOB_ECDH,
+    P256_JOB_KEYGEN
+};
+
+struct P256Job;
+
+/**
+ * Called by the worker thread that executed the job, when job->result has been set but before the job is marked
+ * as done. The callback should be short, since it delays the next job of that worker thread.
+ */
+typedef void (*p256_job_callback)(struct P256Job* job, void* user_data);
+
+/**
+ * A job to execute in a worker pool.
+ *
+ * The caller fills in "type", the corresponding member of "args", and optionally "callback" and "user_data".
+ * The arguments are the same as for the corresponding API function. All buffers the job refers to, and the job
+ * itself, must stay valid (and the input buffers unchanged) until the job is done.
+ *
+ * "result" is set to the return value of the API function. Jobs of an algorithm that is not included in the
+ * library configuration get the result false. The remaining fields are used internally by the pool.
+ */
+struct P256Job {
+    enum P256JobType type;
+    union {
+        struct {
+            const uint32_t* public_key_x;
+            const uint32_t* public_key_y;
+            const uint8_t* hash;
+            uint32_t hashlen_in_bytes;
+            const uint32_t* r;
+            const uint32_t* s;
+        } verify;
+        struct {
+            uint32_t* r;
+            uint32_t* s;
+            const uint8_t* hash;
+            uint32_t hashlen_in_bytes;
+            const uint32_t* private_key;
+            const uint32_t* k;
+        } sign;
+        struct {
+            uint8_t* shared_secret;
+            const uint32_t* private_key;
+            const uint32_t* others_public_key_x;
+            const uint32_t* others_public_key_y;
+        } ecdh;
+        struct {
+            uint32_t* public_key_x;
+            uint32_t* public_key_y;
+            const uint32_t* private_key;
+        } keygen;
+    } args;
+    p256_job_callback callback;
+    void* user_data;
+    
+    bool result;
+    uint32_t state;
+    struct P256Job* next;
+};
+
+/**
+ * A worker pool. The content is private to p256-worker-pool.c.
+ */
+struct P256WorkerPool {
+    pthread_t threads[P256_WORKER_POOL_MAX_THREADS];
+    uint32_t num_threads;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct P256Job* head;
+    struct P256Job** tail;
+    bool stopping;
+};
+
+/**
+ * Starts a worker pool with the given number of threads (1 to P256_WORKER_POOL_MAX_THREADS), which should
+ * normally be the number of cores. Every thread gets a stack of P256_WORKER_STACK_SIZE bytes (see
+ * p256-worker-pool.c), which is the only memory it uses for the operations.
+ *
+ * p256_init is called before the threads are created.
+ *
+ * Returns false if the number of threads is out of range or the threads could not be created.
+ */
+bool p256_worker_pool_start(struct P256WorkerPool* pool, uint32_t num_threads) __attribute__((warn_unused_result));
+
+/**
+ * Waits until all submitted jobs are done, then stops the worker threads and releases their resources.
+ */
+void p256_worker_pool_stop(struct P256WorkerPool* pool);
+
+/**
+ * Submits jobs to the pool. The jobs are appended to the queue in one step, and are started in order as soon as a
+ * worker thread is available. This function does not wait for the jobs to be done.
+ * The jobs must not currently be submitted.
+ */
+void p256_worker_pool_submit(struct P256WorkerPool* pool, struct P256Job jobs[], uint32_t num_jobs);
+
+/**
+ * Returns true if the job is done, in which case job->result is valid and the pool no longer accesses the job.
+ * Does not block.
+ */
+bool p256_job_is_done(const struct P256Job* job);
+
+/**
+ * Blocks until the job is done (without busy waiting), and returns job->result.
+ * It may be called from multiple threads for the same job.
+ */
+bool p256_job_wait(struct P256Job* job);
+
+/**
+ * Submits the jobs and waits until all of them are done.
+ *
+ * Returns true if the result of every job is true.
+ */
+bool p256_worker_pool_run(struct P256WorkerPool* pool, struct P256Job jobs[], uint32_t num_jobs);
+
+#endif
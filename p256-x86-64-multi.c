@@ -0,0 +1,633 @@
+/*
+ * Copyright (c) 2017-2021 Emil Lenngren
+ * Copyright (c) 2021 Shortcut Labs AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Multi-lane ECDSA verification for x86-64, see p256-x86-64-multi.h.
+//
+// Four independent verifications run in the four 64-bit lanes of AVX2 registers. A field element is stored as
+// nine 29-bit limbs (one __m256i per limb), so that the 32x32 -> 64 bit multiplication instruction (vpmuludq) can be
+// used and products can be accumulated without carry handling. Montgomery multiplication is used with R = 2^261,
+// which is simple since p = -1 mod 2^29.
+//
+// Field elements are kept partially reduced: all limbs are below 2^29 and the value is below 2p. Values are only
+// fully reduced at the end, before the result is handed over to P256_verify_last_step.
+//
+// The scalar multiplication u1*G + u2*P uses a signed fixed window of 5 bits rather than the sliding window used by
+// p256_verify, so that all lanes perform the same sequence of operations. Digits that are 0 (and lanes where the
+// accumulated point is still the point at infinity) are handled by blending.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "p256-x86-64-multi.h"
+
+bool P256_check_range_n(const uint32_t a[8]);
+bool P256_check_range_p(const uint32_t a[8]);
+void P256_to_montgomery(uint32_t aR[8], const uint32_t a[8]);
+bool P256_point_is_on_curve(const uint32_t x_mont[8], const uint32_t y_mont[8]);
+void P256_mul_mod_n(uint32_t res[8], const uint32_t a[8], const uint32_t b[8]);
+void P256_mod_n_inv_vartime(uint32_t res[8], const uint32_t a[8]);
+bool P256_verify_last_step(const uint32_t r[8], const uint32_t jacobian_point[3][8]);
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HAS_AVX2_ENGINE 1
+#else
+#define HAS_AVX2_ENGINE 0
+#endif
+
+#if HAS_AVX2_ENGINE
+#include <immintrin.h>
+
+#define AVX2 __attribute__((target("avx2")))
+
+#define NUM_LANES 4
+#define WINDOW_BITS 5
+#define NUM_WINDOWS 52 // ceil(257 / WINDOW_BITS)
+#define MASK29 0x1fffffff
+
+typedef struct {
+    __m256i v[9];
+} fe;
+
+// p in radix 2^29
+static const uint32_t p29[9] = {0x1fffffff, 0x1fffffff, 0x1fffffff, 0x1ff, 0, 0, 0x40000, 0x1fe00000, 0xffffff};
+
+// 4p in radix 2^29, where each limb except the highest has borrowed 2^29 from the next, so that every limb is at least
+// 2^29 - 1 and a normalized value can be subtracted limb by limb without going negative
+static const uint32_t p29_times4_borrowed[9] = {0x3ffffffc, 0x3ffffffe, 0x3ffffffe, 0x200007fe, 0x1fffffff, 0x1fffffff, 0x200fffff, 0x3f7fffff, 0x3fffffe};
+
+// 2^256 mod p in radix 2^29
+static const uint32_t two_pow_256_mod_p29[9] = {1, 0, 0, 0x1ffffe00, 0x1fffffff, 0x1fffffff, 0x1ffbffff, 0x1fffff, 0};
+
+// R^2 mod p and R mod p in radix 2^29, R = 2^261
+static const uint32_t r2_mod_p29[9] = {0xc00, 0, 0x1fff0000, 0x1fdfffff, 0x1fbfffff, 0x1fffffff, 0x1fffffff, 0x1ffffffe, 0x13};
+static const uint32_t one_mont29[9] = {0x20, 0, 0, 0x1fffc000, 0x1fffffff, 0x1fffffff, 0x1f7fffff, 0x3ffffff, 0};
+
+// The table below is generated by "node tablegen.js multi"
+// This table contains 1G, 2G, 3G, ... 16G in affine coordinates in montgomery form (radix 2^29, R = 2^261)
+static const uint32_t basepoint_table[16][2][9] = {
+{{0x15228783, 0x730d418, 0xdb00bcf, 0x57f11fb, 0xa20eb75, 0x12b77622, 0x330fdb9, 0x1af4dd57, 0x120bee},
+{0x12aac150, 0x125357ce, 0xf22e6ef, 0xe390e86, 0x64b1695, 0x88dd21f, 0x2a97443, 0x2962176, 0xae3fe3}},
+{{0x1bbac9be, 0x46d410, 0x1c13ec28, 0x18f02d0c, 0x1b354d5, 0x1038d149, 0x1d419102, 0x14b73ce8, 0xd7665c},
+{0x17dc34af, 0x1648d361, 0x1b7fc179, 0x15f2dcc8, 0x1b7c2a59, 0x10e92042, 0x1d50d47d, 0x6096e28, 0x18aeea}},
+{{0x1d7824e4, 0xc3f904e, 0xc0fdffd, 0x1e127a1f, 0x1931604f, 0x1dd87cbb, 0x1f2356bb, 0x1f5bfdd1, 0xd26d47},
+{0x1074fd7a, 0xc5c1fc9, 0xff0d582, 0x11eb0e18, 0x131cb07c, 0x311a2ee, 0x3544104, 0xad61f30, 0xbe0d45}},
+{{0x1231b98a, 0x10b50d46, 0x1e0b9ba5, 0x9bb5d88, 0x15e48ca1, 0xace8100, 0x155e6d56, 0x1646c05d, 0xee6c5e},
+{0x197574d0, 0x16f24ce4, 0x17a2396c, 0x11c5eb5, 0x45c2ec5, 0xdee5ddd, 0x1175b61b, 0x7316ae1, 0x962987}},
+{{0xb8c3eb9, 0x1b8aaec4, 0xa9bedf0, 0x1926732e, 0x41921d8, 0x1aad076c, 0x3e60e5a, 0x1944148f, 0x20f2c0},
+{0x1749e20e, 0x109b4ae7, 0x1c415f59, 0x1a3bdd7a, 0x1ed0e78a, 0x1877e7a1, 0xae2a054, 0xe7747a4, 0x740ed7}},
+{{0xeecc942, 0x1947373e, 0x771f201, 0x1d13c91b, 0x75aab5c, 0x1a5b17a, 0x19e2854b, 0x59084d9, 0x60e96b},
+{0xefc8974, 0x136220d3, 0x18a5ac9e, 0xad4c37f, 0x1e225338, 0x4cef639, 0xfaa126a, 0x17a81fdd, 0x99322d}},
+{{0x2e769e2, 0x6354ea0, 0x7b83a, 0x84f08f, 0x161057a4, 0xb50c23b, 0x1f21f55, 0x74c48f8, 0x774a23},
+{0xb73a9bd, 0x7d0303f, 0x13dee942, 0x1cbc5d69, 0x32ace85, 0x1dc77c94, 0x1383c99d, 0x19589021, 0x5dbb22}},
+{{0x1334f1f6, 0x114cd194, 0x19a2a93f, 0xd712fe6, 0x18d68c55, 0x2af02cf, 0x66fc878, 0x1d89948c, 0xec7123},
+{0x5a92eea, 0x1da3a953, 0x15d0afac, 0xc9f5fe7, 0x17e043c6, 0x184be60b, 0x1ae11e3d, 0xb1c1b7d, 0xdd825e}},
+{{0x9c41d1c, 0x96e8f26, 0x1d420bae, 0xffb1e69, 0x160157cd, 0x444c8e, 0x1526604e, 0x7431385, 0xb6610},
+{0xbe66281, 0x17777aa4, 0xa2f18f5, 0x1efb7197, 0x1e34ad5e, 0x19a88b12, 0xd91b700, 0x18160d7e, 0xccb39}},
+{{0x1843d919, 0x18dbd19d, 0x1c09c960, 0x1a251f3, 0x169331f3, 0xd648250, 0x755be96, 0x1fb2cd0a, 0x8c3928},
+{0x1bb3cecf, 0xb407880, 0x1df04061, 0x264300f, 0xba58875, 0x165779be, 0x1a73be96, 0x158ced2a, 0xe334a}},
+{{0x8bc8087, 0x1d260a62, 0x1eff0753, 0x1e54d9f, 0x156b3bc8, 0x158dac1, 0x1973f9d2, 0x6727241, 0xce121e},
+{0x1289d10d, 0x1685612b, 0x1b0e40d3, 0x4e79f5f, 0x87a4a1f, 0x891ead6, 0x6d206d5, 0x112496e2, 0x126004}},
+{{0xd2eed09, 0x171aa7d2, 0x2d19825, 0x17bd608d, 0x10bd57bd, 0x9dee373, 0xaee04e9, 0x4e0f85, 0xdc3bef},
+{0x176b686f, 0xc12d91c, 0xab1b865, 0x14bd94a2, 0x1acc2e1d, 0xfa8ade6, 0x4d81146, 0x172c8e2b, 0xfeaf92}},
+{{0x5dae12e, 0x425634b, 0x1e986e66, 0x19da455b, 0x10221c6a, 0x3f559e9, 0xca65e6a, 0x130e56dd, 0x708ef5},
+{0x1dc2fff, 0x152b90c0, 0x169719ab, 0xe3df0b, 0x1782d0e9, 0x22bd1f5, 0xb426832, 0xb079ede, 0x7810ed}},
+{{0x19ecc95f, 0x2a35bb0, 0x183f1d12, 0x123da1e5, 0xcc024dc, 0x154c6832, 0x168f8bdf, 0xfd44b1c, 0x55ce66},
+{0xbab0d62, 0x152db799, 0x11be113d, 0x15a79cc8, 0xfb77c52, 0x13e2a65e, 0x1dec720c, 0x10faa86e, 0xa4e0db}},
+{{0xc00ab7c, 0x1cd8b7bc, 0x13f25b95, 0x8fb5db8, 0x6e00798, 0x24e4819, 0x48719ba, 0xfab4f68, 0x5541c8},
+{0x10788ba4, 0x18524f63, 0xd92a05, 0xd5508a9, 0xf2faecc, 0xde778a4, 0x1a2277d3, 0xa41e6b7, 0x842e1}},
+{{0x18df700a, 0xb0b650b, 0x11735c04, 0x181d3bff, 0xa92b105, 0x17c2c83f, 0x11c2f797, 0x3840edc, 0x9ac790},
+{0x1447f36c, 0x111bd652, 0x1b2c3f97, 0x10c63ac2, 0x1d3c6ce1, 0x3bb1580, 0xffae231, 0x987bf88, 0x9dbef6}}
+};
+
+AVX2 static inline void fe_set_const(fe* r, const uint32_t a[9]) {
+    for (int i = 0; i < 9; i++) {
+        r->v[i] = _mm256_set1_epi64x(a[i]);
+    }
+}
+
+// Propagates carries so that every limb is below 2^29 (the highest limb keeps the excess)
+AVX2 static inline void fe_carry(fe* r) {
+    const __m256i mask = _mm256_set1_epi64x(MASK29);
+    #pragma GCC unroll 8
+    for (int i = 0; i < 8; i++) {
+        r->v[i + 1] = _mm256_add_epi64(r->v[i + 1], _mm256_srli_epi64(r->v[i], 29));
+        r->v[i] = _mm256_and_si256(r->v[i], mask);
+    }
+}
+
+// Input: a carried value below 2^259, output: the same value mod p, below 2^256 + 2^227 < 2p
+AVX2 static inline void fe_fold(fe* r) {
+    __m256i h = _mm256_srli_epi64(r->v[8], 24);
+    r->v[8] = _mm256_and_si256(r->v[8], _mm256_set1_epi64x(0xffffff));
+    #pragma GCC unroll 9
+    for (int i = 0; i < 8; i++) {
+        r->v[i] = _mm256_add_epi64(r->v[i], _mm256_mul_epu32(h, _mm256_set1_epi64x(two_pow_256_mod_p29[i])));
+    }
+    fe_carry(r);
+}
+
+// r = a + b, inputs below 2p
+AVX2 static inline void fe_add(fe* r, const fe* a, const fe* b) {
+    #pragma GCC unroll 9
+    for (int i = 0; i < 9; i++) {
+        r->v[i] = _mm256_add_epi64(a->v[i], b->v[i]);
+    }
+    fe_carry(r);
+    fe_fold(r);
+}
+
+// r = a - b, inputs below 2p
+AVX2 static inline void fe_sub(fe* r, const fe* a, const fe* b) {
+    #pragma GCC unroll 9
+    for (int i = 0; i < 9; i++) {
+        r->v[i] = _mm256_sub_epi64(_mm256_add_epi64(a->v[i], _mm256_set1_epi64x(p29_times4_borrowed[i])), b->v[i]);
+    }
+    fe_carry(r);
+    fe_fold(r);
+}
+
+// Montgomery reduction of a 17 limb product t (each limb below 2^62, t[17] = 0), r = t / 2^261 mod p.
+// Since p = -1 mod 2^29, the multiple q of p to add in each step is simply the lowest limb. Adding q * p is done
+// using p = 2^256 - 2^224 + 2^192 + 2^96 - 1, where -q*2^224 is added as q*(2^29 - 2^21) to limb 7 and -q to limb 8
+// (relative to the current position) so that no limb ever becomes negative. The -q part cancels the lowest limb.
+AVX2 static inline void fe_reduce(fe* r, __m256i t[18]) {
+    const __m256i mask = _mm256_set1_epi64x(MASK29);
+    #pragma GCC unroll 9
+    for (int i = 0; i < 9; i++) {
+        __m256i q = _mm256_and_si256(t[i], mask);
+        t[i + 1] = _mm256_add_epi64(t[i + 1], _mm256_srli_epi64(t[i], 29));
+        t[i + 3] = _mm256_add_epi64(t[i + 3], _mm256_slli_epi64(q, 9));
+        t[i + 6] = _mm256_add_epi64(t[i + 6], _mm256_slli_epi64(q, 18));
+        t[i + 7] = _mm256_add_epi64(t[i + 7], _mm256_sub_epi64(_mm256_slli_epi64(q, 29), _mm256_slli_epi64(q, 21)));
+        t[i + 8] = _mm256_add_epi64(t[i + 8], _mm256_sub_epi64(_mm256_slli_epi64(q, 24), q));
+    }
+    #pragma GCC unroll 9
+    for (int i = 0; i < 9; i++) {
+        r->v[i] = t[i + 9];
+    }
+    fe_carry(r);
+}
+
+// Montgomery multiplication, r = a * b / 2^261 mod p, inputs below 4p, output below 2p
+AVX2 static void fe_mul(fe* r, const fe* a, const fe* b) {
+    __m256i t[18];
+    #pragma GCC unroll 18
+    for (int k = 0; k < 18; k++) {
+        t[k] = _mm256_setzero_si256();
+    }
+    #pragma GCC unroll 9
+    for (int i = 0; i < 9; i++) {
+        #pragma GCC unroll 9
+        for (int j = 0; j < 9; j++) {
+            t[i + j] = _mm256_add_epi64(t[i + j], _mm256_mul_epu32(a->v[i], b->v[j]));
+        }
+    }
+    fe_reduce(r, t);
+}
+
+// Montgomery squaring, r = a^2 / 2^261 mod p, input below 4p, output below 2p
+AVX2 static void fe_sqr(fe* r, const fe* a) {
+    __m256i t[18], a2[9];
+    #pragma GCC unroll 9
+    for (int i = 0; i < 9; i++) {
+        a2[i] = _mm256_add_epi64(a->v[i], a->v[i]);
+        t[2 * i] = _mm256_mul_epu32(a->v[i], a->v[i]);
+        t[2 * i + 1] = _mm256_setzero_si256();
+    }
+    #pragma GCC unroll 9
+    for (int i = 0; i < 9; i++) {
+        #pragma GCC unroll 9
+        for (int j = i + 1; j < 9; j++) {
+            t[i + j] = _mm256_add_epi64(t[i + j], _mm256_mul_epu32(a->v[i], a2[j]));
+        }
+    }
+    fe_reduce(r, t);
+}
+
+// Returns a lane mask of the lanes where a = 0 (mod p), for an input below 2p
+AVX2 static __m256i fe_is_zero(const fe* a) {
+    __m256i all_zero = _mm256_set1_epi64x(-1), all_p = _mm256_set1_epi64x(-1);
+    for (int i = 0; i < 9; i++) {
+        all_zero = _mm256_and_si256(all_zero, _mm256_cmpeq_epi64(a->v[i], _mm256_setzero_si256()));
+        all_p = _mm256_and_si256(all_p, _mm256_cmpeq_epi64(a->v[i], _mm256_set1_epi64x(p29[i])));
+    }
+    return _mm256_or_si256(all_zero, all_p);
+}
+
+// r = mask ? b : a, lane by lane
+AVX2 static inline void fe_blend(fe* r, const fe* a, const fe* b, __m256i mask) {
+    #pragma GCC unroll 9
+    for (int i = 0; i < 9; i++) {
+        r->v[i] = _mm256_blendv_epi8(a->v[i], b->v[i], mask);
+    }
+}
+
+// Converts integers below p (little endian 32-bit words) to montgomery form
+AVX2 static void fe_from_words(fe* r, const uint32_t* const a[NUM_LANES]) {
+    uint64_t limbs[9][NUM_LANES];
+    for (int k = 0; k < NUM_LANES; k++) {
+        for (int i = 0; i < 9; i++) {
+            uint32_t bit = 29 * i, word = bit / 32, shift = bit % 32;
+            uint64_t v = a[k][word] >> shift;
+            if (shift > 3 && word < 7) {
+                v |= (uint64_t)a[k][word + 1] << (32 - shift);
+            }
+            limbs[i][k] = v & MASK29;
+        }
+    }
+    for (int i = 0; i < 9; i++) {
+        r->v[i] = _mm256_loadu_si256((const __m256i*)limbs[i]);
+    }
+    fe r2;
+    fe_set_const(&r2, r2_mod_p29);
+    fe_mul(r, r, &r2);
+}
+
+// Converts out of montgomery form to fully reduced integers (little endian 32-bit words)
+AVX2 static void fe_to_words(uint32_t out[NUM_LANES][8], const fe* a) {
+    fe one, t;
+    uint64_t limbs[9][NUM_LANES];
+    memset(&one, 0, sizeof(one));
+    one.v[0] = _mm256_set1_epi64x(1);
+    fe_mul(&t, a, &one);
+    for (int i = 0; i < 9; i++) {
+        _mm256_storeu_si256((__m256i*)limbs[i], t.v[i]);
+    }
+    for (int k = 0; k < NUM_LANES; k++) {
+        // The value is below 2p, so subtract p once if it is not below p
+        uint64_t v[9];
+        int64_t borrow = 0;
+        for (int i = 0; i < 9; i++) {
+            int64_t d = (int64_t)limbs[i][k] - p29[i] + borrow;
+            v[i] = (uint64_t)d & MASK29;
+            borrow = d >> 29;
+        }
+        if (borrow < 0) {
+            for (int i = 0; i < 9; i++) {
+                v[i] = limbs[i][k];
+            }
+        }
+        memset(out[k], 0, 32);
+        for (int i = 0; i < 9; i++) {
+            uint32_t bit = 29 * i, word = bit / 32, shift = bit % 32;
+            out[k][word] |= (uint32_t)(v[i] << shift);
+            if (shift > 3 && word < 7) {
+                out[k][word + 1] |= (uint32_t)(v[i] >> (32 - shift));
+            }
+        }
+    }
+}
+
+typedef struct {
+    fe x, y, z;
+} point_j;
+
+// dbl-2001-b, https://www.hyperelliptic.org/EFD/g1p/auto-shortw-jacobian-3.html
+AVX2 static void point_double(point_j* r, const point_j* a) {
+    fe delta, gamma, beta, alpha, t1, t2;
+    fe_sqr(&delta, &a->z);
+    fe_sqr(&gamma, &a->y);
+    fe_mul(&beta, &a->x, &gamma);
+    fe_sub(&t1, &a->x, &delta);
+    fe_add(&t2, &a->x, &delta);
+    fe_mul(&alpha, &t1, &t2);
+    fe_add(&t1, &alpha, &alpha);
+    fe_add(&alpha, &alpha, &t1);
+    // Z3 = 2 * Y1 * Z1
+    fe_mul(&t1, &a->y, &a->z);
+    fe_add(&r->z, &t1, &t1);
+    // X3 = alpha^2 - 8 * beta
+    fe_add(&beta, &beta, &beta);
+    fe_add(&beta, &beta, &beta);
+    fe_sqr(&t1, &alpha);
+    fe_sub(&t1, &t1, &beta);
+    fe_sub(&r->x, &t1, &beta);
+    // Y3 = alpha * (4 * beta - X3) - 8 * gamma^2
+    fe_sub(&t1, &beta, &r->x);
+    fe_mul(&t1, &alpha, &t1);
+    fe_sqr(&t2, &gamma);
+    fe_add(&t2, &t2, &t2);
+    fe_add(&t2, &t2, &t2);
+    fe_add(&t2, &t2, &t2);
+    fe_sub(&r->y, &t1, &t2);
+}
+
+// Adds the points a and b, where b is in affine coordinates if b_is_affine (and b->z is then not used).
+// add-2007-bl and madd-2007-bl, https://www.hyperelliptic.org/EFD/g1p/auto-shortw-jacobian-3.html
+// Returns a lane mask of the lanes where the formula is not valid, i.e. where x(a) = x(b).
+AVX2 static __m256i point_add(point_j* r, const point_j* a, const point_j* b, bool b_is_affine) {
+    fe z1z1, u1, u2, s1, s2, h, i, j, rr, v, t;
+    fe_sqr(&z1z1, &a->z);
+    fe_mul(&u2, &b->x, &z1z1);
+    fe_mul(&s2, &b->y, &a->z);
+    fe_mul(&s2, &s2, &z1z1);
+    if (b_is_affine) {
+        u1 = a->x;
+        s1 = a->y;
+    } else {
+        fe z2z2;
+        fe_sqr(&z2z2, &b->z);
+        fe_mul(&u1, &a->x, &z2z2);
+        fe_mul(&s1, &a->y, &b->z);
+        fe_mul(&s1, &s1, &z2z2);
+    }
+    fe_sub(&h, &u2, &u1);
+    __m256i exceptional = fe_is_zero(&h);
+    fe_add(&i, &h, &h);
+    fe_sqr(&i, &i);
+    fe_mul(&j, &h, &i);
+    fe_sub(&rr, &s2, &s1);
+    fe_add(&rr, &rr, &rr);
+    fe_mul(&v, &u1, &i);
+    // X3 = r^2 - J - 2 * V
+    fe_sqr(&t, &rr);
+    fe_sub(&t, &t, &j);
+    fe_sub(&t, &t, &v);
+    fe_sub(&r->x, &t, &v);
+    // Y3 = r * (V - X3) - 2 * S1 * J
+    fe_sub(&t, &v, &r->x);
+    fe_mul(&t, &rr, &t);
+    fe_mul(&s1, &s1, &j);
+    fe_add(&s1, &s1, &s1);
+    fe_sub(&r->y, &t, &s1);
+    // Z3 = 2 * Z1 * Z2 * H
+    fe_mul(&t, &a->z, &h);
+    if (!b_is_affine) {
+        fe_mul(&t, &t, &b->z);
+    }
+    fe_add(&r->z, &t, &t);
+    return exceptional;
+}
+
+// Recodes a scalar below 2^256 into digits d[0..NUM_WINDOWS-1] in the range [-16, 16],
+// so that the scalar = d[0] + d[1] * 2^5 + d[2] * 2^10 + ...
+static void recode_fixed_window(signed char d[NUM_WINDOWS], const uint32_t a[8]) {
+    int carry = 0;
+    for (int i = 0; i < NUM_WINDOWS; i++) {
+        uint32_t bit = WINDOW_BITS * i, word = bit / 32, shift = bit % 32;
+        uint32_t v = word < 8 ? a[word] >> shift : 0;
+        if (shift > 32 - WINDOW_BITS && word < 7) {
+            v |= a[word + 1] << (32 - shift);
+        }
+        int digit = (int)(v & ((1 << WINDOW_BITS) - 1)) + carry;
+        carry = digit > (1 << (WINDOW_BITS - 1));
+        d[i] = (signed char)(digit - (carry << WINDOW_BITS));
+    }
+}
+
+// Adds the table entries selected by the digits (one per lane) to the accumulated point.
+// Lanes where the digit is 0 are left untouched. Lanes where the accumulated point is the point at infinity get the
+// selected entry. Lanes where the addition formula is not valid are added to the fallback mask.
+AVX2 static void add_selected(point_j* acc, __m256i* acc_is_inf, __m256i* fallback, const void* table, bool table_is_affine, const signed char digits[NUM_LANES]) {
+    point_j selected, sum;
+    long long index[NUM_LANES], is_negative[NUM_LANES], is_nonzero[NUM_LANES];
+    for (int k = 0; k < NUM_LANES; k++) {
+        int abs_digit = digits[k] < 0 ? -digits[k] : digits[k];
+        index[k] = abs_digit == 0 ? 0 : abs_digit - 1;
+        is_negative[k] = digits[k] < 0 ? -1 : 0;
+        is_nonzero[k] = digits[k] != 0 ? -1 : 0;
+    }
+    
+    if (table_is_affine) {
+        // basepoint_table[index][coordinate][limb], 32-bit limbs
+        const int* base = (const int*)table;
+        __m128i offsets = _mm_set_epi32(index[3] * 18, index[2] * 18, index[1] * 18, index[0] * 18);
+        for (int i = 0; i < 9; i++) {
+            selected.x.v[i] = _mm256_cvtepu32_epi64(_mm_i32gather_epi32(base + i, offsets, 4));
+            selected.y.v[i] = _mm256_cvtepu32_epi64(_mm_i32gather_epi32(base + 9 + i, offsets, 4));
+        }
+        fe_set_const(&selected.z, one_mont29);
+    } else {
+        // point_j table[16], with 4 lanes per limb
+        const long long* base = (const long long*)table;
+        const long long stride = sizeof(point_j) / 8;
+        __m256i offsets = _mm256_set_epi64x(index[3] * stride + 3, index[2] * stride + 2, index[1] * stride + 1, index[0] * stride);
+        for (int i = 0; i < 9; i++) {
+            selected.x.v[i] = _mm256_i64gather_epi64(base + 4 * i, offsets, 8);
+            selected.y.v[i] = _mm256_i64gather_epi64(base + 4 * (9 + i), offsets, 8);
+            selected.z.v[i] = _mm256_i64gather_epi64(base + 4 * (18 + i), offsets, 8);
+        }
+    }
+    
+    fe zero, neg_y;
+    memset(&zero, 0, sizeof(zero));
+    fe_sub(&neg_y, &zero, &selected.y);
+    fe_blend(&selected.y, &selected.y, &neg_y, _mm256_loadu_si256((const __m256i*)is_negative));
+    
+    __m256i nonzero = _mm256_loadu_si256((const __m256i*)is_nonzero);
+    __m256i exceptional = point_add(&sum, acc, &selected, table_is_affine);
+    __m256i use_sum = _mm256_andnot_si256(*acc_is_inf, nonzero);
+    __m256i use_selected = _mm256_and_si256(*acc_is_inf, nonzero);
+    *fallback = _mm256_or_si256(*fallback, _mm256_and_si256(exceptional, use_sum));
+    
+    fe_blend(&acc->x, &acc->x, &sum.x, use_sum);
+    fe_blend(&acc->y, &acc->y, &sum.y, use_sum);
+    fe_blend(&acc->z, &acc->z, &sum.z, use_sum);
+    fe_blend(&acc->x, &acc->x, &selected.x, use_selected);
+    fe_blend(&acc->y, &acc->y, &selected.y, use_selected);
+    fe_blend(&acc->z, &acc->z, &selected.z, use_selected);
+    *acc_is_inf = _mm256_andnot_si256(nonzero, *acc_is_inf);
+}
+
+// Verifies NUM_LANES signatures, where active[k] tells if lane k contains a signature that has passed the range and
+// public key checks. For the other lanes, the input is a dummy value and the result is ignored.
+// Sets results[k] and returns a bit mask of the lanes that must be verified again using p256_verify.
+AVX2 static uint32_t verify_lanes(bool results[NUM_LANES], const uint32_t* const pk_x[NUM_LANES], const uint32_t* const pk_y[NUM_LANES],
+                                  const uint32_t* const r[NUM_LANES], const uint32_t u1[NUM_LANES][8], const uint32_t u2[NUM_LANES][8]) {
+    // Create a table of P, 2P, ..., 16P. Since P has prime order, the additions never hit an exceptional case.
+    point_j pk_table[16], pk_affine;
+    fe_from_words(&pk_affine.x, pk_x);
+    fe_from_words(&pk_affine.y, pk_y);
+    fe_set_const(&pk_affine.z, one_mont29);
+    pk_table[0] = pk_affine;
+    point_double(&pk_table[1], &pk_table[0]);
+    for (int i = 2; i < 16; i++) {
+        point_add(&pk_table[i], &pk_table[i - 1], &pk_affine, true);
+    }
+    
+    signed char digits_u1[NUM_LANES][NUM_WINDOWS], digits_u2[NUM_LANES][NUM_WINDOWS];
+    for (int k = 0; k < NUM_LANES; k++) {
+        recode_fixed_window(digits_u1[k], u1[k]);
+        recode_fixed_window(digits_u2[k], u2[k]);
+    }
+    
+    point_j acc;
+    memset(&acc, 0, sizeof(acc));
+    __m256i acc_is_inf = _mm256_set1_epi64x(-1), fallback = _mm256_setzero_si256();
+    for (int i = NUM_WINDOWS - 1; i >= 0; i--) {
+        if (i != NUM_WINDOWS - 1) {
+            for (int j = 0; j < WINDOW_BITS; j++) {
+                point_double(&acc, &acc);
+            }
+        }
+        signed char digits[NUM_LANES];
+        for (int k = 0; k < NUM_LANES; k++) {
+            digits[k] = digits_u1[k][i];
+        }
+        add_selected(&acc, &acc_is_inf, &fallback, basepoint_table, true, digits);
+        for (int k = 0; k < NUM_LANES; k++) {
+            digits[k] = digits_u2[k][i];
+        }
+        add_selected(&acc, &acc_is_inf, &fallback, pk_table, false, digits);
+    }
+    
+    // The last step is done by P256_verify_last_step, which uses the ordinary montgomery form
+    uint32_t x[NUM_LANES][8], z[NUM_LANES][8];
+    fe_to_words(x, &acc.x);
+    fe_to_words(z, &acc.z);
+    long long is_inf[NUM_LANES], needs_fallback[NUM_LANES];
+    _mm256_storeu_si256((__m256i*)is_inf, acc_is_inf);
+    _mm256_storeu_si256((__m256i*)needs_fallback, fallback);
+    uint32_t fallback_mask = 0;
+    for (int k = 0; k < NUM_LANES; k++) {
+        uint32_t jacobian_point[3][8] = {{0}};
+        if (needs_fallback[k]) {
+            fallback_mask |= 1 << k;
+            continue;
+        }
+        if (is_inf[k]) {
+            results[k] = false;
+            continue;
+        }
+        P256_to_montgomery(jacobian_point[0], x[k]);
+        P256_to_montgomery(jacobian_point[2], z[k]);
+        results[k] = P256_verify_last_step(r[k], (const uint32_t (*)[8])jacobian_point);
+    }
+    return fallback_mask;
+}
+
+static bool cpu_has_avx2(void) {
+    return __builtin_cpu_supports("avx2");
+}
+
+// Takes the leftmost 256 bits in hash (treated as big endian), and converts to little endian integer z.
+// Same as hash_to_z in p256-cortex-m4.c.
+static void hash_to_z(uint32_t z[8], const uint8_t* hash, uint32_t hashlen) {
+    if (hashlen > 32) {
+        hashlen = 32;
+    }
+    for (uint32_t i = 0; i < hashlen; i++) {
+        ((uint8_t*)z)[i] = hash[hashlen - 1 - i];
+    }
+    for (uint32_t i = hashlen; i < 32; i++) {
+        ((uint8_t*)z)[i] = 0;
+    }
+}
+#endif
+
+uint32_t p256_verify_multi_lanes(void) {
+    #if HAS_AVX2_ENGINE
+    if (cpu_has_avx2()) {
+        return NUM_LANES;
+    }
+    #endif
+    return 1;
+}
+
+bool p256_verify_multi(bool results[], const struct VerifyBatchItem items[], uint32_t num_items) {
+    bool all_valid = true;
+    
+    #if HAS_AVX2_ENGINE
+    if (cpu_has_avx2()) {
+        static const uint32_t dummy_one[8] = {1};
+        static const uint32_t gx[8] = {0xd898c296, 0xf4a13945, 0x2deb33a0, 0x77037d81, 0x63a440f2, 0xf8bce6e5, 0xe12c4247, 0x6b17d1f2};
+        static const uint32_t gy[8] = {0x37bf51f5, 0xcbb64068, 0x6b315ece, 0x2bce3357, 0x7c0f9e16, 0x8ee7eb4a, 0xfe1a7f9b, 0x4fe342e2};
+        
+        for (uint32_t start = 0; start < num_items; start += NUM_LANES) {
+            const uint32_t* pk_x[NUM_LANES];
+            const uint32_t* pk_y[NUM_LANES];
+            const uint32_t* r[NUM_LANES];
+            uint32_t z[NUM_LANES][8], s[NUM_LANES][8], u1[NUM_LANES][8], u2[NUM_LANES][8];
+            bool active[NUM_LANES], lane_results[NUM_LANES];
+            
+            // The same checks as in p256_verify. Lanes that fail, and unused lanes, get the dummy input P = G, u1 = u2 = 1.
+            for (int k = 0; k < NUM_LANES; k++) {
+                const struct VerifyBatchItem* item = start + k < num_items ? &items[start + k] : NULL;
+                active[k] = false;
+                if (item != NULL && P256_check_range_n(item->r) && P256_check_range_n(item->s) &&
+                    P256_check_range_p(item->public_key_x) && P256_check_range_p(item->public_key_y)) {
+                    uint32_t x_mont[8], y_mont[8];
+                    P256_to_montgomery(x_mont, item->public_key_x);
+                    P256_to_montgomery(y_mont, item->public_key_y);
+                    active[k] = P256_point_is_on_curve(x_mont, y_mont);
+                }
+                if (active[k]) {
+                    pk_x[k] = item->public_key_x;
+                    pk_y[k] = item->public_key_y;
+                    r[k] = item->r;
+                    memcpy(s[k], item->s, 32);
+                    hash_to_z(z[k], item->hash, item->hashlen_in_bytes);
+                } else {
+                    pk_x[k] = gx;
+                    pk_y[k] = gy;
+                    r[k] = dummy_one;
+                    memcpy(s[k], dummy_one, 32);
+                    memcpy(z[k], dummy_one, 32);
+                }
+            }
+            
+            // u1 = z/s and u2 = r/s (mod n), using one inversion for all lanes (Montgomery's trick)
+            uint32_t prefix[NUM_LANES][8], inv[8];
+            memcpy(prefix[0], s[0], 32);
+            for (int k = 1; k < NUM_LANES; k++) {
+                P256_mul_mod_n(prefix[k], prefix[k - 1], s[k]);
+            }
+            P256_mod_n_inv_vartime(inv, prefix[NUM_LANES - 1]);
+            for (int k = NUM_LANES - 1; k >= 0; k--) {
+                uint32_t w[8];
+                if (k > 0) {
+                    P256_mul_mod_n(w, inv, prefix[k - 1]);
+                    P256_mul_mod_n(inv, inv, s[k]);
+                } else {
+                    memcpy(w, inv, 32);
+                }
+                P256_mul_mod_n(u1[k], z[k], w);
+                P256_mul_mod_n(u2[k], r[k], w);
+            }
+            
+            uint32_t fallback = verify_lanes(lane_results, pk_x, pk_y, r, (const uint32_t (*)[8])u1, (const uint32_t (*)[8])u2);
+            
+            for (int k = 0; k < NUM_LANES && start + k < num_items; k++) {
+                const struct VerifyBatchItem* item = &items[start + k];
+                if (!active[k]) {
+                    results[start + k] = false;
+                } else if (fallback & (1 << k)) {
+                    results[start + k] = p256_verify(item->public_key_x, item->public_key_y, item->hash, item->hashlen_in_bytes, item->r, item->s);
+                } else {
+                    results[start + k] = lane_results[k];
+                }
+                all_valid &= results[start + k];
+            }
+        }
+        return all_valid;
+    }
+    #endif
+    
+    for (uint32_t i = 0; i < num_items; i++) {
+        const struct VerifyBatchItem* item = &items[i];
+        results[i] = p256_verify(item->public_key_x, item->public_key_y, item->hash, item->hashlen_in_bytes, item->r, item->s);
+        all_valid &= results[i];
+    }
+    return all_valid;
+}
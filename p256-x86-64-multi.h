@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2017-2021 Emil Lenngren
+ * Copyright (c) 2021 Shortcut Labs AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef P256_X86_64_MULTI_H
+#define P256_X86_64_MULTI_H
+
+#include "p256-cortex-m4.h"
+
+/*
+
+Multi-lane signature verification for x86-64 hosts.
+
+This file is an addition to the library for hosts that verify many signatures, such as servers that verify
+signatures created by devices. It must be linked together with p256-cortex-m4.c and the portable C backend
+(p256-cortex-m4-portable.c), and include_p256_verify must be enabled.
+
+*/
+
+/**
+ * Verifies multiple signatures independently of each other, with exactly the same semantics as calling
+ * p256_verify for each item, i.e. results[i] is set to the return value of p256_verify for items[i].
+ * The r_y_parity field of each item is not used.
+ *
+ * If the CPU supports AVX2 (detected at runtime), four signatures at a time are verified in parallel in the
+ * SIMD lanes. Otherwise, or if not compiled for x86-64, p256_verify is simply called for each item.
+ *
+ * In the rare case an intermediate point addition in a lane would need special handling (such as adding a point to
+ * itself), that signature is verified again using p256_verify, so the result is always the same.
+ *
+ * Returns true if all signatures are valid.
+ *
+ * Note: this function does not run in constant time, since it only processes public data.
+ */
+bool p256_verify_multi(bool results[], const struct VerifyBatchItem items[], uint32_t num_items);
+
+/**
+ * Returns the number of signatures p256_verify_multi verifies in parallel on this CPU (4 with AVX2, otherwise 1).
+ */
+uint32_t p256_verify_multi_lanes(void);
+
+#endif
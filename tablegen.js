@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2021 Shortcut Labs AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Generates the precomputed base point tables used in p256-cortex-m4.c.
+// execute "node tablegen.js verify <window_bits>", with a nodejs version >= 10.4,
+// and replace the corresponding table in p256-cortex-m4.c with the output.
+// "node tablegen.js comb <teeth> <tables>" generates p256-cortex-m4-comb-table.h, the fixed base comb table used when
+// fast_basemult_comb_teeth and fast_basemult_comb_tables (see p256-cortex-m4-config.h) are not the default values.
+// "node tablegen.js multi" generates the base point table in p256-x86-64-multi.c.
+
+// Simple affine point arithmetic that is correct, but slow and not side channel safe. Only used to generate tables.
+const q = 2n**256n - 2n**224n + 2n**192n + 2n**96n - 1n;
+const G = {x: 0x6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296n, y: 0x4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5n};
+
+function mod(v) {
+	v %= q;
+	return v < 0n ? v + q : v;
+}
+
+function modPow(b, e) {
+	let res = 1n;
+	b = mod(b);
+	while (e > 0n) {
+		if (e & 1n) {
+			res = res * b % q;
+		}
+		b = b * b % q;
+		e >>= 1n;
+	}
+	return res;
+}
+
+function modInv(v) {
+	return modPow(v, q - 2n);
+}
+
+function pointAdd(p1, p2) {
+	let lambda;
+	if (p1.x === p2.x) {
+		// Points at infinity are never generated by this script
+		lambda = mod((3n * p1.x**2n - 3n) * modInv(2n * p1.y));
+	} else {
+		lambda = mod((p2.y - p1.y) * modInv(p2.x - p1.x));
+	}
+	const x = mod(lambda**2n - p1.x - p2.x);
+	const y = mod(lambda * (p1.x - x) - p1.y);
+	return {x: x, y: y};
+}
+
+function toMontgomery(v) {
+	return (v << 256n) % q;
+}
+
+function formatInteger(v) {
+	const words = [];
+	for (let i = 0; i < 8; i++) {
+		words.push('0x' + ((v >> BigInt(32 * i)) & 0xffffffffn).toString(16));
+	}
+	return '{' + words.join(', ') + '}';
+}
+
+function formatPoint(p) {
+	return '{' + formatInteger(toMontgomery(p.x)) + ',\n' + formatInteger(toMontgomery(p.y)) + '}';
+}
+
+function verifyTable(windowBits) {
+	const numPoints = 1 << (windowBits - 1);
+	const G2 = pointAdd(G, G);
+	const points = [G];
+	for (let i = 1; i < numPoints; i++) {
+		points.push(pointAdd(points[i - 1], G2));
+	}
+	console.log('// This table contains 1G, 3G, 5G, ... ' + (2 * numPoints - 1) + 'G in affine coordinates in montgomery form');
+	console.log('static const uint32_t p256_basepoint_precomp[' + numPoints + '][2][8] P256_TABLE_SECTION = {');
+	console.log(points.map(formatPoint).join(',\n'));
+	console.log('};');
+}
+
+function pointNegate(p) {
+	return {x: p.x, y: mod(-p.y)};
+}
+
+function pointDouble(p) {
+	return pointAdd(p, p);
+}
+
+// The comb tables used by the fixed base scalar multiplication when use_fast_p256_basemult is enabled.
+// With d = 256 / teeth, table t contains, for each index m, the point
+// 2^(d / tables * t) * (2^((teeth-1)*d) +- 2^((teeth-2)*d) +- ... +- 2^d +- 1) * G,
+// where bit k of m is set if the sign of 2^(k*d) is +.
+function combTable(teeth, tables) {
+	const spacing = 256 / teeth, numPoints = 1 << (teeth - 1);
+	let base = G;
+	const allTables = [];
+	for (let t = 0; t < tables; t++) {
+		// terms[k] = 2^(k*d) * base
+		const terms = [base];
+		for (let k = 1; k < teeth; k++) {
+			let p = terms[k - 1];
+			for (let i = 0; i < spacing; i++) {
+				p = pointDouble(p);
+			}
+			terms.push(p);
+		}
+		const points = [terms[teeth - 1]];
+		for (let k = 0; k < teeth - 1; k++) {
+			points[0] = pointAdd(points[0], pointNegate(terms[k]));
+		}
+		for (let m = 1; m < numPoints; m++) {
+			// Flip the sign of the term of the highest set bit of m
+			const k = 31 - Math.clz32(m);
+			points.push(pointAdd(points[m ^ (1 << k)], pointDouble(terms[k])));
+		}
+		allTables.push(points);
+		for (let i = 0; i < spacing / tables; i++) {
+			base = pointDouble(base);
+		}
+	}
+	console.log('// Generated by "node tablegen.js comb ' + teeth + ' ' + tables + '"');
+	console.log('#if fast_basemult_comb_teeth != ' + teeth + ' || fast_basemult_comb_tables != ' + tables);
+	console.log('#error "p256-cortex-m4-comb-table.h was generated for a different comb layout"');
+	console.log('#endif');
+	console.log('// This contains ' + tables + ' tables, ' + numPoints + ' points each in affine coordinates in montgomery form,');
+	console.log('// where table t contains 2^(' + (spacing / tables) + 't)(2^' + ((teeth - 1) * spacing) + ' +- ... +- 2^' + spacing + ' +- 1)G');
+	console.log('static const uint32_t p256_basepoint_precomp2[' + tables + '][' + numPoints + '][2][8] P256_TABLE_SECTION =');
+	console.log('{\n' + allTables.map(points => '{\n' + points.map(formatPoint).join(',\n') + '\n}').join(',\n') + '\n};');
+}
+
+// Radix 2^29 representation (9 limbs) used by p256-x86-64-multi.c, in montgomery form where R = 2^261
+function formatInteger29(v) {
+	v = (v << 261n) % q;
+	const limbs = [];
+	for (let i = 0; i < 9; i++) {
+		limbs.push('0x' + ((v >> BigInt(29 * i)) & 0x1fffffffn).toString(16));
+	}
+	return '{' + limbs.join(', ') + '}';
+}
+
+function multiTable() {
+	const points = [G];
+	for (let i = 1; i < 16; i++) {
+		points.push(pointAdd(points[i - 1], G));
+	}
+	console.log('// This table contains 1G, 2G, 3G, ... 16G in affine coordinates in montgomery form (radix 2^29, R = 2^261)');
+	console.log('static const uint32_t basepoint_table[16][2][9] = {');
+	console.log(points.map(p => '{' + formatInteger29(p.x) + ',\n' + formatInteger29(p.y) + '}').join(',\n'));
+	console.log('};');
+}
+
+const args = process.argv.slice(2);
+if (args[0] === 'verify' && args.length === 2 && Number(args[1]) >= 4 && Number(args[1]) <= 7) {
+	verifyTable(Number(args[1]));
+} else if (args[0] === 'comb' && args.length === 3 && (args[1] === '4' || args[1] === '8') &&
+           Number.isInteger(Math.log2(Number(args[2]))) && Number(args[2]) <= 256 / Number(args[1])) {
+	combTable(Number(args[1]), Number(args[2]));
+} else if (args[0] === 'multi' && args.length === 1) {
+	multiTable();
+} else {
+	console.error('usage: node tablegen.js verify <window_bits (4-7)>');
+	console.error('       node tablegen.js comb <teeth (4 or 8)> <tables (power of two, at most 256 / teeth)>');
+	console.error('       node tablegen.js multi');
+	process.exit(1);
+}
@@ -167,6 +167,28 @@ function sign(z, privKey, k) {
 	return {r: r, s: s};
 }
 
+// Signs with k generated according to RFC 6979, using HMAC-SHA256
+function signDeterministic(hash, privKey) {
+	const hmac = (key, ...parts) => parts.reduce((h, p) => h.update(p), crypto.createHmac('sha256', key)).digest();
+	const z = bufferToBigInt(hash.slice(0, 32));
+	const x = bigIntToBuffer(privKey, 32), h1 = bigIntToBuffer(z % n, 32);
+	let v = Buffer.alloc(32, 1), key = Buffer.alloc(32, 0);
+	key = hmac(key, v, Buffer.from([0]), x, h1);
+	v = hmac(key, v);
+	key = hmac(key, v, Buffer.from([1]), x, h1);
+	v = hmac(key, v);
+	for (;;) {
+		v = hmac(key, v);
+		const k = bufferToBigInt(v);
+		const rs = sign(z, privKey, k);
+		if (rs !== null) {
+			return {k: k, r: rs.r, s: rs.s};
+		}
+		key = hmac(key, v, Buffer.from([0]));
+		v = hmac(key, v);
+	}
+}
+
 function bufferToBigInt(b) {
 	return BigInt('0x' + b.toString('hex'));
 }
@@ -321,6 +343,23 @@ async function ecdhTests() {
 		'{' + toUIntArr(bigIntToBuffer(d.k, 32), 4, 8) + ',\n' + toUIntArr(bigIntToBuffer(d.z, 32), 1, 1) + ',\n' + toUIntArr(bigIntToBuffer(d.priv, 32), 4, 8) + ',\n' +
 		toUIntArr(Buffer.concat([bigIntToBuffer(d.r, 32), bigIntToBuffer(d.s, 32)]), 4, 8) + '}'
 	).join(',\n') + '};');
+	
+	// The private key from RFC 6979, appendix A.2.5, where the messages "sample" and "test" are also given
+	const rfcPriv = 0xc9afa9d845ba75166b5c215767b1d6934e50c3db36e89b127b8a622b120f6721n;
+	assert.strictEqual(signDeterministic(sha256('sample'), rfcPriv).k, 0xa6e3c57dd01abe90086538398355dd4c3b17aa873382b0f24d6129493d8aad60n);
+	assert.strictEqual(signDeterministic(sha256('test'), rfcPriv).k, 0xd16b6ae827f17175e040871a1c7ec3500192c4c92677336ec2537acaee0008e0n);
+	const deterministicSignData = [
+		{hash: sha256('sample'), priv: rfcPriv},
+		{hash: sha256('test'), priv: rfcPriv},
+		{hash: Buffer.alloc(32, 0xff), priv: n - 1n},
+		{hash: sha256('short').slice(0, 20), priv: bufferToBigInt(sha256('test5p'))},
+		{hash: crypto.createHash('sha512').update('long').digest(), priv: bufferToBigInt(sha256('test6p'))},
+	].map(d => Object.assign(d, signDeterministic(d.hash, d.priv)));
+	deterministicSignData.forEach((d, i) => console.log('static const uint8_t deterministic_hash_' + i + '[] = ' + toUIntArr(d.hash, 1, 1) + ';'));
+	console.log('static const struct DeterministicSign deterministic_signs[] = {' + deterministicSignData.map((d, i) =>
+		'{deterministic_hash_' + i + ', ' + d.hash.length + ',\n' + toUIntArr(bigIntToBuffer(d.priv, 32), 4, 8) + ',\n' +
+		toUIntArr(Buffer.concat([bigIntToBuffer(d.r, 32), bigIntToBuffer(d.s, 32)]), 4, 8) + '}'
+	).join(',\n') + '};');
 }
 
 async function ecdsaVerifyTests() {
@@ -387,21 +426,67 @@ async function ecdsaVerifyTests() {
 	console.log('static const struct VerifyTest verify_tests[] = {' + resArr.map((test) => '{' + test.join(',') + '}').join(',\n') + '};\n');
 }
 
+// The messages are prefixes of the same generated byte sequence, which the C code recreates
+function verifyStreamMessage(len) {
+	return Buffer.from(Array.from({length: len}, (_, i) => (i * 167 + (i >> 8)) & 0xff));
+}
+
+function verifyStreamTests() {
+	const priv = bufferToBigInt(sha256('streamp'));
+	const pub = scalarmult(priv, G);
+	console.log('static const uint32_t verify_stream_key[] = ' + toUIntArr(Buffer.concat([bigIntToBuffer(pub.x, 32), bigIntToBuffer(pub.y, 32)]), 4, 8) + ';');
+	// Covers the padding boundaries (55/56 bytes), whole blocks and multiple blocks
+	const lengths = [0, 3, 55, 56, 63, 64, 65, 119, 120, 1000, 5000];
+	console.log('static const struct VerifyStreamTest verify_stream_tests[] = {' + lengths.map(len => {
+		const rs = sign(bufferToBigInt(sha256(verifyStreamMessage(len))), priv, bufferToBigInt(sha256('streamk' + len)));
+		return '{' + len + ',\n' + toUIntArr(Buffer.concat([bigIntToBuffer(rs.r, 32), bigIntToBuffer(rs.s, 32)]), 4, 8) + '}';
+	}).join(',\n') + '};');
+}
+
 (async () => {
 	console.log(`#include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "p256-cortex-m4.h"
+#if defined(__x86_64__) && include_p256_verify_batch
+#include "p256-x86-64-multi.h"
+#endif
+#if defined(__linux__)
+#include "p256-worker-pool.h"
+#endif
 #define COUNTOF(a) (sizeof(a) / sizeof((a)[0]))
 struct VerifyTest {const uint32_t* key; const uint8_t* msg; const uint32_t* sig; bool result;};
 struct EcdhTest {const uint8_t* pub; const uint32_t* priv; const uint8_t* shared; uint8_t publen; bool valid;};
 struct KeygenTest {const uint32_t* priv; const uint32_t* pub;};
 struct InvalidSign {const uint32_t k[8]; const uint8_t z[32]; const uint32_t priv[8];};
 struct ValidSign {const uint32_t k[8]; const uint8_t z[32]; const uint32_t priv[8]; const uint32_t sig[16];};
+struct DeterministicSign {const uint8_t* hash; uint32_t hashlen; const uint32_t priv[8]; const uint32_t sig[16];};
+struct VerifyStreamTest {uint32_t len; const uint32_t sig[16];};
 `)
 	await ecdhTests();
 	await ecdsaVerifyTests();
+	verifyStreamTests();
 	console.log(`
+#if include_p256_sign_pool
+// Returns the k values of valid_signs in order
+static bool sign_pool_test_random(void* ctx, uint8_t* out, uint32_t len) {
+	int* next = ctx;
+	if (*next == COUNTOF(valid_signs)) {
+		return false;
+	}
+	memcpy(out, valid_signs[(*next)++].k, len);
+	return true;
+}
+#endif
+
+#if defined(__linux__) && !p256_enable_stats
+static void worker_pool_test_callback(struct P256Job* job, void* user_data) {
+	if (job->result) {
+		__atomic_fetch_add((uint32_t*)user_data, 1, __ATOMIC_RELAXED);
+	}
+}
+#endif
+
 bool run_tests(void) {
 	for (int i = 0; i < COUNTOF(verify_tests); i++) {
 		const struct VerifyTest* t = &verify_tests[i];
@@ -409,6 +494,68 @@ bool run_tests(void) {
 			return false;
 		}
 	}
+#if include_p256_verify_precomp
+	for (int i = 0; i < COUNTOF(verify_tests); i++) {
+		const struct VerifyTest* t = &verify_tests[i];
+		struct PublicKeyPrecomp pk;
+		if ((p256_verify_precompute_public_key(&pk, t->key, t->key + 8) && p256_verify_precomp(&pk, t->msg, 32, t->sig, t->sig + 8)) != t->result) {
+			return false;
+		}
+	}
+#endif
+#if include_p256_verify_batch
+	for (int i = 0; i < COUNTOF(verify_tests); i += 8) {
+		struct VerifyBatchItem items[8];
+		uint32_t random[8][4];
+		bool results[8], all_valid = true;
+		int n = COUNTOF(verify_tests) - i < 8 ? COUNTOF(verify_tests) - i : 8;
+		for (int j = 0; j < n; j++) {
+			const struct VerifyTest* t = &verify_tests[i + j];
+			items[j] = (struct VerifyBatchItem){t->key, t->key + 8, t->msg, 32, t->sig, t->sig + 8, j % 3};
+			for (int k = 0; k < 4; k++) {
+				random[j][k] = 0x9e3779b9 * (i + j) + 0x7f4a7c15U * k;
+			}
+			all_valid &= t->result;
+		}
+		if (p256_verify_batch(results, items, n, random) != all_valid) {
+			return false;
+		}
+		for (int j = 0; j < n; j++) {
+			if (results[j] != verify_tests[i + j].result) {
+				return false;
+			}
+		}
+#if defined(__x86_64__)
+		if (p256_verify_multi(results, items, n) != all_valid) {
+			return false;
+		}
+		for (int j = 0; j < n; j++) {
+			if (results[j] != verify_tests[i + j].result) {
+				return false;
+			}
+		}
+#endif
+	}
+	{
+		struct VerifyBatchItem items[COUNTOF(valid_signs)];
+		uint32_t pub[COUNTOF(valid_signs)][16], random[COUNTOF(valid_signs)][4];
+		bool results[COUNTOF(valid_signs)];
+		for (int i = 0; i < COUNTOF(valid_signs); i++) {
+			const struct ValidSign* t = &valid_signs[i];
+			uint32_t rx[8], ry[8];
+			if (!p256_keygen(pub[i], pub[i] + 8, t->priv) || !p256_scalarmult_base(rx, ry, t->k)) {
+				return false;
+			}
+			items[i] = (struct VerifyBatchItem){pub[i], pub[i] + 8, t->z, 32, t->sig, t->sig + 8, ry[0] & 1};
+			for (int k = 0; k < 4; k++) {
+				random[i][k] = 0x9e3779b9 * i + 0x7f4a7c15U * k + 1;
+			}
+		}
+		if (!p256_verify_batch(results, items, COUNTOF(valid_signs), random)) {
+			return false;
+		}
+	}
+#endif
 	for (int i = 0; i < COUNTOF(ecdh_tests); i++) {
 		const struct EcdhTest* t = &ecdh_tests[i];
 		uint32_t x[8], y[8];
@@ -417,6 +564,41 @@ bool run_tests(void) {
 			return false;
 		}
 	}
+	for (int i = 0; i < COUNTOF(ecdh_tests); i++) {
+		const struct EcdhTest* t = &ecdh_tests[i];
+		uint32_t x[8], y[8];
+		uint8_t compressed[33], shared[32];
+		if (p256_octet_string_to_point(x, y, t->pub, t->publen)) {
+			p256_point_to_octet_string_compressed(compressed, x, y);
+		} else if (t->publen == 33) {
+			memcpy(compressed, t->pub, 33);
+		} else {
+			continue;
+		}
+		if ((p256_ecdh_calc_shared_secret_compressed(shared, t->priv, compressed) && memcmp(shared, t->shared, 32) == 0) != t->valid) {
+			return false;
+		}
+	}
+	for (int i = 0; i < COUNTOF(ecdh_tests); i++) {
+		const struct EcdhTest* t = &ecdh_tests[i];
+		uint32_t x[8], y[8];
+		uint8_t shared[32];
+		struct FixedPointPrecomp precomp;
+		if (!t->valid || !p256_octet_string_to_point(x, y, t->pub, t->publen)) {
+			continue;
+		}
+		if (!p256_fixed_point_precompute(&precomp, x, y)) {
+			return false;
+		}
+		p256_ecdh_with_precomp(shared, t->priv, &precomp);
+		if (memcmp(shared, t->shared, 32) != 0) {
+			return false;
+		}
+		y[0] ^= 1;
+		if (p256_fixed_point_precompute(&precomp, x, y)) {
+			return false;
+		}
+	}
 	for (int i = 0; i < COUNTOF(keygen_tests_ok); i++) {
 		const struct KeygenTest* t = &keygen_tests_ok[i];
 		uint32_t pub[16];
@@ -424,6 +606,36 @@ bool run_tests(void) {
 			return false;
 		}
 	}
+#if include_p256_keygen_batch
+	for (int i = 0; i < COUNTOF(keygen_tests_ok); i += 8) {
+		bool results[8];
+		uint32_t priv[8][8], x[8][8], y[8][8];
+		int n = COUNTOF(keygen_tests_ok) - i < 8 ? COUNTOF(keygen_tests_ok) - i : 8;
+		for (int j = 0; j < n; j++) {
+			memcpy(priv[j], keygen_tests_ok[i + j].priv, 32);
+		}
+		if (!p256_keygen_batch(results, x, y, priv, n)) {
+			return false;
+		}
+		for (int j = 0; j < n; j++) {
+			if (memcmp(x[j], keygen_tests_ok[i + j].pub, 32) != 0 || memcmp(y[j], keygen_tests_ok[i + j].pub + 8, 32) != 0) {
+				return false;
+			}
+		}
+	}
+	{
+		bool results[COUNTOF(keygen_tests_fail)];
+		uint32_t x[COUNTOF(keygen_tests_fail)][8], y[COUNTOF(keygen_tests_fail)][8];
+		if (p256_keygen_batch(results, x, y, keygen_tests_fail, COUNTOF(keygen_tests_fail))) {
+			return false;
+		}
+		for (int i = 0; i < COUNTOF(keygen_tests_fail); i++) {
+			if (results[i]) {
+				return false;
+			}
+		}
+	}
+#endif
 	for (int i = 0; i < COUNTOF(keygen_tests_fail); i++) {
 		uint32_t x[8], y[8];
 		if (p256_keygen(x, y, keygen_tests_fail[i])) {
@@ -444,6 +656,357 @@ bool run_tests(void) {
 			return false;
 		}
 	}
+#if include_p256_sign_batch
+	for (int i = 0; i < COUNTOF(valid_signs); i += 8) {
+		struct SignPrecomp precomp[8];
+		uint32_t k[8][8], random[8];
+		bool results[8];
+		int n = COUNTOF(valid_signs) - i < 8 ? COUNTOF(valid_signs) - i : 8;
+		for (int j = 0; j < n; j++) {
+			memcpy(k[j], valid_signs[i + j].k, 32);
+		}
+		// The first batch uses a blinding value of 0, which must be handled as well
+		for (int j = 0; j < 8; j++) {
+			random[j] = i == 0 ? 0 : 0x9e3779b9 * (i + j) + 0x7f4a7c15U;
+		}
+		if (!p256_sign_step1_batch(results, precomp, k, n, random)) {
+			return false;
+		}
+		for (int j = 0; j < n; j++) {
+			const struct ValidSign* t = &valid_signs[i + j];
+			uint32_t sig[16];
+			if (!p256_sign_step2(sig, sig + 8, t->z, 32, t->priv, &precomp[j]) || memcmp(sig, t->sig, 64) != 0) {
+				return false;
+			}
+		}
+	}
+#endif
+#if p256_enable_stats
+	{
+		// The doublings and additions of verify do not depend on the configuration or the input
+		const struct VerifyTest* t = &verify_tests[0];
+		while (!t->result) {
+			t++;
+		}
+		struct P256Stats stats;
+		p256_reset_stats();
+		if (!p256_verify(t->key, t->key + 8, t->msg, 32, t->sig, t->sig + 8)) {
+			return false;
+		}
+		p256_get_stats(&stats);
+		if (stats.phase[P256_STATS_PHASE_TABLE].double_j != 1 || stats.phase[P256_STATS_PHASE_TABLE].add_sub_j != 7 ||
+			stats.phase[P256_STATS_PHASE_MAIN_LOOP].double_j != 257 || stats.phase[P256_STATS_PHASE_TO_AFFINE].double_j != 0 ||
+			stats.total.double_j != 258 || stats.total.inv_mod_n != 1 || stats.total.mulmod == 0) {
+			return false;
+		}
+		p256_reset_stats();
+		p256_get_stats(&stats);
+		if (stats.total.mulmod != 0 || stats.phase[P256_STATS_PHASE_MAIN_LOOP].double_j != 0) {
+			return false;
+		}
+#if use_safegcd_mod_p_inv
+		// The conversion to affine coordinates at the end of keygen is one safegcd inversion, not an exponentiation
+		uint32_t pub[16];
+		if (!p256_keygen(pub, pub + 8, keygen_tests_ok[0].priv)) {
+			return false;
+		}
+		p256_get_stats(&stats);
+		if (stats.total.inv_mod_p != 1 || stats.total.modinv_sqrt != 0) {
+			return false;
+		}
+#endif
+	}
+#endif
+#if include_p256_verify_stream
+	{
+		// One extra byte, so that the message can also be placed at an unaligned address
+		static uint32_t message_buf[(5000 + 1 + 3) / 4];
+		static const uint32_t chunk_sizes[] = {1, 7, 64, 100, 5000};
+		for (int i = 0; i < COUNTOF(verify_stream_tests); i++) {
+			const struct VerifyStreamTest* t = &verify_stream_tests[i];
+			uint8_t* message;
+			struct P256VerifyStream stream;
+			for (int j = 0; j < COUNTOF(chunk_sizes); j++) {
+				message = (uint8_t*)message_buf + (j & 1);
+				for (uint32_t k = 0; k < t->len; k++) {
+					message[k] = (uint8_t)(k * 167 + (k >> 8));
+				}
+				p256_verify_init(&stream);
+				for (uint32_t pos = 0; pos < t->len; pos += chunk_sizes[j]) {
+					p256_verify_update(&stream, message + pos, t->len - pos < chunk_sizes[j] ? t->len - pos : chunk_sizes[j]);
+				}
+				if (!p256_verify_final(&stream, verify_stream_key, verify_stream_key + 8, t->sig, t->sig + 8)) {
+					return false;
+				}
+			}
+			if (t->len != 0) {
+				message[t->len / 2] ^= 1;
+				p256_verify_init(&stream);
+				p256_verify_update(&stream, message, t->len);
+				if (p256_verify_final(&stream, verify_stream_key, verify_stream_key + 8, t->sig, t->sig + 8)) {
+					return false;
+				}
+			}
+		}
+	}
+#endif
+#if include_p256_sign_deterministic
+	for (int i = 0; i < COUNTOF(deterministic_signs); i++) {
+		const struct DeterministicSign* t = &deterministic_signs[i];
+		uint32_t sig[16];
+		if (!p256_sign_deterministic(sig, sig + 8, t->hash, t->hashlen, t->priv) || memcmp(sig, t->sig, 64) != 0) {
+			return false;
+		}
+	}
+	for (int i = 0; i < COUNTOF(keygen_tests_fail); i++) {
+		uint32_t sig[16];
+		if (p256_sign_deterministic(sig, sig + 8, deterministic_signs[0].hash, 32, keygen_tests_fail[i])) {
+			return false;
+		}
+	}
+#endif
+#if include_p256_sign_pool
+	{
+		int next = 0;
+		struct P256SignPoolStats stats;
+		p256_sign_pool_init(sign_pool_test_random, &next);
+		for (int i = 0; i < COUNTOF(valid_signs); i++) {
+			const struct ValidSign* t = &valid_signs[i];
+			uint32_t sig[16];
+			// Every other signature is created from the pool, the rest use the full path
+			if (i % 2 == 0 && p256_sign_pool_refill(1) != 1) {
+				return false;
+			}
+			if (!p256_sign_fast(sig, sig + 8, t->z, 32, t->priv) || memcmp(sig, t->sig, 64) != 0) {
+				return false;
+			}
+		}
+		p256_sign_pool_get_stats(&stats);
+		if (stats.hits != (COUNTOF(valid_signs) + 1) / 2 || stats.misses != COUNTOF(valid_signs) / 2 || stats.available != 0) {
+			return false;
+		}
+		// The random source is now exhausted
+		uint32_t sig[16];
+		if (p256_sign_pool_refill(sign_pool_size) != 0 || p256_sign_fast(sig, sig + 8, valid_signs[0].z, 32, valid_signs[0].priv)) {
+			return false;
+		}
+	}
+#endif
+#if include_p256_der
+	for (int i = 0; i < COUNTOF(verify_tests); i++) {
+		const struct VerifyTest* t = &verify_tests[i];
+		uint8_t der[73];
+		uint32_t sig[16];
+		uint32_t len = p256_signature_to_der(der, t->sig, t->sig + 8);
+		if (!p256_signature_from_der(sig, sig + 8, der, len) || memcmp(sig, t->sig, 64) != 0) {
+			return false;
+		}
+		der[len] = 0;
+		if (p256_signature_from_der(sig, sig + 8, der, len - 1) || p256_signature_from_der(sig, sig + 8, der, len + 1)) {
+			return false;
+		}
+	}
+	{
+		static const uint32_t small[2][8] = {{1}, {0x80}};
+		static const uint8_t small_der[] = {0x30, 0x07, 0x02, 0x01, 0x01, 0x02, 0x02, 0x00, 0x80};
+		static const struct {uint8_t len; uint8_t der[9];} invalid_der[] = {
+			{9, {0x30, 0x07, 0x02, 0x02, 0x00, 0x01, 0x02, 0x01, 0x01}}, // Unnecessary leading zero
+			{8, {0x30, 0x06, 0x02, 0x01, 0x81, 0x02, 0x01, 0x01}}, // Negative
+			{8, {0x30, 0x06, 0x02, 0x00, 0x02, 0x02, 0x01, 0x01}}, // Empty integer
+			{8, {0x30, 0x08, 0x02, 0x01, 0x01, 0x02, 0x01, 0x01}}, // Wrong sequence length
+			{8, {0x31, 0x06, 0x02, 0x01, 0x01, 0x02, 0x01, 0x01}}, // Wrong tag
+			{9, {0x30, 0x07, 0x02, 0x01, 0x01, 0x02, 0x01, 0x01, 0x00}}, // Trailing data inside the sequence
+		};
+		uint8_t der[72];
+		uint32_t sig[16];
+		if (p256_signature_to_der(der, small[0], small[1]) != sizeof(small_der) || memcmp(der, small_der, sizeof(small_der)) != 0 ||
+		    !p256_signature_from_der(sig, sig + 8, small_der, sizeof(small_der)) || memcmp(sig, small, 64) != 0) {
+			return false;
+		}
+		for (int i = 0; i < COUNTOF(invalid_der); i++) {
+			if (p256_signature_from_der(sig, sig + 8, invalid_der[i].der, invalid_der[i].len)) {
+				return false;
+			}
+		}
+		// 33 byte integer without a leading zero
+		memcpy(der, (const uint8_t[]){0x30, 0x26, 0x02, 0x21}, 4);
+		memset(der + 4, 0x01, 33);
+		memcpy(der + 37, (const uint8_t[]){0x02, 0x01, 0x01}, 3);
+		if (p256_signature_from_der(sig, sig + 8, der, 40)) {
+			return false;
+		}
+	}
+#if include_p256_decode_point || include_p256_decompress_point
+	for (int i = 0; i < COUNTOF(keygen_tests_ok); i++) {
+		const struct KeygenTest* t = &keygen_tests_ok[i];
+		uint8_t spki[91];
+		uint32_t pub[16];
+		p256_public_key_to_spki(spki, t->pub, t->pub + 8);
+		if (!p256_public_key_from_spki(pub, pub + 8, spki, 91) || memcmp(pub, t->pub, 64) != 0) {
+			return false;
+		}
+		// Compressed point
+		spki[1] = 0x39;
+		spki[24] = 0x22;
+		p256_point_to_octet_string_compressed(spki + 26, t->pub, t->pub + 8);
+		if (!p256_public_key_from_spki(pub, pub + 8, spki, 59) || memcmp(pub, t->pub, 64) != 0) {
+			return false;
+		}
+		// Wrong curve OID and non-zero unused bits
+		spki[22] ^= 1;
+		if (p256_public_key_from_spki(pub, pub + 8, spki, 59)) {
+			return false;
+		}
+		spki[22] ^= 1;
+		spki[25] = 1;
+		if (p256_public_key_from_spki(pub, pub + 8, spki, 59)) {
+			return false;
+		}
+	}
+#endif
+#endif
+#if include_p256_resumable
+	{
+		struct P256Op op;
+		uint32_t budget = 1;
+		for (int i = 0; i < COUNTOF(verify_tests); i++) {
+			const struct VerifyTest* t = &verify_tests[i];
+			bool ok = p256_verify_start(&op, t->key, t->key + 8, t->msg, 32, t->sig, t->sig + 8);
+			while (!p256_op_step(&op, budget)) {
+				budget = budget % 7 + 1;
+			}
+			if ((p256_verify_finish(&op) && ok) != t->result) {
+				return false;
+			}
+		}
+		for (int i = 0; i < COUNTOF(ecdh_tests); i++) {
+			const struct EcdhTest* t = &ecdh_tests[i];
+			uint32_t x[8], y[8];
+			uint8_t shared[32];
+			bool ok = p256_octet_string_to_point(x, y, t->pub, t->publen) && p256_ecdh_start(&op, t->priv, x, y);
+			if (ok) {
+				while (!p256_op_step(&op, budget)) {
+					budget = budget % 7 + 1;
+				}
+				ok = p256_ecdh_finish(&op, shared) && memcmp(shared, t->shared, 32) == 0;
+			}
+			if (ok != t->valid) {
+				return false;
+			}
+		}
+		for (int i = 0; i < COUNTOF(keygen_tests_ok); i++) {
+			const struct KeygenTest* t = &keygen_tests_ok[i];
+			uint32_t pub[16];
+			if (!p256_keygen_start(&op, t->priv)) {
+				return false;
+			}
+			// The finish function runs the remaining steps
+			p256_op_step(&op, i % 40);
+			if (!p256_keygen_finish(&op, pub, pub + 8) || memcmp(pub, t->pub, 64) != 0) {
+				return false;
+			}
+		}
+		for (int i = 0; i < COUNTOF(keygen_tests_fail); i++) {
+			uint32_t x[8], y[8];
+			if (p256_keygen_start(&op, keygen_tests_fail[i]) || !p256_op_step(&op, 1) || p256_keygen_finish(&op, x, y)) {
+				return false;
+			}
+		}
+		// An operation can only be finished by the finish function that corresponds to the start function
+		if (!p256_keygen_start(&op, keygen_tests_ok[0].priv) || p256_verify_finish(&op)) {
+			return false;
+		}
+	}
+#endif
+#if defined(__linux__) && !p256_enable_stats
+	{
+		// All verify, sign, ECDH and keygen tests at once in a worker pool
+		static struct P256Job jobs[COUNTOF(verify_tests) + COUNTOF(valid_signs) + COUNTOF(ecdh_tests) + COUNTOF(keygen_tests_ok)];
+		static bool expected[COUNTOF(jobs)];
+		static uint32_t sigs[COUNTOF(valid_signs)][16], pubs[COUNTOF(keygen_tests_ok)][16], others[COUNTOF(ecdh_tests)][16];
+		static uint8_t shared[COUNTOF(ecdh_tests)][32];
+		struct P256WorkerPool pool;
+		uint32_t n = 0, num_ok = 0, expected_ok = 0;
+		for (int i = 0; i < COUNTOF(verify_tests); i++) {
+			const struct VerifyTest* t = &verify_tests[i];
+			jobs[n].type = P256_JOB_VERIFY;
+			jobs[n].args.verify.public_key_x = t->key;
+			jobs[n].args.verify.public_key_y = t->key + 8;
+			jobs[n].args.verify.hash = t->msg;
+			jobs[n].args.verify.hashlen_in_bytes = 32;
+			jobs[n].args.verify.r = t->sig;
+			jobs[n].args.verify.s = t->sig + 8;
+			expected[n++] = t->result;
+		}
+		for (int i = 0; i < COUNTOF(valid_signs); i++) {
+			const struct ValidSign* t = &valid_signs[i];
+			jobs[n].type = P256_JOB_SIGN;
+			jobs[n].args.sign.r = sigs[i];
+			jobs[n].args.sign.s = sigs[i] + 8;
+			jobs[n].args.sign.hash = t->z;
+			jobs[n].args.sign.hashlen_in_bytes = 32;
+			jobs[n].args.sign.private_key = t->priv;
+			jobs[n].args.sign.k = t->k;
+			expected[n++] = true;
+		}
+		for (int i = 0; i < COUNTOF(ecdh_tests); i++) {
+			const struct EcdhTest* t = &ecdh_tests[i];
+			if (!p256_octet_string_to_point(others[i], others[i] + 8, t->pub, t->publen)) {
+				continue;
+			}
+			jobs[n].type = P256_JOB_ECDH;
+			jobs[n].args.ecdh.shared_secret = shared[i];
+			jobs[n].args.ecdh.private_key = t->priv;
+			jobs[n].args.ecdh.others_public_key_x = others[i];
+			jobs[n].args.ecdh.others_public_key_y = others[i] + 8;
+			expected[n++] = t->valid;
+		}
+		for (int i = 0; i < COUNTOF(keygen_tests_ok); i++) {
+			jobs[n].type = P256_JOB_KEYGEN;
+			jobs[n].args.keygen.public_key_x = pubs[i];
+			jobs[n].args.keygen.public_key_y = pubs[i] + 8;
+			jobs[n].args.keygen.private_key = keygen_tests_ok[i].priv;
+			expected[n++] = true;
+		}
+		for (uint32_t i = 0; i < n; i++) {
+			jobs[i].callback = i % 2 == 0 ? worker_pool_test_callback : NULL;
+			jobs[i].user_data = &num_ok;
+			expected_ok += i % 2 == 0 && expected[i];
+		}
+		if (!p256_worker_pool_start(&pool, 3)) {
+			return false;
+		}
+		// Half of the jobs are waited for individually, the rest in p256_worker_pool_run
+		bool all_expected = true;
+		for (uint32_t i = n / 2; i < n; i++) {
+			all_expected &= expected[i];
+		}
+		p256_worker_pool_submit(&pool, jobs, n / 2);
+		bool ok = p256_worker_pool_run(&pool, jobs + n / 2, n - n / 2) == all_expected;
+		for (uint32_t i = 0; i < n; i++) {
+			ok &= (i < n / 2 ? p256_job_wait(&jobs[i]) : jobs[i].result) == expected[i] && p256_job_is_done(&jobs[i]);
+		}
+		p256_worker_pool_stop(&pool);
+		if (!ok || num_ok != expected_ok) {
+			return false;
+		}
+		for (int i = 0; i < COUNTOF(valid_signs); i++) {
+			if (memcmp(sigs[i], valid_signs[i].sig, 64) != 0) {
+				return false;
+			}
+		}
+		for (int i = 0; i < COUNTOF(ecdh_tests); i++) {
+			if (ecdh_tests[i].valid && memcmp(shared[i], ecdh_tests[i].shared, 32) != 0) {
+				return false;
+			}
+		}
+		for (int i = 0; i < COUNTOF(keygen_tests_ok); i++) {
+			if (memcmp(pubs[i], keygen_tests_ok[i].pub, 64) != 0) {
+				return false;
+			}
+		}
+	}
+#endif
 	return true;
 }
 `);